@@ -0,0 +1,861 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  End to end benchmark over the loopback (make bench). Starts both buddies along with stand-ins for what sits
+//  behind them, a RESTServer answering HTTP and an RDBMS answering TDS shaped requests, then drives them through
+//  the tunnel and reports requests a second, MB a second and the latency percentiles.
+//
+//  The load is open loop when given a rate: every request has its time set in advance and its latency is taken
+//  from then, not from when it actually went out, so a relay that falls behind shows it rather than hiding it
+//  (no coordinated omission). Without a rate each connection goes as fast as it's answered.
+//
+//  Every answer is checked against its request; a payload's bytes depend on where they sit and which request
+//  they're of, so frames of a stream taking another link and overtaking one another, or a stream getting
+//  another's, shows. Any request that broke or came back wrong, or a connect that failed, has it exit with 2
+//  (make check).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+#include <signal.h>
+#include <sys/wait.h>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+// the ports it takes on the loopback unless told otherwise
+#define BENCH_LOCAL_PORT    17777       // local-buddy; database clients connect here
+#define BENCH_REMOTE_PORT   18888       // remote-buddy; HTTP clients connect here
+#define BENCH_REST_PORT     19001       // the RESTServer stand-in
+#define BENCH_DB_PORT       19002       // and the RDBMS one
+
+#define BENCH_START_MS      5000        // how long the buddies get to come up
+#define BENCH_BACKLOG       128         // the least listen backlog the buddies get; more if there's more connections
+
+// TDS, as much of it as the stand-in needs
+#define TDS_HEADER          8           // type, status, length (big endian, header and all), spid, id, window
+#define TDS_PACKET          4096        // the longest a packet goes; messages longer span several
+#define TDS_SQL_BATCH       0x01        // a request
+#define TDS_REPLY           0x04        // and its answer
+#define TDS_EOM             0x01        // status: the last packet of the message
+
+// what the load is
+#define BENCH_REST          0           // HTTP requests through remote-buddy to the RESTServer
+#define BENCH_DB            1           // TDS requests through local-buddy to the RDBMS
+#define BENCH_MIX           2           // half of the connections each
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  What to run; off the command line
+ */
+typedef struct BENCH_OPTS_FMT
+{
+    int mode{BENCH_REST};           // BENCH_xxx
+    int connections{16};            // client connections, all at once
+    int payload{1024};              // bytes a request carries
+    int response{0};                // bytes an answer carries; 0 echoes the request
+    double rate{0};                 // requests a second over all connections; 0 as fast as they're answered
+    double seconds{10};             // how long it runs, warm up aside
+    double warmup{1};               // and how long it runs before anything counts
+    int reactor_threads{0};         // remote-buddy's (Reactor_Threads); 0 leaves its own default
+    int tunnel_links{0};            // and its links to local-buddy (Tunnel_Links)
+    std::string bin{"bin"};         // where the buddies are
+    std::string local_args;         // passed on to local-buddy as is
+    std::string remote_args;        // and to remote-buddy
+    u16 local_port{BENCH_LOCAL_PORT};
+    u16 remote_port{BENCH_REMOTE_PORT};
+    u16 rest_port{BENCH_REST_PORT};
+    u16 db_port{BENCH_DB_PORT};
+} BENCH_OPTS, *BENCH_OPTS_PTR;
+
+
+/**
+ * @brief
+ *  What a client connection got done; each has its own, they're added up at the end
+ */
+typedef struct BENCH_RESULT_FMT
+{
+    int mode;                       // BENCH_REST or BENCH_DB
+    u64 requests{0};                // answered in full, warm up aside
+    u64 refused{0};                 // connects that didn't go through (they're tried again)
+    u64 errors{0};                  // connections that broke along the way (they're made again)
+    u64 wrong{0};                   // answers that aren't what was asked for
+    u64 bytes{0};                   // payload both ways, requests and answers
+    std::vector<u64> vlatency;      // nano-seconds, one for every request answered
+} BENCH_RESULT, *BENCH_RESULT_PTR;
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static BENCH_OPTS opts;
+static u64 start_ns;                // when the load started; warm up and all
+static u64 measure_ns;              // when what's answered starts to count
+static u64 end_ns;                  // and when it stops
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Usage();
+bool Parse_Args(int argc, char **argv);
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Monotonic time in nano-seconds
+ */
+static u64 Now_Ns()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ns
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sleeps till a point in time (Now_Ns) if it's yet to come
+ */
+static void Sleep_Until(const u64 ns)
+{
+    u64 now = Now_Ns();
+    if (ns > now)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns - now));
+} // end Sleep_Until
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fills in a request's payload; its bytes tell where they sit (they go round every 251, which no frame's length
+ *  is a multiple of) and which request they're of (it's stamped up front and shifts the rest)
+ *
+ * @param [payload] the payload; its length is left as it is
+ * @param [seq] which request it is, over all of the connection's
+ */
+static void Fill_Payload(std::string &payload, const u64 seq)
+{
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = (char)('a' + (i % 251 + seq) % 26);
+
+    char stamp[24];
+    int n = snprintf(stamp, sizeof(stamp), "%" PRIu64 ":", seq);
+    payload.replace(0, std::min((size_t)n, payload.size()), stamp, std::min((size_t)n, payload.size()));
+} // end Fill_Payload
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes all of a buffer to a blocking socket
+ *
+ * @return bool
+ *  false if the connection broke
+ */
+static bool Send_All(const int fd, const char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        buf += n;
+        len -= n;
+    } // end while
+
+    return true;
+} // end Send_All
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads exactly len bytes off a blocking socket
+ *
+ * @return bool
+ *  false if the connection broke or closed first
+ */
+static bool Recv_All(const int fd, char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, buf, len, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        buf += n;
+        len -= n;
+    } // end while
+
+    return true;
+} // end Recv_All
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads an HTTP message off a socket, header and body (by its Content-Length); what comes past it stays in the
+ *  buffer for the next one
+ *
+ * @param [fd] the socket
+ * @param [buf] what's been read off it so far
+ * @param [head] out: the start line and the headers
+ * @param [body] out: the body
+ *
+ * @return bool
+ *  false if the connection broke or closed first
+ */
+static bool Recv_Http(const int fd, std::string &buf, std::string &head, std::string &body)
+{
+    char chunk[65536];
+    size_t end;
+    while ( (end = buf.find("\r\n\r\n")) == std::string::npos)
+    {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            return false;
+
+        buf.append(chunk, n);
+    } // end while
+
+    head = buf.substr(0, end);
+    size_t len{0};
+    for (size_t at = 0; (at = head.find("\r\n", at)) != std::string::npos; )
+    {
+        at += 2;
+        if (!strncasecmp(head.c_str() + at, "Content-Length:", 15))
+            len = strtoul(head.c_str() + at + 15, nullptr, 10);
+    } // end for
+
+    while (buf.size() < end + 4 + len)
+    {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            return false;
+
+        buf.append(chunk, n);
+    } // end while
+
+    body = buf.substr(end + 4, len);
+    buf.erase(0, end + 4 + len);
+    return true;
+} // end Recv_Http
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sends a TDS message; split into packets of no more than TDS_PACKET, the last marked TDS_EOM
+ *
+ * @param [fd] the socket
+ * @param [type] TDS_SQL_BATCH or TDS_REPLY
+ * @param [payload] what it carries
+ * @param [len] how much
+ *
+ * @return bool
+ *  false if the connection broke
+ */
+static bool Send_Tds(const int fd, const u8 type, const char *payload, size_t len)
+{
+    char packet[TDS_PACKET];
+    u8 id{1};
+    do {
+        size_t n = std::min(len, (size_t)TDS_PACKET - TDS_HEADER);
+        packet[0] = type;
+        packet[1] = n == len ? TDS_EOM : 0;
+        packet[2] = (char)((n + TDS_HEADER) >> 8);
+        packet[3] = (char)(n + TDS_HEADER);
+        packet[4] = packet[5] = 0;
+        packet[6] = id++;
+        packet[7] = 0;
+        memcpy(packet + TDS_HEADER, payload, n);
+        if (!Send_All(fd, packet, n + TDS_HEADER))
+            return false;
+
+        payload += n;
+        len -= n;
+    } while (len > 0);
+
+    return true;
+} // end Send_Tds
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads a TDS message; packets till the one marked TDS_EOM
+ *
+ * @param [fd] the socket
+ * @param [payload] out: what it carried, all packets together
+ *
+ * @return bool
+ *  false if the connection broke or what came isn't TDS
+ */
+static bool Recv_Tds(const int fd, std::string &payload)
+{
+    u8 header[TDS_HEADER];
+    char packet[TDS_PACKET];
+    payload.clear();
+    do {
+        if (!Recv_All(fd, (char *)header, TDS_HEADER))
+            return false;
+
+        size_t len = ((size_t)header[2] << 8) | header[3];
+        if (len < TDS_HEADER || len > TDS_PACKET || !Recv_All(fd, packet, len - TDS_HEADER))
+            return false;
+
+        payload.append(packet, len - TDS_HEADER);
+    } while (!(header[1] & TDS_EOM));
+
+    return true;
+} // end Recv_Tds
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The RESTServer stand-in; a thread a connection answering its requests one after the other, with the body of
+ *  the request or with opts.response bytes
+ */
+static void Rest_Server(const int fd)
+{
+    std::string buf, head, body, reply;
+    while (Recv_Http(fd, buf, head, body))
+    {
+        if (opts.response > 0)
+            body.assign(opts.response, 'x');
+
+        reply = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        if (!Send_All(fd, reply.data(), reply.size()))
+            break;
+    } // end while
+
+    close(fd);
+} // end Rest_Server
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The RDBMS stand-in; answers each TDS request with a reply carrying its payload back or opts.response bytes
+ */
+static void Db_Server(const int fd)
+{
+    std::string payload;
+    while (Recv_Tds(fd, payload))
+    {
+        if (opts.response > 0)
+            payload.assign(opts.response, 'x');
+
+        if (!Send_Tds(fd, TDS_REPLY, payload.data(), payload.size()))
+            break;
+    } // end while
+
+    close(fd);
+} // end Db_Server
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Listens on a loopback port and hands every connection to a thread of its own running the stand-in
+ *
+ * @param [port] the port
+ * @param [fn] the stand-in
+ *
+ * @return bool
+ *  false if the port couldn't be had
+ */
+static bool Serve(const u16 port, void (*fn)(const int))
+{
+    int lfd = socket(AF_INET, SOCK_STREAM, 0), on{1};
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(lfd, 1024) < 0)
+    {
+        fprintf(stderr, "port %d: %s\n", port, strerror(errno));
+        close(lfd);
+        return false;
+    } // end if no port
+
+    std::thread([lfd, fn]() {
+        while (true)
+        {
+            int fd = accept(lfd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+
+            int on{1};
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            std::thread(fn, fd).detach();
+        } // end while
+    }).detach();
+
+    return true;
+} // end Serve
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Connects to a loopback port
+ *
+ * @return int
+ *  the socket or -1
+ */
+static int Connect_To(const u16 port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0), on{1};
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    } // end if refused
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+} // end Connect_To
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts a buddy; its output goes nowhere
+ *
+ * @param [args] its path first and then its arguments, space separated
+ *
+ * @return pid_t
+ *  the process or -1
+ */
+static pid_t Spawn(const std::string &args)
+{
+    std::vector<std::string> vargs;
+    std::istringstream in(args);
+    for (std::string arg; in >> arg; )
+        vargs.push_back(arg);
+
+    pid_t pid = fork();
+    if (pid != 0)
+    {
+        if (pid < 0)
+            perror("fork()");
+        return pid;
+    } // end if parent
+
+    std::vector<char *> argv;
+    for (auto &arg : vargs)
+        argv.push_back((char *)arg.c_str());
+    argv.push_back(nullptr);
+
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    dup2(null, STDERR_FILENO);
+    execv(argv[0], argv.data());
+    _exit(127);
+} // end Spawn
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits for a port to take connections
+ *
+ * @param [port] the port
+ * @param [ms] for how long at most
+ *
+ * @return bool
+ *  false if it never did
+ */
+static bool Wait_Port(const u16 port, const int ms)
+{
+    for (int waited = 0; waited < ms; waited += 20)
+    {
+        int fd = Connect_To(port);
+        if (fd >= 0)
+        {
+            close(fd);
+            return true;
+        } // end if up
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    } // end for
+
+    return false;
+} // end Wait_Port
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A client connection; requests one after the other, each at its set time when there's a rate, till the run
+ *  is over. A connection that breaks is counted and made again.
+ *
+ * @param [index] which one; staggers its schedule against the others
+ * @param [pr] what it got done
+ */
+static void Client(const int index, BENCH_RESULT_PTR pr)
+{
+    const u16 port = pr->mode == BENCH_REST ? opts.remote_port : opts.local_port;
+    const u64 interval = opts.rate > 0 ? (u64)(1e9 * opts.connections / opts.rate) : 0;
+    const std::string expect(opts.response, 'x');
+    std::string payload(opts.payload, 'p'), request, buf, head, body;
+
+    u64 due = start_ns + (interval * index) / opts.connections;
+    u64 seq = (u64)index << 32;
+    int fd{-1};
+    while (true)
+    {
+        if (interval)
+            Sleep_Until(due);
+
+        u64 sent = Now_Ns();
+        if (sent >= end_ns)
+            break;
+
+        if (fd < 0 && (fd = Connect_To(port)) < 0)
+        {
+            pr->refused++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        } // end if no connection
+
+        bool bok;
+        Fill_Payload(payload, seq++);
+        if (pr->mode == BENCH_REST)
+        {
+            request = "POST /echo HTTP/1.1\r\nHost: bench\r\nContent-Length: " + std::to_string(opts.payload) +
+                "\r\n\r\n" + payload;
+            bok = Send_All(fd, request.data(), request.size()) && Recv_Http(fd, buf, head, body);
+        } // end if HTTP
+        else
+            bok = Send_Tds(fd, TDS_SQL_BATCH, payload.data(), payload.size()) && Recv_Tds(fd, body);
+
+        if (bok && body != (opts.response > 0 ? expect : payload))
+        {
+            // the connection's no good after that; what's still to come of it is anyone's guess
+            close(fd);
+            fd = -1;
+            buf.clear();
+            pr->wrong++;
+            continue;
+        } // end if wrong
+
+        if (!bok)
+        {
+            close(fd);
+            fd = -1;
+            buf.clear();
+            pr->errors++;
+            continue;
+        } // end if broke
+
+        // open loop: the latency runs from when it was due, late as it may have gone out
+        u64 now = Now_Ns();
+        u64 from = interval ? due : sent;
+        if (from >= measure_ns && now <= end_ns)
+        {
+            pr->requests++;
+            pr->bytes += payload.size() + body.size();
+            pr->vlatency.push_back(now - from);
+        } // end if counts
+
+        due += interval;
+    } // end while
+
+    if (fd >= 0)
+        close(fd);
+} // end Client
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A latency as it's best read
+ */
+static std::string Latency(const u64 ns)
+{
+    char buf[32];
+    if (ns < 10000)
+        snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+    else if (ns < 10000000)
+        snprintf(buf, sizeof(buf), "%.0f us", ns / 1e3);
+    else
+        snprintf(buf, sizeof(buf), "%.1f ms", ns / 1e6);
+    return buf;
+} // end Latency
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds up and prints what the connections of a kind got done
+ *
+ * @param [mode] BENCH_REST or BENCH_DB
+ * @param [vresults] all connections
+ */
+static void Report(const int mode, std::vector<BENCH_RESULT> &vresults)
+{
+    u64 requests{0}, refused{0}, errors{0}, wrong{0}, bytes{0};
+    int connections{0};
+    std::vector<u64> vall;
+    for (auto &r : vresults)
+    {
+        if (r.mode != mode)
+            continue;
+
+        connections++;
+        requests += r.requests;
+        refused += r.refused;
+        errors += r.errors;
+        wrong += r.wrong;
+        bytes += r.bytes;
+        vall.insert(vall.end(), r.vlatency.begin(), r.vlatency.end());
+    } // end for
+
+    if (!connections)
+        return;
+
+    auto pct = [&vall](const double p) -> u64 {
+        return vall.empty() ? 0 : vall[std::min(vall.size() - 1, (size_t)(p * vall.size()))];
+    }; // end pct
+
+    std::sort(vall.begin(), vall.end());
+    printf("%s, %d connection(s)\n", mode == BENCH_REST ? "RESTServer (HTTP)" : "RDBMS (TDS)", connections);
+    printf("  requests   %" PRIu64 " (%" PRIu64 " error(s), %" PRIu64 " wrong)\n", requests, errors, wrong);
+    printf("  connects   %" PRIu64 " failed\n", refused);
+    printf("  rate       %.1f req/s, %.2f MB/s\n", requests / opts.seconds, bytes / opts.seconds / 1e6);
+    printf("  latency    p50 %s, p99 %s, p99.9 %s, max %s\n", Latency(pct(0.5)).c_str(),
+        Latency(pct(0.99)).c_str(), Latency(pct(0.999)).c_str(), Latency(vall.empty() ? 0 : vall.back()).c_str());
+} // end Report
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts the stand-ins and the buddies, runs the load and reports
+ *
+ * @return int
+ *  0 if all went well, 1 if the buddies didn't come up and 2 if a connect failed or a request broke or came
+ *  back wrong
+ */
+int main(int argc, char *argv[])
+{
+    if (!Parse_Args(argc, argv))
+    {
+        Usage();
+        return 1;
+    } // end if bad args
+
+    signal(SIGPIPE, SIG_IGN);
+    if (!Serve(opts.rest_port, Rest_Server) || !Serve(opts.db_port, Db_Server))
+        return 1;
+
+    // remote-buddy takes its settings off a config file
+    char config[64];
+    snprintf(config, sizeof(config), "/tmp/jw-bench-%d.dat", (int)getpid());
+    FILE *fp = fopen(config, "w");
+    if (!fp)
+    {
+        perror(config);
+        return 1;
+    } // end if no config
+
+    fprintf(fp, "\"Listen_Port\" \"%d\"\n", opts.remote_port);
+    fprintf(fp, "\"RESTServer_Address\" \"127.0.0.1:%d\"\n", opts.rest_port);
+    fprintf(fp, "\"Database_Address\" \"127.0.0.1:%d\"\n", opts.db_port);
+    fprintf(fp, "\"Local_Buddy\" \"127.0.0.1:%d\"\n", opts.local_port);
+    if (opts.reactor_threads > 0)
+        fprintf(fp, "\"Reactor_Threads\" \"%d\"\n", opts.reactor_threads);
+    if (opts.tunnel_links > 0)
+        fprintf(fp, "\"Tunnel_Links\" \"%d\"\n", opts.tunnel_links);
+    fclose(fp);
+
+    // all the connections come at once; a listen backlog short of them has connects wait out SYN retries, which
+    //  is nothing the relay did (-la/-ra come after, so they may still set their own)
+    std::string bl = " -bl " + std::to_string(std::max(opts.connections, BENCH_BACKLOG)) + " ";
+
+    // local-buddy first; remote-buddy connects to it as it comes up
+    pid_t local = Spawn(opts.bin + "/local-buddy -p " + std::to_string(opts.local_port) + bl + opts.local_args);
+    bool bup = local > 0 && Wait_Port(opts.local_port, BENCH_START_MS);
+    pid_t remote = bup ? Spawn(opts.bin + "/remote-buddy -fn " + config + bl + opts.remote_args) : -1;
+    bup = remote > 0 && Wait_Port(opts.remote_port, BENCH_START_MS);
+    bool bclean{true};
+    if (!bup)
+        fprintf(stderr, "the buddies didn't come up; are they built (%s)?\n", opts.bin.c_str());
+    else
+    {
+        printf("loopback-bench: %d byte request(s), %s answer(s), %.0f s after %.0f s warm up, %s\n",
+            opts.payload, opts.response > 0 ? (std::to_string(opts.response) + " byte").c_str() : "echoed",
+            opts.seconds, opts.warmup, opts.rate > 0 ?
+                ("open loop at " + std::to_string((long)opts.rate) + " req/s").c_str() : "closed loop");
+
+        std::vector<BENCH_RESULT> vresults(opts.connections);
+        std::vector<std::thread> vthreads;
+        start_ns = Now_Ns() + 100000000;        // a moment for all of them to be ready
+        measure_ns = start_ns + (u64)(opts.warmup * 1e9);
+        end_ns = measure_ns + (u64)(opts.seconds * 1e9);
+        for (int i = 0; i < opts.connections; i++)
+        {
+            vresults[i].mode = opts.mode == BENCH_MIX ? i % 2 : opts.mode;
+            vthreads.emplace_back(Client, i, &vresults[i]);
+        } // end for
+
+        for (auto &t : vthreads)
+            t.join();
+
+        Report(BENCH_REST, vresults);
+        Report(BENCH_DB, vresults);
+        for (auto &r : vresults)
+            bclean = bclean && !r.refused && !r.errors && !r.wrong;
+    } // end else
+
+    if (remote > 0)
+        kill(remote, SIGTERM);
+    if (local > 0)
+        kill(local, SIGTERM);
+    while (wait(nullptr) > 0)
+        ;
+
+    unlink(config);
+    return !bup ? 1 : bclean ? 0 : 2;
+} // end main
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the command line into opts
+ *
+ * @return bool
+ *  false if something on it makes no sense
+ */
+bool Parse_Args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg{argv[i]};
+        if (arg == "-h" || i + 1 >= argc)
+            return false;
+
+        std::string val{argv[++i]};
+        if (arg == "-m")
+        {
+            if (val == "rest")
+                opts.mode = BENCH_REST;
+            else if (val == "db")
+                opts.mode = BENCH_DB;
+            else if (val == "mix")
+                opts.mode = BENCH_MIX;
+            else
+                return false;
+        } // end if mode
+        else if (arg == "-c")
+            opts.connections = std::max(atoi(val.c_str()), 1);
+        else if (arg == "-s")
+            opts.payload = std::max(atoi(val.c_str()), 1);
+        else if (arg == "-rs")
+            opts.response = std::max(atoi(val.c_str()), 0);
+        else if (arg == "-r")
+            opts.rate = std::max(atof(val.c_str()), 0.0);
+        else if (arg == "-t")
+            opts.seconds = std::max(atof(val.c_str()), 0.1);
+        else if (arg == "-w")
+            opts.warmup = std::max(atof(val.c_str()), 0.0);
+        else if (arg == "-rt")
+            opts.reactor_threads = atoi(val.c_str());
+        else if (arg == "-tl")
+            opts.tunnel_links = atoi(val.c_str());
+        else if (arg == "-bin")
+            opts.bin = val;
+        else if (arg == "-la")
+            opts.local_args = val;
+        else if (arg == "-ra")
+            opts.remote_args = val;
+        else if (arg == "-port")
+        {
+            u16 base = (u16)atoi(val.c_str());
+            opts.local_port = base;
+            opts.remote_port = base + 1;
+            opts.rest_port = base + 2;
+            opts.db_port = base + 3;
+        } // end if ports
+        else
+            return false;
+    } // end for
+
+    return true;
+} // end Parse_Args
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  How it's run
+ */
+void Usage()
+{
+    printf("usage: loopback-bench [options]\n"
+        "  -m rest|db|mix   what to drive; HTTP through remote-buddy, TDS through local-buddy or both (rest)\n"
+        "  -c n             client connections (16)\n"
+        "  -s bytes         request payload (1024)\n"
+        "  -rs bytes        answer payload; 0 echoes the request (0)\n"
+        "  -r req/s         open loop at this rate over all connections; 0 closed loop (0)\n"
+        "  -t s             how long it runs (10)\n"
+        "  -w s             warm up before it counts (1)\n"
+        "  -rt n            remote-buddy reactor threads\n"
+        "  -tl n            remote-buddy tunnel links\n"
+        "  -bin dir         where the buddies are (bin)\n"
+        "  -la \"args\"       more arguments for local-buddy, e.g. \"-io uring\"\n"
+        "  -ra \"args\"       and for remote-buddy\n"
+        "  -port base       local-buddy, remote-buddy, RESTServer and RDBMS on base to base+3 (%d, %d, %d, %d)\n",
+        BENCH_LOCAL_PORT, BENCH_REMOTE_PORT, BENCH_REST_PORT, BENCH_DB_PORT);
+} // end Usage
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
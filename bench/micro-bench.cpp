@@ -0,0 +1,401 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Micro-benchmarks of the hot paths, each on its own (make micro-bench); INTAP headers going out and coming in,
+//  the stream table as the buddies look it up, picking the remote-buddy for a new database connection and what
+//  Dump and Dump_Hex cost with logging off (and on). Every one reports nano-seconds and heap allocations an
+//  operation, so a regression shows up here before it's lost in the end to end numbers (see loopback-bench).
+//
+//  The code timed is the buddies' own (Dump, Stream_Echo, Stream_Next, ...); only New_Db's bookkeeping around
+//  Route_Find is private to local-buddy and mirrored here as it is there; keep the two in step.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "utils.h"
+#include "stream-table.h"
+#include "route-index.h"
+#include <new>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define MICRO_TARGET_MS     200         // how long each one runs for, about
+#define MICRO_FRAMES        64          // frames fed to a receive buffer at once
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static std::atomic<u64> nallocs{0};     // heap allocations through operator new, all threads
+static const char *pfilter{nullptr};    // runs only those whose name has this in it
+static u64 target_ns{(u64)MICRO_TARGET_MS * 1000000};
+
+u16 listen_port{0};                     // utils.cpp wants one; it's the buddies' own
+
+// local-buddy's routing state, as New_Db sees it
+static std::unordered_map<int, CONNECTION_INFO> remote_fd;
+static std::vector<u32> fdip;
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+void *operator new(size_t size)
+{
+    nallocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+} // end new
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+} // end delete
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+} // end delete
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Keeps the compiler from optimizing a value away
+ */
+template <typename T>
+static inline void Keep(const T &val)
+{
+    asm volatile("" : : "g"(&val) : "memory");
+} // end Keep
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Monotonic time in nano-seconds
+ */
+static u64 Now_Ns()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ns
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs a benchmark for more and more operations till it takes about target_ns, then prints what an operation
+ *  took
+ *
+ * @param [name] what it's called
+ * @param [fn] does n operations
+ */
+template <typename F>
+static void Run(const char *name, F fn)
+{
+    if (pfilter && !strstr(name, pfilter))
+        return;
+
+    fn(1);      // warm up; the first time round may allocate what's kept after
+    for (u64 n = 1; ; )
+    {
+        u64 allocs = nallocs.load(std::memory_order_relaxed);
+        u64 start = Now_Ns();
+        fn(n);
+        u64 ns = Now_Ns() - start;
+        allocs = nallocs.load(std::memory_order_relaxed) - allocs;
+
+        if (ns >= target_ns || n >= ((u64)1 << 34))
+        {
+            printf("%-44s %12.2f ns/op %10.2f allocs/op %14" PRIu64 " ops\n", name, (double)ns / n,
+                (double)allocs / n, n);
+            return;
+        } // end if long enough
+
+        u64 next = ns > 0 ? (u64)(n * 1.2 * target_ns / ns) : n * 100;
+        n = std::min(n * 100, std::max(n * 2, next));
+    } // end for
+} // end Run
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fills a header the way the buddies do ahead of CPY_SND_BUFFER (see Stream_Echo); a frame of a stream the
+ *  other side is yet to hear of, so it carries both descriptors in either version
+ */
+static inline void Fill_Header(INTAP_FMT &intap, const int fd, const int rfd, const u32 bytes)
+{
+    STREAM stream{nullptr, rfd, STREAM_OPEN, 0, SF_UNNAMED, 0, 0};
+    Stream_Echo(intap, &stream, fd, (int)bytes, INTAP_V1);
+} // end Fill_Header
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The INTAP header; filled and encoded the way CPY_SND_BUFFER has it go out (Intap_Send and Intap_Out, short
+ *  of the send itself), decoded the way it comes in and taken off a receive buffer frame by frame
+ */
+static void Bench_Intap()
+{
+    char dst[INTAP_MAX_HDR];
+    INTAP_FMT intap{};
+
+    for (int version : {INTAP_V1, INTAP_V2})
+    {
+        std::string name = "intap encode, v" + std::to_string(version);
+        Run(name.c_str(), [&](u64 n) {
+            for (u64 i = 0; i < n; i++)
+            {
+                Fill_Header(intap, 100 + (i & 1023), 2000 + (i & 511), 1024 + (i & 4095));
+                size_t len = Intap_Encode(dst, intap, version);
+                Keep(len);
+            } // end for
+        });
+
+        Fill_Header(intap, 1234, 567, 16384);
+        size_t hlen = Intap_Encode(dst, intap, version);
+        name = "intap decode, v" + std::to_string(version);
+        Run(name.c_str(), [&](u64 n) {
+            INTAP_FMT in;
+            for (u64 i = 0; i < n; i++)
+            {
+                int len = Intap_Decode(dst, hlen, in);
+                u32 bytes = NTOHL(in.buf_len);
+                s16 dest = (s16)NTOHS(in.dest_fd);
+                Keep(len);
+                Keep(bytes);
+                Keep(dest);
+            } // end for
+        });
+
+        // frames as they sit in a link's receive buffer, MICRO_FRAMES of them read at once
+        std::string frames;
+        char payload[256]{};
+        for (int i = 0; i < MICRO_FRAMES; i++)
+        {
+            Fill_Header(intap, 100 + i, 2000 + i, sizeof(payload));
+            frames.append(dst, Intap_Encode(dst, intap, version));
+            frames.append(payload, sizeof(payload));
+        } // end for
+
+        INTAP_RX rx;
+        name = "intap rx, v" + std::to_string(version) + " (256 byte frames)";
+        Run(name.c_str(), [&](u64 n) {
+            INTAP_FMT in;
+            const char *p;
+            for (u64 i = 0; i < n; i += MICRO_FRAMES)
+            {
+                Intap_Feed(rx, frames.data(), frames.size());
+                while (Intap_Next(rx, in, p) == INTAP_RX_FRAME)
+                    Keep(p);
+            } // end for
+        });
+    } // end for
+} // end Bench_Intap
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The stream table; looked up for every read off a stream the way local-buddy's event loop does before it
+ *  echoes it down the tunnel, and swept whole for a remote-buddy's streams the way Kill_Sock does when one goes
+ */
+static void Bench_Streams()
+{
+    const int peers = 16;
+    std::vector<CONNECTION_INFO> vpeers(peers);
+    for (int i = 0; i < peers; i++)
+    {
+        vpeers[i].fd = 10 + i;
+        for (int j = 0; j < 4; j++)
+            vpeers[i].vlinks.push_back(10 + i + 100 * j);
+    } // end for
+
+    for (int streams : {1024, 16384})
+    {
+        const int first = 256;
+        for (int fd = first; fd < first + streams; fd++)
+            Stream_Open(fd, &vpeers[fd % peers], fd + 1, STREAM_OPEN);
+
+        std::string name = "stream lookup, echo (" + std::to_string(streams) + " streams)";
+        Run(name.c_str(), [&](u64 n) {
+            INTAP_FMT intap;
+            for (u64 i = 0; i < n; i++)
+            {
+                int fd = first + (int)((i * 7919) % streams);
+                STREAM_PTR ps = Stream_Get(fd);
+                CONNECTION_INFO_PTR pci = (CONNECTION_INFO_PTR)ps->ppeer;
+                int link = Stream_Link(pci, fd);
+                Stream_Echo(intap, ps, fd, 1024, pci->version);
+                Keep(link);
+                Keep(intap);
+            } // end for
+        });
+
+        name = "stream sweep, Kill_Sock (" + std::to_string(streams) + " streams)";
+        Run(name.c_str(), [&](u64 n) {
+            for (u64 i = 0; i < n; i++)
+            {
+                CONNECTION_INFO_PTR pci = &vpeers[i % peers];
+                int found{0};
+                for (int sfd = Stream_Next(pci, 0); sfd >= 0; sfd = Stream_Next(pci, sfd + 1))
+                    found++;
+                Keep(found);
+            } // end for
+        });
+
+        for (int fd = first; fd < first + streams; fd++)
+            Stream_Close(fd);
+    } // end for
+} // end Bench_Streams
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Routing a database session the way local-buddy does; its address kept as it's accepted, the remote-buddy
+ *  picked as its first bytes come in (New_Db) and the address let go once it's done (Kill_Sock). Every
+ *  remote-buddy has a client host bound to it already.
+ */
+static void Bench_Routing()
+{
+    for (int remotes : {1, 16, 256, 4096})
+    {
+        std::vector<u32> vaddrs;
+        for (int i = 0; i < remotes; i++)
+        {
+            char ip[INET_ADDRSTRLEN];
+            snprintf(ip, sizeof(ip), "10.%d.%d.%d", (i >> 16) & 255, (i >> 8) & 255, (i & 255) + 1);
+            CONNECTION_INFO ci;
+            ci.fd = 1000 + i;
+            ci.ip = "0.0.0.0";
+            Route_Add(&remote_fd.emplace(ci.fd, ci).first->second);
+
+            u32 addr;
+            inet_pton(AF_INET, ip, &addr);
+            Route_Find(addr);
+            vaddrs.push_back(addr);
+        } // end for
+
+        fdip.resize(1024);
+        std::string name = "route new db session (" + std::to_string(remotes) + " remotes)";
+        Run(name.c_str(), [&](u64 n) {
+            for (u64 i = 0; i < n; i++)
+            {
+                const int fd = 500 + (int)(i & 63);
+                fdip[fd] = vaddrs[(i * 7919) % remotes];
+                CONNECTION_INFO_PTR pci = Route_Find(fdip[fd]);
+                Keep(pci);
+                fdip[fd] = 0;
+            } // end for
+        });
+
+        for (auto &x : remote_fd)
+            Route_Remove(&x.second);
+        remote_fd.clear();
+    } // end for
+} // end Bench_Routing
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  What Dump and Dump_Hex cost the event loop; with logging off, as the buddies run most of the time, and on
+ *  (into the log ring; the drainer writes to /dev/null meanwhile)
+ */
+static void Bench_Logging()
+{
+    char buf[1024];
+    memset(buf, 'b', sizeof(buf));
+
+    for (int mode : {0, DEBUG_L1 | DEBUG_L2 | DEBUG_L3})
+    {
+        debug_mode = mode;
+        const char *state = mode ? "on" : "off";
+        u64 dropped = Log_Dropped();
+
+        std::string name = std::string("dump, logging ") + state;
+        Run(name.c_str(), [&](u64 n) {
+            for (u64 i = 0; i < n; i++)
+                Dump("got %d bytes from \033[32mremote-buddy\033[37m on socket %d", (int)(i & 4095), 7);
+        });
+
+        name = std::string("dump_hex 1 KB, logging ") + state;
+        Run(name.c_str(), [&](u64 n) {
+            for (u64 i = 0; i < n; i++)
+            {
+                if (debug_mode & DEBUG_L3)
+                    Dump_Hex(buf, sizeof(buf));
+                Keep(buf);
+            } // end for
+        });
+
+        if (Log_Dropped() > dropped)
+            printf("%-44s %12" PRIu64 " records dropped; the drainer fell behind\n", "", Log_Dropped() - dropped);
+    } // end for
+
+    debug_mode = 0;
+} // end Bench_Logging
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs them all, or those named like the first argument; -t sets how long each runs (ms)
+ */
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            target_ns = (u64)std::max(atoi(argv[++i]), 1) * 1000000;
+        else if (argv[i][0] != '-')
+            pfilter = argv[i];
+        else
+        {
+            printf("usage: micro-bench [-t ms] [name]\n");
+            return 1;
+        } // end else
+    } // end for
+
+    Metrics_Thread();
+    Log_Init("micro-bench:", "/dev/null");
+
+    Bench_Intap();
+    Bench_Streams();
+    Bench_Routing();
+    Bench_Logging();
+
+    Log_Close();
+    return 0;
+} // end main
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
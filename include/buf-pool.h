@@ -0,0 +1,61 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  A size-class pool of relay buffers; what a descriptor's send queue is kept in while it has anything queued.
+//  Each reactor thread carves its buffers out of slabs of its own (huge pages if asked for) and keeps those
+//  handed back on a free list per class, so taking one as data comes in and handing it back the moment the
+//  queue drains costs next to nothing; an idle connection holds no buffer at all.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef BUF_POOL_H
+#define BUF_POOL_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define BUF_MIN_SHIFT       12              // the smallest class; 4 KiB
+#define BUF_CLASSES         9               // 4 KiB, 8 KiB ... 1 MiB; anything bigger comes straight off the heap
+#define BUF_SLAB_SIZE       (2 << 20)       // the classes are carved out of slabs this big; a huge page each
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+extern bool buf_huge;                       // back the slabs with huge pages (-huge)
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+char *Buf_Get(size_t &size);
+void Buf_Put(char *p, const size_t size);
+void Buf_Grow(char *&p, size_t &size, const size_t used, const size_t need);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,91 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Deficit round-robin over the frames waiting to go down a tunnel link. Every stream gets a queue of its own
+//  and a turn each round worth a quantum weighted by its traffic class (EGRESS_xxx), so that a short database
+//  round-trip isn't stuck behind a bulk download that got there first; control frames go ahead of them all.
+//  The reactor keeps one for each link it's asked to (see Intap_Schedule) and lets frames out of it only as
+//  the link's queue runs low.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef EGRESS_SCHED_H
+#define EGRESS_SCHED_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+#include <deque>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define EGRESS_QUANTUM      (16 * 1024)     // what a stream of weight 1 may send a round
+#define EGRESS_BACKLOG      (64 * 1024)     // frames are let onto the link's own queue till it holds this much
+#define EGRESS_WEIGHT_DB    4               // the default weights (-wdb and -wrest)
+#define EGRESS_WEIGHT_REST  1
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  The frames of a stream waiting their turn
+ */
+typedef struct EGRESS_FLOW_FMT
+{
+    std::deque<std::string> qframes;    // INTAP header followed by the payload, in the order they came
+    size_t deficit{0};                  // bytes it may still send this round
+    int cls{EGRESS_REST};               // its traffic class
+    bool bturn{false};                  // got its quantum for the round already
+} EGRESS_FLOW, *EGRESS_FLOW_PTR;
+
+
+/**
+ * @brief
+ *  A link's scheduler
+ */
+typedef struct EGRESS_SCHED_FMT
+{
+    size_t quantum[EGRESS_CLASSES]{0, EGRESS_QUANTUM * EGRESS_WEIGHT_DB, EGRESS_QUANTUM * EGRESS_WEIGHT_REST};
+    int version{INTAP_V1};                      // INTAP version of the link
+    std::deque<std::string> qcontrol;           // EGRESS_CONTROL frames; first come first go
+    std::unordered_map<int, EGRESS_FLOW> mflows;    // the streams with frames waiting
+    std::deque<int> qround;                     // and their place in the round
+    size_t bytes{0};                            // all that's waiting
+} EGRESS_SCHED, *EGRESS_SCHED_PTR;
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Egress_Weights(EGRESS_SCHED &sched, const int weight_db, const int weight_rest);
+void Egress_Push(EGRESS_SCHED &sched, const int stream, const int cls, const INTAP_FMT &intap, const char *buf,
+    const size_t len);
+bool Egress_Pop(EGRESS_SCHED &sched, std::string &frame);
+void Egress_Clear(EGRESS_SCHED &sched);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,94 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Just enough of HTTP/1.1 to tell where the messages on a stream begin and end (Content-Length and chunked
+//  bodies); local-buddy follows the requests and responses on its RESTServer streams with it so that one left
+//  with nothing in flight can be kept alive for the next client instead of being closed.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef HTTP_FRAMER_H
+#define HTTP_FRAMER_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+#include <deque>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define HTTP_HEAD_MAX       (64 * 1024)     // a head (or chunk line) longer than this isn't followed any further
+
+
+// where a framer is at in its message
+#define HTTP_ST_HEAD        0           // the start line and headers; a message is whole when it's here
+#define HTTP_ST_BODY        1           // a body of known length
+#define HTTP_ST_CHUNK_SIZE  2           // the size line of a chunk
+#define HTTP_ST_CHUNK_DATA  3           // the chunk itself
+#define HTTP_ST_CHUNK_END   4           // the CRLF closing a chunk
+#define HTTP_ST_TRAILER     5           // trailers after the last chunk
+#define HTTP_ST_LOST        6           // can't tell anymore (a body that runs till close or garbage)
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  One direction of an HTTP stream
+ */
+typedef struct HTTP_FRAMER_FMT
+{
+    int state{HTTP_ST_HEAD};    // one of HTTP_ST_xxx
+    u64 left{0};                // bytes of the body (or chunk) still to come
+    std::string line;           // the head (or chunk line) so far
+    u32 messages{0};            // whole messages seen
+} HTTP_FRAMER, *HTTP_FRAMER_PTR;
+
+
+
+/**
+ * @brief
+ *  Both directions of an HTTP stream; the requests going to the server and its responses
+ */
+typedef struct HTTP_STREAM_FMT
+{
+    HTTP_FRAMER req;            // the requests
+    HTTP_FRAMER rsp;            // and the responses
+    std::deque<bool> qnobody;   // one for each request yet to be answered; is its response bodyless (HEAD)?
+    bool bclose{false};         // either side wants the connection gone once done (or it changes protocol)
+} HTTP_STREAM, *HTTP_STREAM_PTR;
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Http_Request(HTTP_STREAM &hs, const char *buf, const size_t len);
+void Http_Response(HTTP_STREAM &hs, const char *buf, const size_t len);
+void Http_Request_Skip(HTTP_STREAM &hs, const size_t len);
+bool Http_Idle(const HTTP_STREAM &hs);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,74 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  An io_uring backend for the reactor; descriptors get their data delivered by multishot recv into a ring of
+//  registered (provided) buffers and all the sends of an event loop iteration go down in a single system
+//  call.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  16th of October 2026, Friday
+//
+// Last Updated:
+//  16th of October 2026, Friday
+//==============================================================================================================|
+#ifndef IO_URING_H
+#define IO_URING_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define URING_ENTRIES       1024        // submission queue depth (completion queue gets twice as much)
+#define URING_BUFFERS       256         // number of provided buffers for multishot recv (power of 2)
+#define URING_PARK_MAX      (256 * 1024)    // stop receiving on a descriptor once this much waits on the caller
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  One send of a batch (see Uring_Send_Batch)
+ */
+typedef struct URING_SEND_FMT
+{
+    int fd;                 // where to
+    const char *buf;        // the payload; must stay put till the batch is done
+    size_t len;             // length of payload
+    s32 res;                // bytes sent or a negated errno
+} URING_SEND, *URING_SEND_PTR;
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+bool Uring_Init(const size_t buf_size);
+bool Uring_Active();
+void Uring_Arm(const int fd, const u32 gen, const u32 events);
+void Uring_Disarm(const int fd);
+int Uring_Wait(REACTOR_EVENT_PTR pevents, const int max_events, const int timeout);
+int Uring_Recv(const REACTOR_EVENT &ev, char *buf, const size_t buf_len);
+void Uring_Send_Batch(URING_SEND_PTR psends, const size_t count);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,94 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Logging off the event loop. A thread logging gets a ring of its own the first time round and is the only one
+//  ever writing to it; a record goes in as is, the format (always a literal) by its address and the arguments
+//  in their binary form, and a background thread does the formatting and the writing as it drains the rings.
+//  A ring that's full drops what comes and counts it; the thread logging never waits on anything.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef LOGGER_H
+#define LOGGER_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define LOG_RING_SIZE       (1 << 20)   // bytes of records each thread may have waiting; a power of two
+#define LOG_STR_MAX         512         // the longest a %s argument is kept; the rest is cut
+#define LOG_HEX_MAX         65536       // the longest a hex dump goes (see Log_Hex)
+#define LOG_IDLE_MS         2           // how long the drainer sleeps once it finds the rings empty
+
+// what a record is
+#define LOG_TEXT            1           // a format and its arguments
+#define LOG_HEX             2           // bytes to dump in hex
+#define LOG_SKIP            3           // nothing; the rest of the ring up to its end is unused
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A record's header; what goes along with it follows, rounded up to 8 bytes
+ */
+typedef struct LOG_REC_FMT
+{
+    u32 size;               // the whole record, header and all
+    u32 kind;               // LOG_xxx
+    u64 us;                 // when it was logged (micro-seconds since the epoch)
+    const char *fmt;        // the format (LOG_TEXT); its arguments follow in 8 byte slots, %s as a length and
+                            //  the characters. LOG_HEX has the length and the bytes instead.
+} LOG_REC, *LOG_REC_PTR;
+
+
+/**
+ * @brief
+ *  The records of one thread on their way to the drainer; a single producer, single consumer ring
+ */
+typedef struct LOG_RING_FMT
+{
+    alignas(64) std::atomic<u64> tail{0};   // bytes written in all; the thread logging alone moves it
+    std::atomic<u64> dropped{0};            // records that didn't fit
+    alignas(64) std::atomic<u64> head{0};   // bytes drained in all; the drainer alone moves it
+    u64 reported{0};                        // dropped records it has told of so far
+    char vbuf[LOG_RING_SIZE];
+} LOG_RING, *LOG_RING_PTR;
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Log_Init(const char *prefix, const char *path);
+void Log_Print(const char *fmt, va_list args);
+void Log_Hex(const char *buf, const size_t len);
+u64 Log_Dropped();
+void Log_Close();
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,51 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  A small LZ77 block codec in the manner of LZ4; fast enough to run on every big frame going down the tunnel
+//  and plenty for the JSON and TDS result sets that make up most of them.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define LZ_MIN_MATCH        4           // shortest match worth a sequence
+#define LZ_MAX_OFFSET       65535       // how far back a match may be; offsets go in 2 bytes
+#define LZ_HASH_LOG         12          // 4K entries in the match finder's table
+#define LZ_BOUND(len)       ((len) + (len) / 255 + 16)      // the most a block of len bytes ever takes
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+size_t LZ_Compress(const char *src, const size_t len, char *dst, const size_t cap);
+int LZ_Decompress(const char *src, const size_t len, char *dst, const size_t cap);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
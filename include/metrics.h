@@ -0,0 +1,142 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Counters and histograms of what goes on in a buddy, served Prometheus style on an optional local port (-mp).
+//  Each reactor thread counts into its own METRICS and is the only one ever writing to it; the counters are
+//  atomics only so the scrape may read them from the thread serving it, and are bumped with plain relaxed
+//  loads and stores, never a locked instruction, so they're cheap enough to leave on for good.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef METRICS_H
+#define METRICS_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define METRICS_BUCKETS     24          // histogram buckets; each twice the one before, the last one +Inf
+
+// what the first bucket of a histogram goes up to; as a shift of 1
+#define METRICS_SHIFT_BYTES 6           // 64 bytes
+#define METRICS_SHIFT_US    4           // 16 micro-seconds
+#define METRICS_SHIFT_ONE   0           // 1 (counts)
+
+// directions over the tunnel
+#define METRICS_TX          0           // down it
+#define METRICS_RX          1           // off it
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A histogram; how many went into each bucket (not cumulative) and what they add up to
+ */
+typedef struct METRICS_HIST_FMT
+{
+    std::atomic<u64> vcount[METRICS_BUCKETS];
+    std::atomic<u64> sum;
+} METRICS_HIST, *METRICS_HIST_PTR;
+
+
+/**
+ * @brief
+ *  What a reactor thread counts; zeroed to start with
+ */
+typedef struct METRICS_FMT
+{
+    std::atomic<u64> frames[2];         // INTAP frames over the tunnel, METRICS_TX and METRICS_RX
+    std::atomic<u64> bytes[2];          // and the payload they carried (before any compression)
+    METRICS_HIST frame_bytes[2];        // the payload lengths
+    std::atomic<u64> connects_failed;   // upstream connects that didn't go through (see Connect_Async)
+    METRICS_HIST connect_us;            // and how long those that did took
+    std::atomic<u64> streams_opened;    // streams (see Stream_Open)
+    std::atomic<u64> streams_closed;
+    std::atomic<u64> wakeups;           // the reactor coming back from waiting (see Reactor_Wait)
+    METRICS_HIST events;                // and the events it came back with (when it came back with any)
+    METRICS_HIST loop_us;               // how long the loop took going through them till it waited again
+    std::atomic<u64> links_lost;        // tunnel links that lost their connection (see Intap_Park)
+    std::atomic<u64> links_resumed;     // and those taken up again over a new one (see Intap_Resume)
+} METRICS, *METRICS_PTR;
+
+
+// adds whatever the caller wants to the scrape; the buddy's own gauges
+typedef void (*METRICS_CB)(std::string &out);
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+extern thread_local METRICS_PTR pmetrics;   // the calling thread's; one that never called Metrics_Thread counts
+                                            //  into a sink no one reads
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Metrics_Thread();
+bool Metrics_Listen(const u16 port, METRICS_CB cb=nullptr);
+bool Metrics_Event(const REACTOR_EVENT &ev);
+void Metrics_Render(std::string &out);
+
+
+/**
+ * @brief
+ *  Adds to a counter of the calling thread; it's the only one writing to it
+ *
+ * @param [counter] the counter
+ * @param [n] how much
+ */
+inline void Metrics_Add(std::atomic<u64> &counter, const u64 n)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+} // end Metrics_Add
+
+
+/**
+ * @brief
+ *  Counts a value into a histogram of the calling thread; the first bucket goes up to 1 << shift and every one
+ *  after to twice the one before
+ *
+ * @param [hist] the histogram
+ * @param [value] the value
+ * @param [shift] METRICS_SHIFT_xxx
+ */
+inline void Metrics_Observe(METRICS_HIST &hist, const u64 value, const u8 shift)
+{
+    u64 units = value > 0 ? (value - 1) >> shift : 0;
+    int i = units ? 64 - __builtin_clzll(units) : 0;
+    Metrics_Add(hist.vcount[std::min(i, METRICS_BUCKETS - 1)], 1);
+    Metrics_Add(hist.sum, value);
+} // end Metrics_Observe
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,157 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  A lock-free multi-producer single-consumer queue used to hand work from one reactor thread over to another;
+//  any thread may push, only the owning thread pops. Each queue carries a wake-up descriptor the owner keeps
+//  in its reactor, so a push wakes the owner up out of its wait.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  16th of October 2026, Friday
+//
+// Last Updated:
+//  16th of October 2026, Friday
+//==============================================================================================================|
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Vyukov's node based queue; producers swap themselves in at the head with a single exchange and then link
+ *  the previous node to them, the consumer walks from the tail. The tail node is always a dummy whose value
+ *  has been taken already.
+ *
+ *  Wake-ups are coalesced: only the push that finds bsignaled clear touches the descriptor. The consumer clears
+ *  the flag before it drains (see Clear()), so a push is either seen by the drain or signals again.
+ */
+template <typename T>
+struct MPSC_QUEUE
+{
+    typedef struct NODE_FMT
+    {
+        std::atomic<NODE_FMT*> next{nullptr};
+        T val;
+    } NODE, *NODE_PTR;
+
+    std::atomic<NODE_PTR> head;             // where the producers push
+    NODE_PTR tail;                          // where the consumer pops; only ever touched by the owner
+    std::atomic<bool> bsignaled{false};     // has the owner been signaled since it last cleared?
+    int wake_fd[2]{-1, -1};                 // [0] goes into the owner's reactor; [1] is written to (same on linux)
+
+
+    MPSC_QUEUE()
+    {
+        head.store(tail = new NODE, std::memory_order_relaxed);
+
+#if defined (__linux__)
+        if ( (wake_fd[0] = wake_fd[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+#else
+        if (pipe(wake_fd) < 0)
+#endif
+        {
+            perror("MPSC_QUEUE wake-up");
+            exit(EXIT_FAILURE);
+        } // end if
+
+#if !defined (__linux__)
+        Set_Non_Blocking(wake_fd[0]);       // Clear() reads till it's dry
+#endif
+    } // end MPSC_QUEUE
+
+
+    ~MPSC_QUEUE()
+    {
+        while (tail)
+        {
+            NODE_PTR next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        } // end while
+
+        close(wake_fd[0]);
+        if (wake_fd[1] != wake_fd[0])
+            close(wake_fd[1]);
+    } // end ~MPSC_QUEUE
+
+
+    MPSC_QUEUE(const MPSC_QUEUE &) = delete;
+    MPSC_QUEUE &operator=(const MPSC_QUEUE &) = delete;
+
+
+    /**
+     * @brief
+     *  Pushes a value from any thread and wakes up the owner if need be
+     */
+    void Push(T &&val)
+    {
+        NODE_PTR pnode = new NODE;
+        pnode->val = std::move(val);
+
+        NODE_PTR prev = head.exchange(pnode, std::memory_order_acq_rel);
+        prev->next.store(pnode, std::memory_order_release);
+
+        if (!bsignaled.exchange(true, std::memory_order_seq_cst))
+        {
+            u64 one{1};
+            if (write(wake_fd[1], &one, sizeof(one)) < 0 && errno != EAGAIN)
+                perror("MPSC_QUEUE write()");
+        } // end if first since the last clear
+    } // end Push
+
+
+    /**
+     * @brief
+     *  Pops the oldest value; owner only
+     *
+     * @return true
+     *  if got one; false if empty (or a producer is half way through its push, which signals anyway)
+     */
+    bool Pop(T &val)
+    {
+        NODE_PTR next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        val = std::move(next->val);
+        delete tail;
+        tail = next;
+        return true;
+    } // end Pop
+
+
+    /**
+     * @brief
+     *  Acknowledges the wake-up; owner only and always before draining with Pop()
+     */
+    void Clear()
+    {
+        u64 count;
+        while (read(wake_fd[0], &count, sizeof(count)) > 0)
+            if (wake_fd[1] == wake_fd[0])
+                break;      // eventfd hands the whole count over in one read
+
+        bsignaled.store(false, std::memory_order_seq_cst);
+    } // end Clear
+}; // end MPSC_QUEUE
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
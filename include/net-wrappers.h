@@ -12,7 +12,7 @@
 //  13th of Feburary 2023, Monday
 //
 // Last Updated:
-//  13th of Feburary 2023, Monday
+//  17th of October 2026, Saturday
 //
 // NOTES:
 //  In linux using g++ (however choice C/C++ compiler is not imposed) compile as (in realse mode):
@@ -35,6 +35,7 @@
 #include <vector>               // take a wild guess
 #include <map>                  // C++ maps
 #include <unordered_map>        // C++ maps
+#include <unordered_set>        // C++ sets
 #include <algorithm>            // many important iterator and algorithims
 #include <fstream>              // C++ file streams
 #include <iomanip>              // C++ formatting
@@ -47,12 +48,20 @@
 #include <stdarg.h>             // ANSI C header file 
 #include <inttypes.h>           // defines some platform types
 #include <thread>               // C++ 11 cross-platform threads
+#include <atomic>               // C++ 11 atomics
+#include <chrono>               // C++ 11 clocks
 
 
 #if defined (__unix__) || defined (__linux__)
 #include <sys/socket.h>         /* basic socket functions */
 #include <sys/poll.h>           /* defines poll() call */
+#if defined (__linux__)
+#include <sys/epoll.h>          /* the epoll() reactor */
+#include <sys/eventfd.h>        /* wakes up a reactor thread */
+#endif
 #include <sys/ioctl.h>          /* impt io control functions */
+#include <sys/uio.h>            /* struct iovec for gathered sends */
+#include <fcntl.h>              /* splice() and pipe2() */
 #include <sys/time.h>           /* time_val {} for select */
 #include <netinet/tcp.h>        /* some low level tcp stuff */
 #include <netinet/in.h>         /* sockaddr_in {} definition */
@@ -60,8 +69,9 @@
 #include <unistd.h>             /* many unix system calls */
 #include <netdb.h>              /* extended net defintions */
 
-#define CLOSE(s)        close(s);
+#define CLOSE(s)        Close_Sock(s);
 #define POLL(ps, len)   poll(ps, len, -1)
+#define POLL_TIMEOUT(ps, len, ms)   poll(ps, len, ms)
 #else 
 #if defined(WIN32) || defined(_WIN64)
 #include <WinSock2.h>           /* windows socket library */
@@ -69,6 +79,7 @@
 
 #define CLOSE(s)        closesocket(s)
 #define POLL(ps, len)   WSAPoll(ps, len, -1)
+#define POLL_TIMEOUT(ps, len, ms)   WSAPoll(ps, len, ms)
 #endif
 #endif
 
@@ -80,14 +91,42 @@
 typedef uint8_t u8;
 typedef uint16_t u16;
 typedef uint32_t u32;
+typedef uint64_t u64;
 typedef int8_t s8;
 typedef int16_t s16;
 typedef int32_t s32;
+typedef int64_t s64;
 
 
 
 // misc
 #define BUF_SIZE        2048       // buffer size used for sending and receving
+#define MAX_EVENTS      256        // max number of ready descriptors handed out per reactor wakeup
+
+
+// outbound queues; Send() never blocks, what the socket won't take right away waits in its queue
+#define SEND_HIGH_WATER (256 * 1024)  // queued bytes past which a destination counts as congested
+#define SEND_LOW_WATER  (64 * 1024)   // and below which it's flowing again
+#define SEND_QUEUE_MAX  (64 << 20)      // a consumer this far behind is given up on
+#define LINGER_MS       5000            // how long a closed descriptor gets to drain its queue
+#define SEND_BATCH_MAX  (64 * 1024)     // a coalescing descriptor sends once this much piles up (see Send_Coalesce)
+#define SPLICE_MIN      (16 * 1024)     // payloads smaller than this aren't worth splicing (see Intap_Splice)
+#define LINK_IDLE_SECS  5               // a quiet tunnel link is probed this often; one that doesn't answer is lost
+                                        //  in about four times as long (see Tcp_Keep_Alive)
+
+
+// reactor interest/ready flags; these are the very same bits for poll() and epoll() on linux so we
+//  simply pass them along to which ever backend is running
+#define EV_READ         POLLIN
+#define EV_WRITE        POLLOUT
+#define EV_ERROR        (POLLERR | POLLHUP)
+#define EV_RECV         0x10000     // have the data itself delivered along the event when the backend can
+
+
+// the I/O backends the reactor can run on; chosen at startup (-io)
+#define IO_EPOLL        0           // epoll() readiness; the default on linux
+#define IO_POLL         1           // plain old poll(); the portable one
+#define IO_URING        2           // io_uring with multishot recv and batched sends (falls back to epoll)
 
 
 
@@ -120,6 +159,64 @@ typedef int32_t s32;
 #define CMD_DB_CONNECT    3
 #define CMD_CLI_CONNECT   4
 #define CMD_ECHO          5
+#define CMD_JOIN          6       // an extra tunnel link joining the peer of an earlier CMD_HELLO
+#define CMD_WINDOW        7       // more credit for the sender's stream; the payload is the u32 increment in
+                                  //  network order (INTAP_CAP_WINDOW only)
+#define CMD_RESUME        8       // a new connection taking the place of a lost link; always v1, the payload is
+                                  //  the u64 session and the bytes the sender got off the link, the answer's
+                                  //  the latter alone (INTAP_CAP_RESUME only)
+#define CMD_ACK           9       // the u64 bytes the sender got off the link so far (INTAP_CAP_RESUME only)
+
+
+// INTAP versions; CMD_HELLO offers the highest the sender speaks in the low byte of its port field (0 from 
+//  peers that predate this, i.e. v1) and the answer settles it. CMD_HELLO and CMD_JOIN themselves always go 
+//  as v1.
+#define INTAP_V1          1       // the packed INTAP_FMT on every frame
+#define INTAP_V2          2       // a type byte and varints; see Intap_Encode
+#define INTAP_VERSION     INTAP_V2
+#define INTAP_VERSION_MASK 0x00FF
+
+// INTAP capabilities; the high byte of a CMD_HELLO's port field. What's offered and answered back is on.
+#define INTAP_CAP_LZ      0x0100  // big payloads may go LZ compressed (v2 only; see Intap_Compress)
+#define INTAP_LZ_MIN      512     // the default for the payloads shorter than which aren't worth it
+#define INTAP_CAP_FRAME   0xF000  // the longest payload the sender takes in a frame as 2 KiB << n; the lesser of
+                                  //  the two is on (0 from peers that predate it, they get no more than -bs)
+#define INTAP_FRAME_SHIFT 12      // where the n above sits in the port word
+#define INTAP_CAP_WINDOW  0x0200  // streams are flow controlled; each side sends no more of a stream than the
+                                  //  other has granted (v2 only; see CMD_WINDOW)
+#define INTAP_WINDOW      (1 << 20)   // the credit every stream starts out with on either side
+#define INTAP_CAP_RESUME  0x0400  // a lost link may be reconnected and carry on where it left off; the answer
+                                  //  to the hello carries the u64 session the links are resumed under
+#define INTAP_ACK_BYTES   (64 * 1024) // how much comes off a link between a CMD_ACK and the next
+#define INTAP_REPLAY_MAX  16      // the default for the MiB sent down a link that may go unacknowledged (-replay)
+#define INTAP_RESUME_SECS 60      // the default for how long a lost link may take to come back (-resume)
+
+// INTAP v2 type byte; a v1 frame starts with the 'I' of its signature which never has the tag bit set, so the
+//  two tell apart by the first byte alone
+#define INTAP_V2_TAG      0x80    // it's a v2 frame
+#define INTAP_V2_DEST     0x40    // the destination descriptor follows
+#define INTAP_V2_SRC      0x20    // then the source descriptor
+#define INTAP_V2_LZ       0x10    // the payload is LZ compressed; its length before that leads it as a varint
+#define INTAP_V2_ID       0x0F    // the command id (CMD_xxx)
+#define INTAP_MAX_HDR     sizeof(INTAP_FMT)   // neither version's header is ever longer than v1's
+#define INTAP_FRAME_MAX   (16 << 20)  // the longest payload a frame may carry; anything longer makes no sense
+#define INTAP_FRAME_DEF   (256 * 1024)    // the default for the longest a stream is read for at once (-fm)
+
+// tunnel receive buffers (see INTAP_RX)
+#define INTAP_RX_SIZE     (64 * 1024) // what one starts out with
+#define INTAP_RX_ROOM     (16 * 1024) // the least room a read into it gets
+
+// what Intap_Next() finds at the front of a tunnel receive buffer
+#define INTAP_RX_BAD      -1      // something that makes no sense; the link is beyond saving
+#define INTAP_RX_MORE     0       // a frame that isn't all in yet
+#define INTAP_RX_FRAME    1       // a whole frame
+#define INTAP_RX_SPLICE   2       // the header of a big payload that's mostly still in the kernel (Intap_Splice)
+
+// the traffic classes a frame goes down a scheduling tunnel link in (see Intap_Schedule)
+#define EGRESS_CONTROL    0       // not of any one stream (CMD_WINDOW and the like); ahead of everything
+#define EGRESS_DB         1       // a database stream's (ADO.NET sessions)
+#define EGRESS_REST       2       // a RESTServer stream's
+#define EGRESS_CLASSES    3
 
 
 
@@ -132,11 +229,9 @@ typedef int32_t s32;
 
 
 
-#define CPY_SND_BUFFER(fd, snd, __intap, __buffer, __bytes)  {\
-    memcpy(snd, &__intap, sizeof(__intap)); \
-    memcpy(snd + sizeof(__intap), __buffer, __bytes); \
-    Send(fd, snd, sizeof(__intap) + __bytes); \
-}
+// the header is written out to snd and goes along with the payload; see Intap_Send
+#define CPY_SND_BUFFER(fd, snd, __intap, __buffer, __bytes, __version, ...)  \
+    Intap_Send(fd, snd, __intap, __buffer, __bytes, __version, ##__VA_ARGS__)
 
 
 
@@ -147,7 +242,7 @@ typedef int32_t s32;
  * @brief 
  *  A custom protocol; INTAP acronynm for INTAPS Network Transfer and Access Protocol.
  */
-#pragma pack(1)
+#pragma pack(push, 1)
 typedef struct INTAP_PROTO_FMT
 {
     const char signature[8]{"INTAP11"};     // a protocol identifier; our custom protocol
@@ -160,6 +255,32 @@ typedef struct INTAP_PROTO_FMT
     // extensions; now officially INTAPv1.1
     u32 buf_len;        // the number of bytes down-below
 } INTAP_FMT, *INTAP_FMT_PTR;
+#pragma pack(pop)
+
+
+
+/**
+ * @brief 
+ *  What's been read off a tunnel link and is yet to be handled. The link is read for as much as there is in 
+ *  one go and every whole frame handed out right from the buffer (see Intap_Fill and Intap_Next); a frame cut
+ *  short stays at the front till the rest of it comes in. The buffer grows to hold the longest frame it's 
+ *  seen and what's left in it is moved back to the start only once there's no room past it, so frames are
+ *  never split across its end.
+ */
+typedef struct INTAP_RX_FMT
+{
+    std::vector<char> vbuf;     // the bytes read
+    size_t head{0};             // the first one yet to be handled
+    size_t tail{0};             // one past the last one read
+    size_t hlen{0};             // header length of the frame at head; set along with INTAP_RX_SPLICE
+    size_t plen{0};             // and its payload length
+    std::vector<char> vplain;   // the payload of the last compressed frame handed out, decompressed
+    size_t splice_left{0};      // payload still to go straight through from the link (see Intap_Splice)
+    int splice_to{-1};          // to where
+    u32 splice_gen{0};          // and its registration; a stream gone since has the rest thrown away
+    u64 rcvd{0};                // bytes taken off the link, hello aside; where a resumed link picks up from
+    u64 acked{0};               // and what the peer was last told of that (see Intap_Ack)
+} INTAP_RX, *INTAP_RX_PTR;
 
 
 
@@ -167,24 +288,67 @@ typedef struct INTAP_PROTO_FMT
  * @brief 
  *  the 'local-buddy' is meant to handle multiple remote-buddies at once each one using only one process
  *  per machine; this structure holds a connection info for each remote-buddy connection which contains
- *  multiple descriptors (since we'd be somewhat emulating servers to some-degree)
+ *  multiple descriptors (since we'd be somewhat emulating servers to some-degree). A remote-buddy may come over
+ *  several tunnel links (see CMD_JOIN); streams stick to one of them picked by the sender's descriptor.
  */
 typedef struct CONNECTION_INFO_FMT
 {
+    int fd;                             // the remote-buddy descriptor itself
+    std::vector<int> vlinks;            // all the tunnel links of the remote-buddy; [0] is fd itself
     std::string ip;                     // ip address of RESTServer
+    u32 addr{0};                        // and in binary (network order) once it's bound (see route-index.h)
+    int route_slot{-1};                 // where it is among those yet to be bound; -1 once it is
     u16 port;                           // the coresponding port # (in network-byte-order)
-    std::unordered_map<int, int> mfds;  // map of db descriptors (local -> foreign)
+    std::unordered_map<int, int> mrfd;  // its stream descriptors back to ours (see stream-table.h); for the frames
+                                        //  of those streams it doesn't know our end of yet
+    std::vector<int> vpaused;           // streams held back for a backed up link
+    std::unordered_map<int, INTAP_RX> mrx;  // what's been read off each link and is yet to be handled
+    int version{INTAP_V1};              // INTAP version spoken with it
+    u16 caps{0};                        // and the capabilities (INTAP_CAP_xxx) settled on
+    size_t frame_max{BUF_SIZE};         // the longest payload a frame to it may carry (see INTAP_CAP_FRAME)
+    u64 session{0};                     // what its links are resumed under (see INTAP_CAP_RESUME)
+    u64 resume_by{0};                   // when we stop waiting on the links it's lost (Now_Ms() based); 0 if
+                                        //  they're all up
 } CONNECTION_INFO, *CONNECTION_INFO_PTR;
 
 
 
-//==============================================================================================================|
-// GLOBALS
-//==============================================================================================================|
-extern std::vector<struct pollfd> vpoll;       // vector of poll structus
-extern struct pollfd fdpoll;                   // a generalized storage
+/**
+ * @brief 
+ *  An upstream connect that's still on its way (see Connect_Async); whatever is bound for the descriptor in the
+ *  meantime is held on to and flushed once the connect goes through.
+ */
+typedef struct CONNECT_WAIT_FMT
+{
+    u64 deadline;           // when we give up on it (Now_Ms() based)
+    std::string pending;    // payload that came in while connecting
+} CONNECT_WAIT, *CONNECT_WAIT_PTR;
+
+
+
+/**
+ * @brief 
+ *  A ready descriptor as reported by the reactor; the context pointer is whatever the caller registered the
+ *  descriptor with, so that routing never needs to go hunting for it.
+ */
+typedef struct REACTOR_EVENT_FMT
+{
+    int fd;             // the ready descriptor
+    u32 revents;        // what's ready on it; a mix of EV_xxx flags
+    u32 gen;            // generation of the registration; helps weed out stale events
+    void *ctx;          // context pointer registered along with the descriptor
+    s32 ibuf;           // handle to data delivered along the event (io_uring); -1 if still in the kernel
+} REACTOR_EVENT, *REACTOR_EVENT_PTR;
+
 
 
+/**
+ * @brief 
+ *  Called as a descriptor's outbound queue goes over SEND_HIGH_WATER (bcongested set) and again once it's 
+ *  back under SEND_LOW_WATER; that's the caller's cue to stop and resume reading whatever feeds it.
+ */
+typedef void (*CONGESTION_CB)(const int fd, const bool bcongested);
+
 
 
 //==============================================================================================================|
@@ -192,18 +356,62 @@ extern struct pollfd fdpoll;                   // a generalized storage
 //==============================================================================================================|
 int Socket();
 void Connect(int fds, const char *ip, const u16 port);
+int Connect_Async(int fds, const char *ip, const u16 port);
+int Connect_Finish(int fds);
+int Connect_Timeout(int fds, const char *ip, const u16 port, const int ms);
+u64 Now_Ms();
+u64 Now_Us();
+int Connect_Wait_Ms(const std::unordered_map<int, CONNECT_WAIT> &mconnecting);
 void Bind(int fds, const u16 port);
 void Listen(int fds, int backlog);
 int Accept(const int listen_fd, char* addr_str, u16 &port);
 void Send(int fds, const char *buf, const size_t buf_len);
+void Send_Iov(int fds, const struct iovec *piov, const int count);
+size_t Send_Pending(const int fds);
+bool Send_Congested(const int fds);
+bool Send_Block(const int fds, const char *buf, const size_t buf_len);
+void Send_Coalesce(const int fds, const bool bon=true);
 int Recv(int fds, char *buf, const size_t buf_len);
+size_t Intap_Encode(char *dst, const INTAP_FMT &intap, const int version, const bool blz=false);
+int Intap_Decode(const char *src, const size_t len, INTAP_FMT &intap, bool *pblz=nullptr);
+u16 Intap_Frame_Cap(const size_t frame_max);
+size_t Intap_Frame_Max(const u16 offer, const size_t frame_max, const size_t legacy);
+void Intap_Send(const int fds, char *snd, const INTAP_FMT &intap, const char *buf, const size_t len, 
+    const int version, const int stream=-1, const int cls=EGRESS_CONTROL);
+void Intap_Compress(const int fds, const size_t min_len);
+void Intap_Schedule(const int fds, const int weight_db, const int weight_rest);
+void Lz_Init(const int threads);
+int Intap_Fill(const int fds, INTAP_RX &rx);
+void Intap_Feed(INTAP_RX &rx, const char *buf, const size_t len);
+int Intap_Next(INTAP_RX &rx, INTAP_FMT &intap, const char *&payload);
+int Intap_Splice(const int fds, INTAP_RX &rx, const int to);
+void Intap_Replay(const int fds, const size_t max);
+void Intap_Acked(const int fds, const u64 seq);
+void Intap_Ack(const int fds, INTAP_RX &rx, const int version);
+bool Intap_Park(const int fds);
+bool Intap_Parked(const int fds);
+bool Intap_Resume(const int fds, const int nfd, const u64 seq, void *ctx, const char *lead=nullptr, 
+    const size_t lead_len=0);
 void Select(int maxfdp, fd_set &rset);
-void Set_Non_Blocking(int fd);
+void Set_Non_Blocking(int fd, const bool bon=true);
 void Tcp_Reuse_Addr(const int lfd);
-void Tcp_Keep_Alive(const int fd);
+void Tcp_Reuse_Port(const int lfd);
+void Tcp_Keep_Alive(const int fd, const int idle=0);
 int Tcp_NoDelay(const int fds);
 int Set_RecvTimeout(const int fds, const int sec=3);
 void Erase_Sock(const int fd);
+void Close_Sock(const int fd);
+
+void Reactor_Init(const int backend=IO_EPOLL, const size_t buf_size=BUF_SIZE);
+void Reactor_Add(const int fd, const u32 events, void *ctx=nullptr);
+void Reactor_Mod(const int fd, const u32 events);
+void Reactor_Set_Ctx(const int fd, void *ctx);
+void *Reactor_Ctx(const int fd);
+void Reactor_Del(const int fd);
+int Reactor_Wait(REACTOR_EVENT_PTR pevents, const int max_events, const int timeout=-1);
+bool Reactor_Stale(const REACTOR_EVENT &ev);
+int Reactor_Recv(const REACTOR_EVENT &ev, char *buf, const size_t buf_len);
+void Reactor_On_Congestion(CONGESTION_CB cb);
 
 
 
@@ -0,0 +1,44 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Which remote-buddy a new database connection goes over (local-buddy's New_Db); the one the address it came
+//  from is bound to, or else one yet to be bound which is bound to it from then on. Remote-buddies are kept by
+//  their address in binary along with a list of those yet to be bound, so a pick takes the same no matter how
+//  many of them there are.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef ROUTE_INDEX_H
+#define ROUTE_INDEX_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Route_Add(CONNECTION_INFO_PTR pci);
+void Route_Remove(CONNECTION_INFO_PTR pci);
+CONNECTION_INFO_PTR Route_Find(const u32 addr);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,148 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  The streams; one compact entry for every descriptor in a flat table indexed by the descriptor itself, so
+//  that routing anything that comes in on a stream (or off the tunnel for one) is a single array access. Both
+//  buddies keep theirs here; descriptors are unique to the process, so is the table. Only the reactor thread
+//  owning a descriptor ever touches its entry.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef STREAM_TABLE_H
+#define STREAM_TABLE_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define STREAM_MAX_FDS      32768       // INTAP carries descriptors as signed 16 bits; those past it can't be streams
+
+
+// what a stream is up to
+#define STREAM_FREE         0           // no stream on the descriptor
+#define STREAM_CONNECTING   1           // its upstream connect is on the way
+#define STREAM_OPEN         2           // up and running
+
+
+// and what else there is to know of it
+#define SF_UNNAMED          0x0001      // the other side is yet to hear our descriptor; it goes along next time
+#define SF_HOLD             0x0002      // not read from till the upstream says so ("100 Continue")
+#define SF_PAUSED           0x0004      // not read from till its tunnel link drains
+#define SF_HTTP             0x0008      // the HTTP going over it is followed (local-buddy's RESTServer streams)
+#define SF_STALLED          0x0010      // not read from till the other side grants more credit (CMD_WINDOW)
+#define SF_DB               0x0020      // a database stream (ADO.NET); its frames go as EGRESS_DB
+
+
+// credit is granted back in chunks no smaller than this; fewer CMD_WINDOW frames
+#define STREAM_GRANT_MIN    (INTAP_WINDOW / 4)
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A stream; our end of it is the descriptor indexing the table, the other end is on the far side of the
+ *  tunnel.
+ */
+typedef struct STREAM_FMT
+{
+    void *ppeer;            // the tunnel peer it goes over (local-buddy's remote-buddies); nullptr for the one
+    s32 rfd;                // its descriptor on the other side; -1 till we've heard of it
+    u8 state;               // one of STREAM_xxx
+    u8 rshift;              // it's read 1 << rshift bytes at a time (see Stream_Read_Size)
+    u16 flags;              // a mix of SF_xxx
+    s32 credit;             // bytes it may still send over the tunnel before the other side grants more
+    u32 unacked;            // bytes it took off the tunnel and passed on that are yet to be granted back
+} STREAM, *STREAM_PTR;
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+extern STREAM stream_table[STREAM_MAX_FDS];     // indexed by descriptor
+extern std::atomic<int> stream_top;             // one past the highest descriptor ever opened as a stream
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+STREAM_PTR Stream_Open(const int fd, void *ppeer, const int rfd, const u8 state, const u16 flags=0);
+void Stream_Close(const int fd);
+void Stream_Adapt(STREAM_PTR ps, const size_t bytes, const size_t max);
+u32 Stream_Grant(STREAM_PTR ps, const size_t bytes, const bool bdrained);
+bool Stream_Credit(STREAM_PTR ps, const u32 grant);
+int Stream_Link(CONNECTION_INFO_PTR pci, const int fd);
+void Stream_Echo(INTAP_FMT &intap, STREAM_PTR ps, const int fd, const int bytes, const int version);
+int Stream_Next(const void *ppeer, const int from);
+
+
+/**
+ * @brief
+ *  The stream on a descriptor
+ *
+ * @param [fd] the descriptor
+ *
+ * @return STREAM_PTR
+ *  the stream or nullptr if there's none
+ */
+inline STREAM_PTR Stream_Get(const int fd)
+{
+    if ((u32)fd >= STREAM_MAX_FDS || stream_table[fd].state == STREAM_FREE)
+        return nullptr;
+
+    return &stream_table[fd];
+} // end Stream_Get
+
+
+/**
+ * @brief
+ *  The traffic class a stream's frames go down the tunnel in (see Intap_Schedule)
+ */
+inline int Stream_Class(const STREAM_PTR ps)
+{
+    return (ps->flags & SF_DB) ? EGRESS_DB : EGRESS_REST;
+} // end Stream_Class
+
+
+/**
+ * @brief
+ *  How much to read off a stream in one go; what it's been settling on (see Stream_Adapt) up to the longest
+ *  payload a frame may carry over its tunnel
+ *
+ * @param [ps] the stream
+ * @param [max] the longest payload
+ */
+inline size_t Stream_Read_Size(const STREAM_PTR ps, const size_t max)
+{
+    return std::min((size_t)1 << ps->rshift, max);
+} // end Stream_Read_Size
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
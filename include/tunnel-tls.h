@@ -0,0 +1,57 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  TLS on the tunnel links, with the kernel doing the encrypting (kTLS). The buddies do the handshake themselves
+//  with OpenSSL, blocking and once a link, and verify each other against a CA of their own; the keys then go to
+//  the kernel, the OpenSSL side of it is let go and the link is a plain socket again as far as the rest of the
+//  code goes: batched sends, splice and io_uring all work as they did, only on records. A link never goes on in
+//  the clear; one the kernel won't take the keys for is dropped. A link reconnected while the reactor's running
+//  does its handshake in steps, as it turns ready (Tls_Connect_Step).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef TUNNEL_TLS_H
+#define TUNNEL_TLS_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define TLS_RECORD_HANDSHAKE    0x16    // what a TLS link starts with; neither INTAP nor TDS ever does
+#define TLS_HANDSHAKE_SECS      3       // how long the other side may take answering along the handshake
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+bool Tls_Init(const bool bserver, const std::string &cert, const std::string &key, const std::string &ca);
+bool Tls_Active();
+bool Tls_Connect(const int fd);
+int Tls_Accept_Step(const int fd, void *&pssl, u32 &events);
+int Tls_Connect_Step(const int fd, void *&pssl, u32 &events);
+void Tls_Abort(void *&pssl);
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,99 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Warm pools of already connected (but unused) sockets to the upstreams; the RESTServer for local-buddy and
+//  the RDBMS for remote-buddy. A new stream claims one and skips the handshake; the pool refills itself in the
+//  background on the reactor of the thread that owns it. Streams done with (HTTP kept alive) may go back in.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+#ifndef UPSTREAM_POOL_H
+#define UPSTREAM_POOL_H
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "net-wrappers.h"
+#include <deque>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define POOL_SIZE           4           // warm sockets kept per upstream by default (-pool)
+#define POOL_KEEP           32          // streams kept alive per upstream on top of those (-keep)
+#define POOL_IDLE_MS        20000       // and how long one sits unused before it's swapped for a fresh one (-pidle)
+#define POOL_RETRY_MS       1000        // a failed connect holds off refilling for this long at first
+#define POOL_RETRY_MAX_MS   30000       // and no longer than this however many fail in a row
+#define POOL_MAX_UPSTREAMS  16          // upstreams pooled per thread; those past it simply connect as needed
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A warm socket; connected and waiting to be claimed
+ */
+typedef struct POOL_SOCK_FMT
+{
+    int fd;                 // the descriptor
+    u64 since;              // when it got connected or came back (Now_Ms() based)
+    bool breused;           // came back from a stream (see Pool_Return); it's to have nothing to say
+} POOL_SOCK, *POOL_SOCK_PTR;
+
+
+
+/**
+ * @brief
+ *  The pool of one upstream; owned by the reactor thread that opened it (see Pool_Open) and never touched by
+ *  any other.
+ */
+typedef struct UPSTREAM_POOL_FMT
+{
+    std::string ip;                             // the upstream
+    u16 port{0};
+    size_t size{0};                             // how many warm ones we're after
+    size_t keep{0};                             // and how many more may come back from streams
+    u64 idle_ms{0};                             // how long one may sit unused; 0 for ever
+    u64 connect_ms{0};                          // how long a connect may take
+    u64 backoff{0};                             // how long we hold off after a failed connect; 0 none failed
+    u64 retry_at{0};                            // no refilling till then
+    std::deque<POOL_SOCK> qready;               // the warm ones, oldest first
+    std::unordered_map<int, u64> mconnecting;   // the ones on their way and their deadlines
+} UPSTREAM_POOL, *UPSTREAM_POOL_PTR;
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+UPSTREAM_POOL_PTR Pool_Open(const char *ip, const u16 port, const size_t size, const size_t keep, 
+    const int idle_ms, const int connect_ms);
+int Pool_Claim(UPSTREAM_POOL_PTR pool);
+bool Pool_Return(UPSTREAM_POOL_PTR pool, const int fd);
+bool Pool_Event(const REACTOR_EVENT &ev);
+int Pool_Wait_Ms(const int timeout);
+void Pool_Tick();
+void Pool_Close();
+
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -12,7 +12,7 @@
 //  23rd of March 2023, Thursday
 //
 // Last Updated:
-//  23rd of March 2023, Thursday
+//  17th of October 2026, Saturday
 //==============================================================================================================|
 #ifndef UTILS_H
 #define UTILS_H
@@ -22,6 +22,11 @@
 // INCLUDES
 //==============================================================================================================|
 #include "net-wrappers.h"
+#include "upstream-pool.h"
+#include "buf-pool.h"
+#include "egress-sched.h"
+#include "metrics.h"
+#include "logger.h"
 
 
 //==============================================================================================================|
@@ -49,14 +54,31 @@ typedef struct APP_CONFIG_FILE
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
-extern char *buffer;               // a generalized storage buffer for receiveing 
-extern char *snd_buffer;            // buffer used for sending custom-appended info
+extern thread_local char *buffer;       // a generalized storage buffer for receiveing 
+extern thread_local char *snd_buffer;   // buffer used for sending custom-appended info
 
 
 // command line overrides
 extern int debug_mode;                  // enables debugging mode; default no display simply run mode
 extern int backlog;                     // number of buffered conns (or so we're told, that's a suspicious fella!!!)
-extern int buffer_size;                 // buffer size for buffer
+extern int buffer_size;                 // buffer size for buffer; what a stream is read for at first
+extern int frame_max;                   // and the most it's ever read for at once (-fm)
+extern int io_backend;                  // which I/O backend runs the reactor (IO_EPOLL, IO_POLL or IO_URING)
+extern int connect_timeout;             // milli-seconds an upstream connect may take before we give up
+extern int lz_min;                      // shortest tunnel payload worth compressing; 0 turns it off
+extern int lz_threads;                  // workers compressing them
+extern int pool_size;                   // warm sockets kept per upstream; 0 connects as needed
+extern int pool_keep;                   // RESTServer streams kept alive for reuse on top of those
+extern int pool_idle_ms;                // how long a warm one sits unused before it's replaced
+extern int weight_db;                   // share of the tunnel a database stream gets when it's backed up
+extern int weight_rest;                 // and that of a RESTServer stream
+extern int metrics_port;                // where the metrics are served on the loopback; 0 not at all
+extern std::string log_file;            // the file the log is appended to (-log); stdout if none
+extern std::string tls_cert;            // certificate the tunnel's TLS is done with (-tlsc); none, no TLS
+extern std::string tls_key;             // its private key (-tlsk)
+extern std::string tls_ca;              // the CA the other buddy's certificate must be signed by (-tlsca)
+extern int resume_secs;                 // how long a lost tunnel link may take to come back (-resume); 0 never
+extern int replay_max;                  // MiB sent down a link that may go unacknowledged and it still resumes
 
 
 extern u16 listen_port;
@@ -68,10 +90,12 @@ extern u16 listen_port;
 //==============================================================================================================|
 // PROTOTYPES
 //==============================================================================================================|
+void Dump(const char *msg, ...) __attribute__((format(printf, 1, 2)));
 void Dump_Hex(const char *p_buf, const size_t len);
 int Read_Config(APP_CONFIG_PTR p_config, std::string filename);
 void Split_String(const std::string &str, const char tokken, std::vector<std::string> &dest);
 void Process_Command_Line(char **argv, const int argc, std::string &filename);
+void Alloc_Buffers();
 
 
 
@@ -0,0 +1,194 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  The relay buffer pool; see buf-pool.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "buf-pool.h"
+#include <sys/mman.h>
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+bool buf_huge{false};
+
+// per reactor thread; a buffer handed back on another thread simply joins that one's free list (slabs are
+//  never let go of)
+static thread_local char *free_list[BUF_CLASSES];      // the buffers handed back; linked through their first bytes
+static thread_local char *slab_next[BUF_CLASSES];      // what's left of the slab each class is carving out of
+static thread_local char *slab_end[BUF_CLASSES];
+static std::atomic<bool> bhuge_warned{false};
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The class a buffer of so many bytes falls in; BUF_CLASSES if it's past the biggest
+ */
+static inline int Class_Of(const size_t size)
+{
+    int c{0};
+    while (c < BUF_CLASSES && ((size_t)1 << (BUF_MIN_SHIFT + c)) < size)
+        c++;
+
+    return c;
+} // end Class_Of
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Maps in a slab; with huge pages if asked for and there are any to be had (otherwise the kernel's asked to
+ *  back it with transparent ones). Pages are only ever touched as buffers are carved out of it.
+ *
+ * @return char*
+ *  the slab or nullptr if there's no memory
+ */
+static char *New_Slab()
+{
+    void *p{MAP_FAILED};
+    if (buf_huge)
+    {
+        p = mmap(nullptr, BUF_SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED && !bhuge_warned.exchange(true))
+            fprintf(stderr, "buffer pool: no huge pages to be had, going on with regular ones\n");
+    } // end if huge
+
+    if (p == MAP_FAILED)
+    {
+        p = mmap(nullptr, BUF_SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            perror("mmap");
+            return nullptr;
+        } // end if no memory
+
+        if (buf_huge)
+            madvise(p, BUF_SLAB_SIZE, MADV_HUGEPAGE);
+    } // end if regular
+
+    return (char *)p;
+} // end New_Slab
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a buffer out of the pool
+ *
+ * @param [size] in: at least how many bytes it must hold, out: how many it does
+ *
+ * @return char*
+ *  the buffer; the process can't go on without it
+ */
+char *Buf_Get(size_t &size)
+{
+    int c = Class_Of(size);
+    char *p{nullptr};
+    if (c < BUF_CLASSES)
+    {
+        size = (size_t)1 << (BUF_MIN_SHIFT + c);
+        if ( (p = free_list[c]) )
+        {
+            free_list[c] = *(char **)p;
+            return p;
+        } // end if one handed back
+
+        if (slab_next[c] == slab_end[c] && (slab_next[c] = New_Slab()))
+            slab_end[c] = slab_next[c] + BUF_SLAB_SIZE;
+
+        if (slab_next[c])
+        {
+            p = slab_next[c];
+            slab_next[c] += size;
+            return p;
+        } // end if carved
+    } // end if pooled
+
+    if ( !(p = (char *)malloc(size)) )
+    {
+        perror("malloc fail");
+        exit(EXIT_FAILURE);
+    } // end if
+
+    return p;
+} // end Buf_Get
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands a buffer back
+ *
+ * @param [p] the buffer; nullptr is fine
+ * @param [size] how many bytes it holds (as Buf_Get said)
+ */
+void Buf_Put(char *p, const size_t size)
+{
+    if (!p)
+        return;
+
+    int c = Class_Of(size);
+    if (c == BUF_CLASSES)
+    {
+        free(p);
+        return;
+    } // end if off the heap
+
+    *(char **)p = free_list[c];
+    free_list[c] = p;
+} // end Buf_Put
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Swaps a buffer for a bigger one, keeping what's in it; it at least doubles so that one grown a little at a
+ *  time isn't copied over and over
+ *
+ * @param [p] the buffer; nullptr for none yet
+ * @param [size] how many bytes it holds
+ * @param [used] how many of them are to be kept (from the start)
+ * @param [need] how many it must hold
+ */
+void Buf_Grow(char *&p, size_t &size, const size_t used, const size_t need)
+{
+    if (size >= need)
+        return;
+
+    size_t grown = std::max(need, size * 2);
+    char *pgrown = Buf_Get(grown);
+    if (used)
+        memcpy(pgrown, p, used);
+
+    Buf_Put(p, size);
+    p = pgrown;
+    size = grown;
+} // end Buf_Grow
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,159 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  The tunnel egress scheduler; see egress-sched.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "egress-sched.h"
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets how much each class of stream gets a round relative to the others; no less than 1 each
+ *
+ * @param [sched] the scheduler
+ * @param [weight_db] database streams
+ * @param [weight_rest] RESTServer streams
+ */
+void Egress_Weights(EGRESS_SCHED &sched, const int weight_db, const int weight_rest)
+{
+    sched.quantum[EGRESS_DB] = (size_t)EGRESS_QUANTUM * std::max(weight_db, 1);
+    sched.quantum[EGRESS_REST] = (size_t)EGRESS_QUANTUM * std::max(weight_rest, 1);
+} // end Egress_Weights
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a frame up behind the others of its stream; a stream with nothing waiting joins the end of the round
+ *
+ * @param [sched] the scheduler
+ * @param [stream] the stream it's of (our descriptor); ignored for EGRESS_CONTROL
+ * @param [cls] its traffic class
+ * @param [intap] the header
+ * @param [buf] the payload
+ * @param [len] its length
+ */
+void Egress_Push(EGRESS_SCHED &sched, const int stream, const int cls, const INTAP_FMT &intap, const char *buf,
+    const size_t len)
+{
+    std::string frame;
+    frame.reserve(sizeof(INTAP_FMT) + len);
+    frame.append((const char *)&intap, sizeof(INTAP_FMT));
+    frame.append(buf, len);
+    sched.bytes += frame.size();
+
+    if (cls == EGRESS_CONTROL || stream < 0)
+    {
+        sched.qcontrol.push_back(std::move(frame));
+        return;
+    } // end if control
+
+    EGRESS_FLOW &flow = sched.mflows[stream];
+    if (flow.qframes.empty())
+    {
+        flow.cls = cls;
+        sched.qround.push_back(stream);
+    } // end if new to the round
+
+    flow.qframes.push_back(std::move(frame));
+} // end Egress_Push
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes the next frame to go; control frames first, then the stream at the head of the round for as long as
+ *  its deficit covers its next frame, at which point it goes to the back with what's left of the deficit. A
+ *  stream that runs out of frames leaves the round and forgets its deficit.
+ *
+ * @param [sched] the scheduler
+ * @param [frame] out: INTAP header followed by the payload
+ *
+ * @return bool
+ *  false if there's nothing waiting
+ */
+bool Egress_Pop(EGRESS_SCHED &sched, std::string &frame)
+{
+    if (!sched.qcontrol.empty())
+    {
+        frame = std::move(sched.qcontrol.front());
+        sched.qcontrol.pop_front();
+        sched.bytes -= frame.size();
+        return true;
+    } // end if control
+
+    while (!sched.qround.empty())
+    {
+        int stream = sched.qround.front();
+        EGRESS_FLOW &flow = sched.mflows[stream];
+        if (!flow.bturn)
+        {
+            flow.deficit += sched.quantum[flow.cls];
+            flow.bturn = true;
+        } // end if its turn's just come
+
+        size_t size = flow.qframes.front().size();
+        if (size > flow.deficit)
+        {
+            // not this round; it keeps what it has for the next
+            flow.bturn = false;
+            sched.qround.pop_front();
+            sched.qround.push_back(stream);
+            continue;
+        } // end if too big
+
+        flow.deficit -= size;
+        frame = std::move(flow.qframes.front());
+        flow.qframes.pop_front();
+        sched.bytes -= size;
+
+        if (flow.qframes.empty())
+        {
+            sched.qround.pop_front();
+            sched.mflows.erase(stream);
+        } // end if done
+        return true;
+    } // end while
+
+    return false;
+} // end Egress_Pop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Drops everything waiting; the link's gone
+ */
+void Egress_Clear(EGRESS_SCHED &sched)
+{
+    sched.qcontrol.clear();
+    sched.mflows.clear();
+    sched.qround.clear();
+    sched.bytes = 0;
+} // end Egress_Clear
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
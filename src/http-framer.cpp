@@ -0,0 +1,448 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Follows the HTTP/1.1 messages on a stream as they go by, one direction at a time, without holding on to any
+//  more of them than the head (or chunk line) being read. Bodies are sized by Content-Length or chunked; one
+//  with neither runs till the connection closes and the stream is never reused.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "http-framer.h"
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Does the name of the header line start the way it should? Case doesn't matter.
+ */
+static bool Header_Is(const std::string &line, const char *name)
+{
+    size_t len = strlen(name);
+    return line.size() > len && line[len] == ':' && !strncasecmp(line.c_str(), name, len);
+} // end Header_Is
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the header line one Header_Is can't be trusted with? Blanks before the colon, or a line folded onto the
+ *  one before, aren't any header to us yet some server down the line may well take them for one (RFC 7230 
+ *  section 3.2.4).
+ */
+static bool Header_Odd(const std::string &line)
+{
+    size_t colon = line.find(':');
+    if (line[0] == ' ' || line[0] == '\t')
+        return true;
+
+    return colon != std::string::npos && colon > 0 && (line[colon - 1] == ' ' || line[colon - 1] == '\t');
+} // end Header_Odd
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The Content-Length of a header line; nothing but digits makes one
+ *
+ * @return s64
+ *  the length or -1 if it's no good
+ */
+static s64 Header_Length(const std::string &line)
+{
+    size_t first = line.find_first_not_of(" \t", line.find(':') + 1);
+    size_t last = line.find_last_not_of(" \t");
+    if (first == std::string::npos || last - first >= 18)
+        return -1;
+
+    for (size_t i = first; i <= last; i++)
+    {
+        if (!isdigit((u8)line[i]))
+            return -1;
+    } // end for
+
+    return strtoll(line.c_str() + first, nullptr, 10);
+} // end Header_Length
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The value of a header line in lower case; only ever looked through for tokens
+ */
+static std::string Header_Value(const std::string &line)
+{
+    std::string value = line.substr(line.find(':') + 1);
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+} // end Header_Value
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The last of the codings a Transfer-Encoding line lists; it's only chunked if that's the one applied last
+ *  (RFC 7230 section 3.3.1)
+ */
+static std::string Last_Coding(const std::string &line)
+{
+    std::string value = Header_Value(line);
+    size_t comma = value.rfind(',');
+    size_t first = value.find_first_not_of(" \t", comma == std::string::npos ? 0 : comma + 1);
+    if (first == std::string::npos)
+        return "";
+
+    return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+} // end Last_Coding
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the last line read in a blank one?
+ */
+static bool Blank_Last(const std::string &line)
+{
+    size_t len = line.size();
+    if (line == "\n" || line == "\r\n")
+        return true;
+
+    return (len >= 2 && line[len - 2] == '\n') || (len >= 3 && !line.compare(len - 3, 3, "\n\r\n"));
+} // end Blank_Last
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A message is whole; on to the head of the next
+ */
+static void Done(HTTP_FRAMER &fr)
+{
+    fr.messages++;
+    fr.state = HTTP_ST_HEAD;
+    fr.left = 0;
+    fr.line.clear();
+} // end Done
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The body (or chunk) has all come in; see what follows it
+ */
+static void Consumed(HTTP_FRAMER &fr)
+{
+    if (fr.state == HTTP_ST_BODY)
+        Done(fr);
+    else if (fr.state == HTTP_ST_CHUNK_DATA)
+    {
+        fr.state = HTTP_ST_CHUNK_END;
+        fr.left = 2;
+    } // end else if chunk
+    else
+        fr.state = HTTP_ST_CHUNK_SIZE;
+} // end Consumed
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes out how long the body of the message whose head was just read in is (RFC 7230 section 3.3.3) and
+ *  whether the connection is to be kept once it's done with
+ *
+ * @param [hs] the stream
+ * @param [fr] the direction the head came in
+ * @param [bresponse] is it a response?
+ */
+static void Parse_Head(HTTP_STREAM &hs, HTTP_FRAMER &fr, const bool bresponse)
+{
+    std::vector<std::string> vlines;
+    size_t pos{0}, eol;
+    while ( (eol = fr.line.find('\n', pos)) != std::string::npos)
+    {
+        size_t end = (eol > pos && fr.line[eol - 1] == '\r') ? eol - 1 : eol;
+        if (end > pos)
+            vlines.push_back(fr.line.substr(pos, end - pos));
+        pos = eol + 1;
+    } // end while
+
+    fr.line.clear();
+    if (vlines.empty())
+    {
+        fr.state = HTTP_ST_LOST;
+        return;
+    } // end if nothing
+
+    // the start line; "HTTP/1.1 200 OK" or "GET / HTTP/1.1"
+    const std::string &start = vlines[0];
+    bool b10{false}, bnobody{false};
+    int status{0};
+    if (bresponse)
+    {
+        if (start.size() < 12 || start.compare(0, 5, "HTTP/"))
+        {
+            fr.state = HTTP_ST_LOST;
+            return;
+        } // end if not a status line
+
+        b10 = !start.compare(0, 8, "HTTP/1.0");
+        status = atoi(start.c_str() + 9);
+    } // end if response
+    else
+    {
+        size_t sp = start.find(' ');
+        if (sp == std::string::npos || start.size() < 9 || start.compare(start.size() - 8, 7, "HTTP/1."))
+        {
+            fr.state = HTTP_ST_LOST;
+            return;
+        } // end if not a request line
+
+        b10 = !start.compare(start.size() - 8, 8, "HTTP/1.0");
+        bnobody = !start.compare(0, sp, "HEAD");
+        if (!start.compare(0, sp, "CONNECT"))
+            hs.bclose = true;       // a tunnel from here on
+    } // end else request
+
+    s64 length{-1};
+    int lengths{0};
+    bool bchunked{false}, bcoded{false}, bkeep{false}, bodd{false};
+    for (size_t i = 1; i < vlines.size(); i++)
+    {
+        if (Header_Odd(vlines[i]))
+            bodd = true;
+        else if (Header_Is(vlines[i], "Content-Length"))
+        {
+            length = Header_Length(vlines[i]);
+            lengths++;
+        } // end else if length
+        else if (Header_Is(vlines[i], "Transfer-Encoding"))
+        {
+            bcoded = true;
+            bchunked = Last_Coding(vlines[i]) == "chunked";     // a later line's codings follow the earlier's
+        } // end else if coded
+        else if (Header_Is(vlines[i], "Connection"))
+        {
+            std::string value = Header_Value(vlines[i]);
+            if (value.find("close") != std::string::npos || value.find("upgrade") != std::string::npos)
+                hs.bclose = true;
+            if (value.find("keep-alive") != std::string::npos)
+                bkeep = true;
+        } // end else if connection
+    } // end for
+
+    if (b10 && !bkeep)
+        hs.bclose = true;           // 1.0 closes unless told otherwise
+
+    // a head two servers could size differently is never followed; that's how requests get smuggled
+    if (bodd || lengths > 1 || (lengths && length < 0))
+    {
+        hs.bclose = true;
+        fr.state = HTTP_ST_LOST;
+        return;
+    } // end if ambiguous
+
+    if (bcoded && lengths)
+    {
+        hs.bclose = true;           // the coding wins over the length, but the connection's not to be trusted
+        length = -1;
+    } // end if both
+
+    if (bresponse)
+    {
+        if (status >= 100 && status < 200 && status != 101)
+        {
+            fr.state = HTTP_ST_HEAD;
+            return;                 // interim (say "100 Continue"); the real one's still to come
+        } // end if informational
+
+        if (status == 101 || hs.qnobody.empty())
+        {
+            hs.bclose = true;       // switching protocols or answering what no one asked
+            fr.state = HTTP_ST_LOST;
+            return;
+        } // end if can't follow
+
+        bnobody = hs.qnobody.front() || status == 204 || status == 304;
+        hs.qnobody.pop_front();
+    } // end if response
+    else
+    {
+        hs.qnobody.push_back(bnobody);
+        bnobody = false;            // a HEAD request may well have a body, odd as it is
+        if (!bcoded && length < 0)
+            length = 0;             // requests without either have none
+    } // end else request
+
+    if (bnobody || (!bchunked && length == 0))
+        Done(fr);
+    else if (bchunked)
+        fr.state = HTTP_ST_CHUNK_SIZE;
+    else if (length > 0)
+    {
+        fr.state = HTTP_ST_BODY;
+        fr.left = (u64)length;
+    } // end else if sized
+    else
+    {
+        hs.bclose = true;           // runs till the server closes
+        fr.state = HTTP_ST_LOST;
+    } // end else
+} // end Parse_Head
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs the bytes going one way through its framer
+ *
+ * @param [hs] the stream
+ * @param [fr] the direction
+ * @param [buf] the bytes
+ * @param [len] how many
+ * @param [bresponse] the responses?
+ */
+static void Feed(HTTP_STREAM &hs, HTTP_FRAMER &fr, const char *buf, const size_t len, const bool bresponse)
+{
+    size_t i{0};
+    while (i < len && fr.state != HTTP_ST_LOST)
+    {
+        if (fr.state == HTTP_ST_BODY || fr.state == HTTP_ST_CHUNK_DATA || fr.state == HTTP_ST_CHUNK_END)
+        {
+            size_t n = (size_t)std::min<u64>(fr.left, len - i);
+            fr.left -= n;
+            i += n;
+            if (fr.left == 0)
+                Consumed(fr);
+            continue;
+        } // end if counting
+
+        // the rest go by lines
+        const char *nl = (const char *)memchr(buf + i, '\n', len - i);
+        size_t n = nl ? nl - (buf + i) + 1 : len - i;
+        fr.line.append(buf + i, n);
+        i += n;
+        if (fr.line.size() > HTTP_HEAD_MAX)
+        {
+            fr.state = HTTP_ST_LOST;
+            break;
+        } // end if too long
+
+        if (!nl)
+            break;          // the rest of the line is still to come
+
+        if (fr.state == HTTP_ST_HEAD)
+        {
+            if (fr.line == "\r\n" || fr.line == "\n")
+                fr.line.clear();        // stray line ends between messages
+            else if (Blank_Last(fr.line))
+                Parse_Head(hs, fr, bresponse);
+        } // end if head
+        else if (fr.state == HTTP_ST_CHUNK_SIZE)
+        {
+            char *end;
+            u64 size = strtoull(fr.line.c_str(), &end, 16);
+            if (end == fr.line.c_str())
+            {
+                fr.state = HTTP_ST_LOST;
+                break;
+            } // end if no size
+
+            fr.line.clear();
+            fr.state = size ? HTTP_ST_CHUNK_DATA : HTTP_ST_TRAILER;
+            fr.left = size;
+        } // end else if chunk size
+        else if (Blank_Last(fr.line))
+            Done(fr);               // end of the trailers
+        else
+            fr.line.clear();        // a trailer; no need for it
+    } // end while
+} // end Feed
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Follows what's going to the server
+ *
+ * @param [hs] the stream
+ * @param [buf] the bytes
+ * @param [len] how many
+ */
+void Http_Request(HTTP_STREAM &hs, const char *buf, const size_t len)
+{
+    Feed(hs, hs.req, buf, len, false);
+} // end Http_Request
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Follows what's coming back from the server
+ *
+ * @param [hs] the stream
+ * @param [buf] the bytes
+ * @param [len] how many
+ */
+void Http_Response(HTTP_STREAM &hs, const char *buf, const size_t len)
+{
+    Feed(hs, hs.rsp, buf, len, true);
+} // end Http_Response
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Bytes went to the server without ever being seen (spliced); that's fine as long as they're all body. Any
+ *  other way the requests can't be followed anymore.
+ *
+ * @param [hs] the stream
+ * @param [len] how many
+ */
+void Http_Request_Skip(HTTP_STREAM &hs, const size_t len)
+{
+    HTTP_FRAMER &fr = hs.req;
+    if ((fr.state != HTTP_ST_BODY && fr.state != HTTP_ST_CHUNK_DATA) || fr.left < len)
+    {
+        fr.state = HTTP_ST_LOST;
+        return;
+    } // end if can't tell
+
+    fr.left -= len;
+    if (fr.left == 0)
+        Consumed(fr);
+} // end Http_Request_Skip
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the stream between messages with every request answered and nobody wanting it closed? That's one the
+ *  next client can have.
+ */
+bool Http_Idle(const HTTP_STREAM &hs)
+{
+    return !hs.bclose && hs.qnobody.empty() && hs.req.state == HTTP_ST_HEAD && hs.req.line.empty() &&
+        hs.rsp.state == HTTP_ST_HEAD && hs.rsp.line.empty();
+} // end Http_Idle
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
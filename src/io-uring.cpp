@@ -0,0 +1,988 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  An io_uring backend for the reactor; descriptors get their data delivered by multishot recv into a ring of
+//  registered (provided) buffers and all the sends of an event loop iteration go down in a single system
+//  call. Talks to the kernel directly (no liburing) so there is nothing extra to install.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  16th of October 2026, Friday
+//
+// Last Updated:
+//  16th of October 2026, Friday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "io-uring.h"
+
+#if defined (__linux__)
+#include <linux/io_uring.h>     /* the kernel interface itself */
+#include <sys/mman.h>           /* mmap() for the rings */
+#include <sys/syscall.h>        /* raw system calls */
+#include <signal.h>             /* _NSIG */
+#endif
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+// every SQE carries its own identity as user data: kind (8 bits) | sequence (32 bits) | descriptor (24 bits);
+//  the sequence is bumped each time a descriptor is armed so completions of older arms are easily told apart
+#define UD_POLL         1
+#define UD_RECV         2
+#define UD_SEND         3
+#define UD_CANCEL       4
+
+#define MAKE_UD(k, s, fd)   (((uint64_t)(k) << 56) | ((uint64_t)(s) << 24) | ((uint64_t)(fd) & 0xFFFFFF))
+#define UD_KIND(ud)         ((u32)((ud) >> 56))
+#define UD_FD(ud)           ((int)((ud) & 0xFFFFFF))
+#define UD_SEQ(ud)          ((u32)((ud) >> 24))
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+#if defined (__linux__)
+/**
+ * @brief
+ *  The state of each descriptor as far as the ring is concerned; indexed by descriptor.
+ */
+typedef struct URING_FD_FMT
+{
+    u32 gen{0};             // the reactor's generation for this registration
+    u32 events{0};          // what the reactor wants from it
+    u32 seq{0};             // arm sequence; see user data layout above
+    u32 reg_seq{0};         // the sequence the current registration started at
+    u32 poll_mask{0};       // what the armed poll waits for
+    uint64_t poll_ud{0};    // user data of the armed poll; 0 if none
+    uint64_t recv_ud{0};    // user data of the armed multishot recv; 0 if none
+    bool bregistered{false};// is the reactor still holding on to it?
+    bool brearm{false};     // already queued for arming
+    bool bparked{false};    // already queued for delivery of parked data
+    u32 batch{0};           // the last batch it got a data event in
+    std::string parked;     // received but not yet consumed by the caller
+    size_t parked_off{0};   // how much of parked the caller has consumed already
+} URING_FD, *URING_FD_PTR;
+
+
+
+/**
+ * @brief
+ *  A chunk of received data handed out along an event; lives until the next wait.
+ */
+typedef struct URING_DATA_FMT
+{
+    int fd;                 // the owning descriptor
+    u32 gen;                // its generation at the time of receiving
+    int bid;                // provided buffer id, -1 if the data is parked
+    u32 len;                // bytes in the buffer
+    u32 off;                // bytes consumed so far
+} URING_DATA, *URING_DATA_PTR;
+
+
+
+/**
+ * @brief
+ *  The mapped rings along with the provided buffers
+ */
+typedef struct URING_RING_FMT
+{
+    int fd{-1};                         // the ring descriptor
+    unsigned *sq_head, *sq_tail, *sq_array;
+    unsigned sq_mask, sq_entries;
+    unsigned sq_local_tail;             // tail we've filled up to; published on enter
+    struct io_uring_sqe *sqes;
+    unsigned *cq_head, *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+
+    struct io_uring_buf_ring *pbuf{nullptr};    // the provided buffer ring
+    char *bufs{nullptr};                        // storage behind it
+    size_t buf_size{BUF_SIZE};                  // size of each provided buffer
+    u16 buf_tail{0};                            // our copy of the buffer ring tail
+    bool bmultishot{false};                     // can we do multishot recv at all?
+} URING_RING, *URING_RING_PTR;
+#endif
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static thread_local bool bactive{false};                      // is the backend up and running?
+
+#if defined (__linux__)
+static thread_local URING_RING ring;                          // one ring per reactor thread
+static thread_local std::vector<URING_FD> vfds;               // per descriptor state
+static thread_local std::vector<int> vrearm;                  // descriptors waiting to be armed
+static thread_local std::vector<int> vparked;                 // descriptors with parked data to deliver
+static thread_local std::vector<URING_DATA> vdata;            // data handed out in the current batch
+static thread_local u32 batch{1};                             // numbers the batches handed out
+static thread_local std::vector<struct io_uring_cqe> vstash;  // completions reaped while waiting on sends
+static thread_local URING_SEND_PTR pbatch{nullptr};          // the sends of the batch being submitted
+static thread_local unsigned inflight{0};                     // sends submitted but not yet completed
+#endif
+
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+#if defined (__linux__)
+/**
+ * @brief
+ *  Returns the state of a descriptor; grows the table as needed
+ */
+static URING_FD_PTR Fd_State(const int fd)
+{
+    if ((size_t)fd >= vfds.size())
+        vfds.resize(fd + 64);
+
+    return &vfds[fd];
+} // end Fd_State
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Calls io_uring_enter(); waits with a timeout in milli-seconds when asked to get events.
+ */
+static int Enter(const unsigned to_submit, const unsigned min_complete, unsigned flags, const int timeout)
+{
+    if ((flags & IORING_ENTER_GETEVENTS) && timeout >= 0)
+    {
+        struct __kernel_timespec ts;
+        struct io_uring_getevents_arg arg;
+
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = (uint64_t)&ts;
+
+        return (int)syscall(__NR_io_uring_enter, ring.fd, to_submit, min_complete, flags | IORING_ENTER_EXT_ARG,
+            &arg, sizeof(arg));
+    } // end if timed
+
+    return (int)syscall(__NR_io_uring_enter, ring.fd, to_submit, min_complete, flags, NULL, 0);
+} // end Enter
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Publishes the filled SQE's and tells how many the kernel is yet to consume
+ */
+static unsigned Publish()
+{
+    __atomic_store_n(ring.sq_tail, ring.sq_local_tail, __ATOMIC_RELEASE);
+    return ring.sq_local_tail - __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE);
+} // end Publish
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Submits whatever's queued without waiting on anything
+ */
+static void Submit()
+{
+    unsigned pending = Publish();
+    while (pending > 0)
+    {
+        if (Enter(pending, 0, 0, -1) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            perror("io_uring_enter()");
+            return;
+        } // end if
+
+        pending = Publish();
+    } // end while
+} // end Submit
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gets the next free SQE (zeroed); submits what's queued if the ring is full
+ */
+static struct io_uring_sqe *Get_Sqe()
+{
+    if (ring.sq_local_tail - __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE) >= ring.sq_entries)
+        Submit();
+
+    unsigned index = ring.sq_local_tail & ring.sq_mask;
+    struct io_uring_sqe *sqe = &ring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring.sq_array[index] = index;
+    ring.sq_local_tail++;
+
+    return sqe;
+} // end Get_Sqe
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Pops the next completion if there's one
+ */
+static bool Next_Cqe(struct io_uring_cqe &cqe)
+{
+    unsigned head = *ring.cq_head;
+    if (head == __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE))
+        return false;
+
+    cqe = ring.cqes[head & ring.cq_mask];
+    __atomic_store_n(ring.cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+} // end Next_Cqe
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands a provided buffer back to the kernel
+ */
+static void Recycle(const int bid)
+{
+    // the ring is indexed as a plain array; in C++ the kernel header's flexible array member sits behind an
+    //  empty struct that takes up a byte, which throws ->bufs off by eight
+    struct io_uring_buf *pb = (struct io_uring_buf *)ring.pbuf + (ring.buf_tail & (URING_BUFFERS - 1));
+    pb->addr = (uint64_t)(ring.bufs + (size_t)bid * ring.buf_size);
+    pb->len = (u32)ring.buf_size;
+    pb->bid = (u16)bid;
+
+    ring.buf_tail++;
+    __atomic_store_n(&ring.pbuf->tail, ring.buf_tail, __ATOMIC_RELEASE);
+} // end Recycle
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a cancel for an armed request
+ */
+static void Cancel(const uint64_t ud)
+{
+    struct io_uring_sqe *sqe = Get_Sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = ud;
+    sqe->user_data = MAKE_UD(UD_CANCEL, 0, 0);
+} // end Cancel
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the descriptor to be fed by multishot recv or just polled for readiness?
+ */
+static inline bool Wants_Recv(const u32 events)
+{
+    return ring.bmultishot && (events & EV_RECV) && (events & EV_READ);
+} // end Wants_Recv
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  What the readiness poll for the given interest should be waiting on
+ */
+static inline u32 Poll_Mask(const u32 events)
+{
+    u32 mask = events & (EV_READ | EV_WRITE);
+    if (Wants_Recv(events))
+        mask &= ~EV_READ;
+
+    return mask;
+} // end Poll_Mask
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues the descriptor for (re)arming on the next wait
+ */
+static void Queue_Rearm(const int fd, URING_FD_PTR pfd)
+{
+    if (!pfd->brearm)
+    {
+        pfd->brearm = true;
+        vrearm.push_back(fd);
+    } // end if
+} // end Queue_Rearm
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Bytes parked on the descriptor that are yet to be consumed
+ */
+static inline size_t Parked(const URING_FD_PTR pfd)
+{
+    return pfd->parked.size() - pfd->parked_off;
+} // end Parked
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Drops whatever is parked on the descriptor
+ */
+static void Clear_Parked(URING_FD_PTR pfd)
+{
+    pfd->parked.clear();
+    pfd->parked_off = 0;
+} // end Clear_Parked
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues the descriptor for delivery of its parked data
+ */
+static void Queue_Parked(const int fd, URING_FD_PTR pfd)
+{
+    if (!pfd->bparked)
+    {
+        pfd->bparked = true;
+        vparked.push_back(fd);
+    } // end if
+} // end Queue_Parked
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Arms everything that's queued for arming; polls are single shot so that we keep level triggered semantics
+ *  (a descriptor left with unread data is reported again), recv's are multishot.
+ */
+static void Arm_Pending()
+{
+    for (int fd : vrearm)
+    {
+        URING_FD_PTR pfd = &vfds[fd];
+        pfd->brearm = false;
+
+        if (Wants_Recv(pfd->events) && !pfd->recv_ud && Parked(pfd) < URING_PARK_MAX)
+        {
+            struct io_uring_sqe *sqe = Get_Sqe();
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = fd;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = 0;
+            sqe->user_data = pfd->recv_ud = MAKE_UD(UD_RECV, ++pfd->seq, fd);
+        } // end if recv
+
+        u32 mask = Poll_Mask(pfd->events);
+        if (mask && !pfd->poll_ud)
+        {
+            struct io_uring_sqe *sqe = Get_Sqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = fd;
+            sqe->poll32_events = mask;
+            sqe->user_data = pfd->poll_ud = MAKE_UD(UD_POLL, ++pfd->seq, fd);
+            pfd->poll_mask = mask;
+        } // end if poll
+    } // end for
+
+    vrearm.clear();
+} // end Arm_Pending
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Turns a completion into an event (if it makes one)
+ *
+ * @return true
+ *  if an event got stored at pev
+ */
+static bool Process_Cqe(const struct io_uring_cqe &cqe, REACTOR_EVENT_PTR pev)
+{
+    int fd = UD_FD(cqe.user_data);
+    u32 kind = UD_KIND(cqe.user_data);
+
+    if (kind == UD_SEND)
+    {
+        pbatch[fd].res = cqe.res;       // the descriptor bits hold the index in the batch
+        inflight--;
+        return false;
+    } // end if send
+
+    if (kind != UD_POLL && kind != UD_RECV)
+        return false;
+
+    URING_FD_PTR pfd = Fd_State(fd);
+    if (kind == UD_POLL)
+    {
+        if (cqe.user_data != pfd->poll_ud)
+            return false;           // an old arm; cancelled or replaced
+
+        pfd->poll_ud = 0;
+        Queue_Rearm(fd, pfd);
+        if (cqe.res == -ECANCELED)
+            return false;
+
+        pev->fd = fd;
+        pev->revents = cqe.res < 0 ? EV_ERROR : (u32)cqe.res;
+        pev->gen = pfd->gen;
+        pev->ibuf = -1;
+        return true;
+    } // end if poll
+
+    int bid = (cqe.flags & IORING_CQE_F_BUFFER) ? (int)(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+    if (cqe.user_data != pfd->recv_ud)
+    {
+        // a recv cancelled on a pause may still have had data on its way; that's still the caller's as long 
+        //  as the descriptor hasn't been let go of since
+        if (bid >= 0 && cqe.res > 0 && pfd->bregistered && (s32)(UD_SEQ(cqe.user_data) - pfd->reg_seq) > 0)
+        {
+            pfd->parked.append(ring.bufs + (size_t)bid * ring.buf_size, cqe.res);
+            Queue_Parked(fd, pfd);
+        } // end if still ours
+
+        if (bid >= 0)
+            Recycle(bid);
+        return false;
+    } // end if stale
+
+    if (!(cqe.flags & IORING_CQE_F_MORE))
+    {
+        pfd->recv_ud = 0;
+        Queue_Rearm(fd, pfd);
+    } // end if no more
+
+    if (cqe.res == -EINVAL)
+    {
+        // an older kernel without multishot recv; readiness will have to do
+        ring.bmultishot = false;
+        return false;
+    } // end if
+
+    if (cqe.res == -ENOBUFS || cqe.res == -ECANCELED)
+        return false;
+
+    pev->fd = fd;
+    pev->gen = pfd->gen;
+    pev->ibuf = -1;
+    if (cqe.res < 0)
+    {
+        pev->revents = EV_ERROR;
+        return true;
+    } // end if error
+
+    pev->revents = EV_READ;
+    if (cqe.res == 0 || bid < 0)
+    {
+        // end of file; left to the plain recv() to find out, but never ahead of parked data
+        return Parked(pfd) == 0;
+    } // end if
+
+    if (Parked(pfd) || pfd->batch == batch)
+    {
+        // keep the order; behind what's already waiting. A descriptor gets one data event per batch like it
+        //  would with epoll; the callers count on that (e.g. a context set on the first is seen by the next)
+        pfd->parked.append(ring.bufs + (size_t)bid * ring.buf_size, cqe.res);
+        Recycle(bid);
+        Queue_Parked(fd, pfd);
+
+        if (Parked(pfd) >= URING_PARK_MAX && pfd->recv_ud)
+        {
+            // the caller is falling behind; the socket's own buffer fills up (and TCP pushes back) till it
+            //  catches up (see Uring_Recv)
+            Cancel(pfd->recv_ud);
+            pfd->recv_ud = 0;
+        } // end if too much
+        return false;
+    } // end if parked
+
+    pfd->batch = batch;
+    vdata.push_back({fd, pfd->gen, bid, (u32)cqe.res, 0});
+    pev->ibuf = (s32)vdata.size() - 1;
+    return true;
+} // end Process_Cqe
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gathers events out of parked data, stashed and fresh completions
+ *
+ * @return int
+ *  number of events collected
+ */
+static int Collect(REACTOR_EVENT_PTR pevents, const int max_events)
+{
+    int n{0};
+
+    // parked data first; it's older than anything else for the same descriptor
+    size_t i{0};
+    for (; i < vparked.size() && n < max_events; i++)
+    {
+        URING_FD_PTR pfd = &vfds[vparked[i]];
+        pfd->bparked = false;
+        if (!Parked(pfd))
+            continue;
+
+        if (!(pfd->events & EV_READ))
+            continue;       // paused; Uring_Arm re-queues it once it's back
+
+        vdata.push_back({vparked[i], pfd->gen, -1, (u32)std::min(Parked(pfd), (size_t)UINT32_MAX), 0});
+        pevents[n].fd = vparked[i];
+        pevents[n].revents = EV_READ;
+        pevents[n].gen = pfd->gen;
+        pevents[n].ibuf = (s32)vdata.size() - 1;
+        n++;
+    } // end for
+    vparked.erase(vparked.begin(), vparked.begin() + i);
+
+    for (i = 0; i < vstash.size() && n < max_events; i++)
+    {
+        if (Process_Cqe(vstash[i], &pevents[n]))
+            n++;
+    } // end for
+    vstash.erase(vstash.begin(), vstash.begin() + i);
+
+    struct io_uring_cqe cqe;
+    while (n < max_events && Next_Cqe(cqe))
+    {
+        if (Process_Cqe(cqe, &pevents[n]))
+            n++;
+    } // end while
+
+    return n;
+} // end Collect
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Whatever the caller didn't consume out of the last batch gets parked, and the buffers go back to the kernel
+ */
+static void Finalize_Batch()
+{
+    for (auto &d : vdata)
+    {
+        if (d.bid < 0)
+            continue;
+
+        URING_FD_PTR pfd = &vfds[d.fd];
+        if (d.off < d.len && pfd->gen == d.gen && pfd->bregistered)
+        {
+            // ahead of whatever came in after it during the batch; into the consumed room if it fits
+            const char *left = ring.bufs + (size_t)d.bid * ring.buf_size + d.off;
+            size_t len = d.len - d.off;
+            if (pfd->parked_off >= len)
+            {
+                pfd->parked_off -= len;
+                memcpy(&pfd->parked[pfd->parked_off], left, len);
+            } // end if room
+            else
+            {
+                pfd->parked.erase(0, pfd->parked_off);
+                pfd->parked_off = 0;
+                pfd->parked.insert(0, left, len);
+            } // end else
+            Queue_Parked(d.fd, pfd);
+        } // end if left overs
+
+        Recycle(d.bid);
+    } // end for
+
+    vdata.clear();
+    batch++;
+} // end Finalize_Batch
+#endif
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets up the ring, maps it in and registers the provided buffers for multishot recv
+ *
+ * @param [buf_size] the size of each provided buffer (usually the -bs buffer size)
+ *
+ * @return true
+ *  if the backend is up, false if the kernel doesn't have what we need (caller falls back)
+ */
+bool Uring_Init(const size_t buf_size)
+{
+#if defined (__linux__)
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_COOP_TASKRUN;
+
+    if ( (ring.fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params)) < 0)
+    {
+        // older kernels don't know about cooperative task running
+        memset(&params, 0, sizeof(params));
+        if ( (ring.fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params)) < 0)
+        {
+            perror("io_uring_setup()");
+            return false;
+        } // end if
+    } // end if
+
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP) ||
+        !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        fprintf(stderr, "io_uring: kernel is too old for us.\n");
+        close(ring.fd);
+        return false;
+    } // end if features
+
+    size_t sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ring_len = std::max(sq_len, cq_len);
+
+    char *pring = (char *)mmap(0, ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd,
+        IORING_OFF_SQ_RING);
+    ring.sqes = (struct io_uring_sqe *)mmap(0, params.sq_entries * sizeof(struct io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (pring == MAP_FAILED || ring.sqes == MAP_FAILED)
+    {
+        perror("io_uring mmap()");
+        close(ring.fd);
+        return false;
+    } // end if
+
+    ring.sq_head = (unsigned *)(pring + params.sq_off.head);
+    ring.sq_tail = (unsigned *)(pring + params.sq_off.tail);
+    ring.sq_mask = *(unsigned *)(pring + params.sq_off.ring_mask);
+    ring.sq_entries = *(unsigned *)(pring + params.sq_off.ring_entries);
+    ring.sq_array = (unsigned *)(pring + params.sq_off.array);
+    ring.sq_local_tail = *ring.sq_tail;
+    ring.cq_head = (unsigned *)(pring + params.cq_off.head);
+    ring.cq_tail = (unsigned *)(pring + params.cq_off.tail);
+    ring.cq_mask = *(unsigned *)(pring + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(pring + params.cq_off.cqes);
+
+    // make sure the operations we depend on are there
+    size_t probe_len = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, probe_len);
+    bool bops = probe && syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_PROBE, probe, 256) >= 0;
+    for (u8 op : {IORING_OP_POLL_ADD, IORING_OP_SEND, IORING_OP_RECV, IORING_OP_ASYNC_CANCEL})
+        bops = bops && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+
+    free(probe);
+    if (!bops)
+    {
+        fprintf(stderr, "io_uring: missing operations.\n");
+        close(ring.fd);
+        return false;
+    } // end if
+
+    // the provided buffers for multishot recv; without them we only poll for readiness
+    ring.buf_size = buf_size;
+    size_t pbuf_len = URING_BUFFERS * sizeof(struct io_uring_buf);
+    ring.pbuf = (struct io_uring_buf_ring *)mmap(0, pbuf_len, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ring.bufs = (char *)malloc(URING_BUFFERS * buf_size);
+
+    if (ring.pbuf != MAP_FAILED && ring.bufs)
+    {
+        // touch the ring before the kernel pins it; an untouched anonymous page is only the shared zero page
+        memset(ring.pbuf, 0, pbuf_len);
+
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = (uint64_t)ring.pbuf;
+        reg.ring_entries = URING_BUFFERS;
+        reg.bgid = 0;
+
+        if (syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) >= 0)
+        {
+            ring.bmultishot = true;
+            for (int i = 0; i < URING_BUFFERS; i++)
+                Recycle(i);
+        } // end if registered
+    } // end if buffers
+
+    if (!ring.bmultishot)
+        fprintf(stderr, "io_uring: no provided buffers, using readiness only.\n");
+
+    bactive = true;
+    return true;
+#else
+    return false;
+#endif
+} // end Uring_Init
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if io_uring is what's running the show
+ */
+bool Uring_Active()
+{
+    return bactive;
+} // end Uring_Active
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  (Re)arms a descriptor for the given interest; anything armed that no longer fits gets cancelled.
+ *
+ * @param [fd] the descriptor
+ * @param [gen] the reactor's generation of its registration
+ * @param [events] the interest; EV_READ, EV_WRITE and EV_RECV for data delivery
+ */
+void Uring_Arm(const int fd, const u32 gen, const u32 events)
+{
+#if defined (__linux__)
+    URING_FD_PTR pfd = Fd_State(fd);
+    if (pfd->gen != gen)
+    {
+        Clear_Parked(pfd);
+        pfd->gen = gen;
+    } // end if new registration
+
+    pfd->bregistered = true;
+    pfd->events = events;
+    if (pfd->recv_ud && !Wants_Recv(events))
+    {
+        Cancel(pfd->recv_ud);
+        pfd->recv_ud = 0;
+    } // end if recv no longer wanted
+
+    if (pfd->poll_ud && pfd->poll_mask != Poll_Mask(events))
+    {
+        Cancel(pfd->poll_ud);
+        pfd->poll_ud = 0;
+    } // end if poll no longer right
+
+    if (events)
+        Queue_Rearm(fd, pfd);
+
+    if ((events & EV_READ) && Parked(pfd))
+        Queue_Parked(fd, pfd);
+#endif
+} // end Uring_Arm
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Cancels anything armed on the descriptor; called as the descriptor is being removed
+ *
+ * @param [fd] the descriptor
+ */
+void Uring_Disarm(const int fd)
+{
+#if defined (__linux__)
+    URING_FD_PTR pfd = Fd_State(fd);
+    if (pfd->recv_ud)
+        Cancel(pfd->recv_ud);
+    if (pfd->poll_ud)
+        Cancel(pfd->poll_ud);
+
+    pfd->recv_ud = pfd->poll_ud = 0;
+    pfd->bregistered = false;
+    pfd->events = 0;
+    pfd->reg_seq = ++pfd->seq;
+    Clear_Parked(pfd);
+#endif
+} // end Uring_Disarm
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Arms what needs arming and waits for events all in as few system calls as we can.
+ *
+ * @param [pevents] storage for events
+ * @param [max_events] capacity of the above
+ * @param [timeout] in milli-seconds; -1 waits forever
+ *
+ * @return int
+ *  number of events, 0 on timeout and -1 on error
+ */
+int Uring_Wait(REACTOR_EVENT_PTR pevents, const int max_events, const int timeout)
+{
+#if defined (__linux__)
+    Finalize_Batch();
+    Arm_Pending();
+
+    int n = Collect(pevents, max_events);
+    if (n > 0 || timeout == 0)
+    {
+        Submit();
+        return n;
+    } // end if got some
+
+    while (true)
+    {
+        // nothing came out of collecting (e.g. a multishot that ran dry), so whatever that queued up for
+        //  re-arming must go in before we wait; otherwise the descriptor is never heard of again
+        Arm_Pending();
+        if (Enter(Publish(), 1, IORING_ENTER_GETEVENTS, timeout) < 0)
+        {
+            if (errno == ETIME || errno == EINTR)
+                return Collect(pevents, max_events);
+            if (errno != EAGAIN && errno != EBUSY)
+                return -1;
+        } // end if
+
+        // re-arming waits for the next call, once the caller is done with these events; otherwise a single shot
+        //  poll goes right back in and reports the very readiness the caller is about to consume
+        n = Collect(pevents, max_events);
+        if (n > 0 || timeout >= 0)
+        {
+            Submit();
+            return n;
+        } // end if
+    } // end while
+#else
+    return -1;
+#endif
+} // end Uring_Wait
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the data delivered along an event (without a system call); events that carry no data are read off
+ *  the socket like always.
+ *
+ * @param [ev] the event
+ * @param [buf] where to copy the data
+ * @param [buf_len] capacity of the buffer
+ *
+ * @return int
+ *  bytes read, 0 on end of file and -1 on error
+ */
+int Uring_Recv(const REACTOR_EVENT &ev, char *buf, const size_t buf_len)
+{
+#if defined (__linux__)
+    if (ev.ibuf < 0 || (size_t)ev.ibuf >= vdata.size())
+        return (int)recv(ev.fd, buf, buf_len, 0);
+
+    URING_DATA_PTR pd = &vdata[ev.ibuf];
+    if (pd->bid < 0)
+    {
+        // parked data
+        URING_FD_PTR pfd = &vfds[ev.fd];
+        size_t n = std::min(buf_len, Parked(pfd));
+        if (n == 0)
+        {
+            errno = EAGAIN;
+            return -1;
+        } // end if nothing
+
+        memcpy(buf, pfd->parked.data() + pfd->parked_off, n);
+        pfd->parked_off += n;
+        if (!pfd->recv_ud && Wants_Recv(pfd->events) && Parked(pfd) < URING_PARK_MAX / 2)
+            Queue_Rearm(ev.fd, pfd);        // caught up enough to take more
+        if (!Parked(pfd))
+            Clear_Parked(pfd);
+        else if (pfd->parked_off >= pfd->parked.size() / 2 && pfd->parked_off >= (1 << 16))
+        {
+            // consumed from the front; every so often the rest moves up
+            pfd->parked.erase(0, pfd->parked_off);
+            pfd->parked_off = 0;
+            Queue_Parked(ev.fd, pfd);
+        } // end else if half gone
+        else
+            Queue_Parked(ev.fd, pfd);
+        return (int)n;
+    } // end if parked
+
+    size_t n = std::min(buf_len, (size_t)(pd->len - pd->off));
+    memcpy(buf, ring.bufs + (size_t)pd->bid * ring.buf_size + pd->off, n);
+    pd->off += n;
+    return (int)n;
+#else
+    return (int)recv(ev.fd, buf, buf_len, 0);
+#endif
+} // end Uring_Recv
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sends a batch of buffers in one submission and waits for all of them to complete. The sends never block
+ *  (MSG_DONTWAIT), so each tells how much of it the socket took; the caller keeps the rest queued up.
+ *  Nothing links the sends (no IOSQE_IO_LINK); they're in order only because there's never more than one to a
+ *  descriptor in a batch, which is Flush_Dirty's to keep: it coalesces all that's queued for one into a single
+ *  send. Two to the same descriptor here could go out either way round.
+ *
+ * @param [psends] the sends, at most one a descriptor; res is filled with the bytes sent or a negated errno
+ * @param [count] number of sends
+ */
+void Uring_Send_Batch(URING_SEND_PTR psends, const size_t count)
+{
+#if defined (__linux__)
+    pbatch = psends;
+
+    size_t i{0};
+    while (i < count)
+    {
+        // one chunk at a time, whatever fits in the submission queue
+        size_t room = ring.sq_entries - (ring.sq_local_tail - __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE));
+        if (room == 0)
+        {
+            Submit();
+            continue;
+        } // end if full
+
+        size_t end = std::min(count, i + room);
+        for (; i < end; i++)
+        {
+            struct io_uring_sqe *sqe = Get_Sqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = psends[i].fd;
+            sqe->addr = (uint64_t)psends[i].buf;
+            sqe->len = (u32)std::min(psends[i].len, (size_t)INT32_MAX);
+            sqe->msg_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+            sqe->user_data = MAKE_UD(UD_SEND, 0, i);
+            psends[i].res = -ECANCELED;
+
+            inflight++;
+        } // end for
+
+        while (inflight > 0)
+        {
+            if (Enter(Publish(), inflight, IORING_ENTER_GETEVENTS, -1) < 0 && errno != EINTR &&
+                errno != EAGAIN && errno != EBUSY)
+            {
+                perror("io_uring_enter()");
+                break;
+            } // end if
+
+            struct io_uring_cqe cqe;
+            while (Next_Cqe(cqe))
+            {
+                if (UD_KIND(cqe.user_data) == UD_SEND)
+                    Process_Cqe(cqe, nullptr);
+                else if (UD_KIND(cqe.user_data) != UD_CANCEL)
+                    vstash.push_back(cqe);      // not ours to handle now
+            } // end while
+        } // end while
+    } // end while
+
+    inflight = 0;
+    pbatch = nullptr;
+#endif
+} // end Uring_Send_Batch
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
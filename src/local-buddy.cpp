@@ -21,7 +21,7 @@
 //  19th of March 2023, Sunday
 //
 // Last Updated:
-//  6th of April 2023, Thursday
+//  17th of October 2026, Saturday
 //
 //==============================================================================================================|
 
@@ -31,6 +31,11 @@
 // INCLUDES
 //==============================================================================================================|
 #include "utils.h"
+#include "http-framer.h"
+#include "stream-table.h"
+#include "route-index.h"
+#include "tunnel-tls.h"
+#include <random>
 
 
 
@@ -41,13 +46,39 @@
 
 
 
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+// a stream to a RESTServer; the HTTP going over it is followed so it can be kept alive for the next client
+typedef struct REST_STREAM_FMT
+{
+    UPSTREAM_POOL_PTR ppool;    // where it goes back to (nullptr if nowhere)
+    HTTP_STREAM http;           // the requests and responses on it
+} REST_STREAM, *REST_STREAM_PTR;
+
+
+// a remote-buddy link still in its TLS handshake; it's kept out of routing till it's through
+typedef struct TLS_WAIT_FMT
+{
+    void *pssl;                 // the handshake so far (see Tls_Accept_Step)
+    u64 deadline;               // when we give up on it (Now_Ms() based)
+} TLS_WAIT, *TLS_WAIT_PTR;
+
+
+
+
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
 int listen_fd{-1};
 u16 listen_port{7777};
 std::unordered_map<int, CONNECTION_INFO> remote_fd;     // map of server ip:port addresses to remote-buddy descriptor
-std::unordered_map<int,std::string> fdip;               // map of fd to ip descriptor
+std::vector<u32> fdip;                                  // the address each descriptor came from (network order),
+                                                        //  indexed by it; 0 if it's not known
+std::vector<bool> fdtls;                                // and whether it's been through the TLS handshake
+std::unordered_map<int, CONNECT_WAIT> mconnecting;      // RESTServer connects still on their way
+std::unordered_map<int, TLS_WAIT> maccepting;           // remote-buddy links still in their TLS handshake
+std::unordered_map<int, REST_STREAM> mrest;             // RESTServer streams (SF_HTTP)
 
 bool bsend_close{true};     // direction of close
 
@@ -58,11 +89,33 @@ bool bsend_close{true};     // direction of close
 // PROTOTYPES
 //==============================================================================================================|
 void Init(const int argc, char **argv);
-void Dump(const char *msg, ...);
-void New_Remote(const int fd, const char *buf);
+void New_Remote(const int fd, const char *buf, const size_t len);
+void Join_Remote(const int fd, const char *buf, const size_t len);
+void Resume_Remote(const int fd, const char *buf, const size_t len);
+CONNECTION_INFO_PTR Find_Session(const u64 session);
+void Tunnel_Frames(CONNECTION_INFO_PTR pci, const int fd);
+void Tunnel_Frame(CONNECTION_INFO_PTR pci, const int fd, INTAP_FMT &intap, const char *buf, const int bytes);
 void New_Db(const int fd, const char *buf, const size_t len);
+int Paired_Fd(CONNECTION_INFO_PTR pci, const INTAP_FMT &intap);
+int Splice_Echo(CONNECTION_INFO_PTR pci, const int fd, const INTAP_FMT &intap);
+bool Keep_Alive(const int fd);
+void Upstream_Send(STREAM_PTR ps, const int fd, const char *buf, const size_t len);
+void Grant_Credit(CONNECTION_INFO_PTR pci, STREAM_PTR ps, const int fd, const size_t bytes);
+void Finish_Connect(const int fd);
+void Expire_Connects();
+void On_Congestion(const int fd, const bool bcongested);
+void Lose_Link(CONNECTION_INFO_PTR pci, const int fd);
+void Expire_Sessions();
+int Resume_Wait_Ms(int timeout);
 void Close_Sockets();
+void Forget_Stream(const int fd);
+bool Tls_Done(const int fd);
+void Tls_Step(const int fd);
+void Expire_Handshakes();
+int Tls_Wait_Ms(int timeout);
+void Kill_Remote(CONNECTION_INFO_PTR pci);
 void Kill_Sock(const int fd);
+void Remote_Metrics(std::string &out);
 
 
 
@@ -102,46 +155,73 @@ int main(int argc, char *argv[])
     Bind(listen_fd, listen_port);
     Listen(listen_fd, backlog);
 
-    memset(&fdpoll, 0, sizeof(fdpoll));
-    fdpoll.fd = listen_fd;
-    fdpoll.events = POLLIN;
-    vpoll.push_back(fdpoll);        // now add to the list of 'we'd wanna wait on descriptors'
+    if (lz_min > 0)
+        Lz_Init(lz_threads);
+
+    Reactor_Init(io_backend, buffer_size);
+    Reactor_On_Congestion(On_Congestion);
+    Reactor_Add(listen_fd, EV_READ);    // now add to the list of 'we'd wanna wait on descriptors'
+    if (metrics_port > 0 && Metrics_Listen(metrics_port, Remote_Metrics))
+        Dump("serving metrics on 127.0.0.1:%d", metrics_port);
 
     /* we don't really wanna stop, till the ends of time if possible ... */
+    REACTOR_EVENT events[MAX_EVENTS];
     while (1)
     {
         Dump("waiting for ready sockets ..");
-        if ( POLL(vpoll.data(), vpoll.size()) <= 0 )
+        int nready = Reactor_Wait(events, MAX_EVENTS, 
+            Tls_Wait_Ms(Resume_Wait_Ms(Pool_Wait_Ms(Connect_Wait_Ms(mconnecting)))));
+        if (nready < 0)
         {
-            perror("poll()");
+            perror("Reactor_Wait()");
             break;
         } // end if poll error
 
+        Expire_Connects();
+        Expire_Handshakes();
+        Expire_Sessions();
+        Pool_Tick();
 
         // print descriptors
         if (debug_mode & DEBUG_L2)
         {
-            Dump("sockets =");
-            for (auto &x : vpoll)
-                printf("%d, ", x.fd);
-            printf("\n");
+            std::string ready;
+            for (int i = 0; i < nready; i++)
+                ready += std::to_string(events[i].fd) + ", ";
+            Dump("ready sockets = %s", ready.c_str());
         } // end if print descriptors 
             
-        // a descriptor is ready, but which one?
-        //  make copies to make life easy for our descriptors
-        std::vector<struct pollfd> tempfd{vpoll};
-        for (size_t i = 0; i < tempfd.size(); i++)
+        // a descriptor is ready, but which one? the reactor only hands us the ready ones along with
+        //  whatever context we stored on them; events for sockets killed along the way are stale.
+        for (int i = 0; i < nready; i++)
         {
-            if (tempfd[i].revents == 0)
+            if (Reactor_Stale(events[i]) || Pool_Event(events[i]) || Metrics_Event(events[i]))
                 continue;
+
+            // the streams are found by descriptor; the remote-buddy links alone carry a context
+            STREAM_PTR ps = Stream_Get(events[i].fd);
+            if (ps && ps->state == STREAM_CONNECTING)
+            {
+                Finish_Connect(events[i].fd);
+                continue;
+            } // end if connect done
+
+            if (maccepting.count(events[i].fd))
+            {
+                Tls_Step(events[i].fd);
+                continue;
+            } // end if handshake on
             
-            if (!(tempfd[i].revents & POLLIN))
+            if (!(events[i].revents & EV_READ))
             {
-                Kill_Sock(tempfd[i].fd);
+                if (events[i].ctx)
+                    Lose_Link((CONNECTION_INFO_PTR)events[i].ctx, events[i].fd);
+                else
+                    Kill_Sock(events[i].fd);
                 continue;
             } // end if
 
-            if (tempfd[i].fd == listen_fd)
+            if (events[i].fd == listen_fd)
             {
                 char addr_str[INET_ADDRSTRLEN];
                 u16 port;
@@ -149,12 +229,20 @@ int main(int argc, char *argv[])
                 if (nfd <= 0)
                     continue;
                 
-                fdip.emplace(nfd, addr_str);
+                if ((size_t)nfd >= fdip.size())
+                {
+                    fdip.resize(nfd + 1024);
+                    fdtls.resize(nfd + 1024);
+                } // end if growing
+                if (inet_pton(AF_INET, addr_str, &fdip[nfd]) != 1)
+                    fdip[nfd] = 0;
+                fdtls[nfd] = false;
                 Dump("connection request from host @ (%s:%d)", addr_str, port);
             } // end if listening
             else 
             {
-                int fd = tempfd[i].fd;
+                int fd = events[i].fd;
+                CONNECTION_INFO_PTR pci = (CONNECTION_INFO_PTR)events[i].ctx;
 
                 // here are the possiblites that go down as far as routing is concerned
                 //  1. ADO.NET based database requests are coming from RESTServer (new or old)
@@ -162,77 +250,21 @@ int main(int argc, char *argv[])
                 //  3. remote-buddy is responding to ADO.NET db requests
                 //  4. RESTServer is responding to client requests
 
-                // check remote-buddy descriptors first
-                auto it = remote_fd.find(fd);
-                if (it != remote_fd.end())
+                // check remote-buddy descriptors first; these carry their own info as context
+                if (pci)
                 {
-                    INTAP_FMT intap;
-                    int bytes = Recv(fd, (char*)&intap, sizeof(intap));
-                    if (bytes <= 0)
+                    // take in all there is and deal with every frame that's whole; the rest waits for more
+                    int bytes = Intap_Fill(fd, pci->mrx[fd]);
+                    if (bytes < 0)
                     {
-                        Kill_Sock(fd);
+                        Lose_Link(pci, fd);
                         continue;
                     } // end bytes
 
-                    // now get the actual info we need
-                    if ( (bytes = Recv(fd, buffer, NTOHL(intap.buf_len))) <=  0)
-                    {
-                        Kill_Sock(fd);
-                        continue;
-                    } // end if
-                    
                     if (debug_mode & DEBUG_L3)
-                    {
-                        Dump("got %d bytes from \033[32mremote-buddy\033[37m on socket %d.\n",
-                             bytes + sizeof(intap), fd);
-                        Dump_Hex((char*)&intap, sizeof(intap));
-                        Dump_Hex(buffer, bytes);
-                    } // end if debug_mode
+                        Dump("got %d bytes from \033[32mremote-buddy\033[37m on socket %d", bytes, fd);
 
-                    // this is from a remote-buddy descriptor; remote-buddy always responds with
-                    //  an appended custom protocol info, let's parse that.
-                    if (!strncmp(intap.signature, "INTAP11", 8))
-                    {
-                        // this is from our remote side;
-                        int id = NTOHS(intap.id);
-                        switch (id)
-                        {
-                            case CMD_BYEBYE:    // socket sent FIN
-                                bsend_close = false;
-                                Kill_Sock(NTOHS(intap.dest_fd));
-                                break;
-
-                            case CMD_ECHO:  // just echoing on existing
-                            {
-                                int lfd = NTOHS(intap.dest_fd);
-                                int rfd = NTOHS(intap.src_fd);
-                                Send(lfd, buffer, bytes);
-
-                                if (remote_fd[fd].mfds[lfd] == -1)
-                                    remote_fd[fd].mfds[lfd] = rfd;
-                            } break;
-
-                            case CMD_CLI_CONNECT:   // new client connection
-                            {
-                                intap.port = NTOHS(intap.port);
-                                Dump("connecting with RESTful server at %s:%d ..", intap.ip, intap.port);
-                                int nfd = Socket();
-                                Connect(nfd, intap.ip, intap.port);
-                                Dump("connected to RESTful server at %s:%d", intap.ip, intap.port);
-
-                                Send(nfd, buffer, bytes);
-                                memset(&fdpoll, 0, sizeof(fdpoll));
-                                fdpoll.fd = nfd;
-                                fdpoll.events = POLLIN;
-                                vpoll.push_back(fdpoll);
-                                remote_fd[fd].mfds[nfd] = NTOHS(intap.src_fd);
-                            } break;
-                        } // end switch
-                    } // end if intap
-                    else
-                    {
-                        fprintf(stderr, "\033[31m> local-buddy:\033[37m no hablo comprende, error de protocolo!\n");
-                    } // end else unkown protocol
+                    Tunnel_Frames(pci, fd);
                 } // end if remote
                 else
                 {
@@ -240,50 +272,99 @@ int main(int argc, char *argv[])
                     //  or we didn't. If nothing new then, we're sure to have mapped all the info we
                     //  need at this point. These could be requests from existing db connection
                     //  or responses from RESTServer (in which case descriptor is already connected)
+
+                    if (ps)
+                        pci = (CONNECTION_INFO_PTR)ps->ppeer;
+                    else if (Tls_Active() && !Tls_Done(fd))
+                    {
+                        // a remote-buddy's link starts with the handshake; its hello comes after it, by way of 
+                        //  the kernel
+                        char lead;
+                        if (recv(fd, &lead, 1, MSG_PEEK) == 1 && lead == TLS_RECORD_HANDSHAKE)
+                        {
+                            maccepting[fd] = {nullptr, Now_Ms() + TLS_HANDSHAKE_SECS * 1000};
+                            Tls_Step(fd);
+                            continue;
+                        } // end if handshake
+                    } // end else if new
+
+                    if (pci && Send_Congested(Stream_Link(pci, fd)))
+                    {
+                        // the remote-buddy is backed up; this one waits till it drains (see On_Congestion)
+                        Reactor_Mod(fd, 0);
+                        if (!(ps->flags & SF_PAUSED))
+                        {
+                            ps->flags |= SF_PAUSED;
+                            pci->vpaused.push_back(fd);
+                        } // end if not held yet
+                        continue;
+                    } // end if backed up
+
+                    bool bwindow = pci && (pci->caps & INTAP_CAP_WINDOW);
+                    if (bwindow && ps->credit <= 0)
+                    {
+                        // the remote-buddy has all of this one it's willing to take; it says when (CMD_WINDOW)
+                        Reactor_Mod(fd, 0);
+                        ps->flags |= SF_STALLED;
+                        continue;
+                    } // end if out of credit
                     
-                    memset(buffer, 0, buffer_size);
-                    int bytes = recv(fd, buffer, buffer_size, 0);
+                    // a stream is read for as much as its traffic has shown it takes (and it has credit for); 
+                    //  anything new for -bs
+                    size_t size = ps ? Stream_Read_Size(ps, pci->frame_max) : buffer_size;
+                    if (bwindow)
+                        size = std::min(size, (size_t)ps->credit);
+
+                    int bytes = Reactor_Recv(events[i], buffer, size);
                     if (bytes <= 0)
                     {
                         Kill_Sock(fd);
                         continue;
                     } // end bytes
 
+                    buffer[bytes] = '\0';
+                    if (ps)
+                        Stream_Adapt(ps, bytes, pci->frame_max);
+                    if (bwindow)
+                        ps->credit -= bytes;
+
                     if (debug_mode & DEBUG_L3)
                     {
                         Dump("got %d bytes from one of my peers on socket %d.\n", bytes, fd);
                         Dump_Hex(buffer, bytes);
                     } // end if debug_mode
 
-                    bool bfound{false};
-                    for (auto &x : remote_fd)
+                    // the stream tells us which remote-buddy this descriptor is paired with (if any)
+                    if (pci)
                     {
-                        auto it = x.second.mfds.find(fd);
-                        if (it != x.second.mfds.end())
-                        {
-                            // simply echo, the response
-                            Dump("echo response to \033[32mremote-buddy\033[37m");
-                            INTAP_FMT intap;
-                            intap.id = HTONS(CMD_ECHO);
-                            intap.src_fd = HTONS(it->first);
-                            intap.dest_fd = HTONS(it->second);
-                            intap.buf_len = HTONL(bytes);
-
-                            CPY_SND_BUFFER(x.first, snd_buffer, intap, buffer, bytes);
-                            bfound = true;
-                            break;
-                        } // end if echo
-                    } // end for
-
-                    if (!bfound)
+                        // simply echo, the response
+                        Dump("echo response to \033[32mremote-buddy\033[37m");
+                        INTAP_FMT intap;
+                        Stream_Echo(intap, ps, fd, bytes, pci->version);
+                        if (ps->flags & SF_HTTP)
+                            Http_Response(mrest[fd].http, buffer, bytes);
+
+                        CPY_SND_BUFFER(Stream_Link(pci, fd), snd_buffer, intap, buffer, bytes, pci->version, fd, 
+                            Stream_Class(ps));
+                    } // end if echo
+                    else
                     {
                         // this must be a new connection either from new remote or
                         //  ADO.NET client thinking I'm SQL Server, hehehhe ....
 
                         if (!strncmp(buffer, "INTAP11", 8))
                         {
-                            if (NTOHS(((INTAP_FMT_PTR)buffer)->id) == CMD_HELLO)
-                                New_Remote(fd, buffer);
+                            if (Tls_Active() && !Tls_Done(fd))
+                            {
+                                fprintf(stderr, "remote-buddy on socket %d didn't do TLS; it's not let in\n", fd);
+                                Kill_Sock(fd);
+                            } // end if in the clear
+                            else if (NTOHS(((INTAP_FMT_PTR)buffer)->id) == CMD_HELLO)
+                                New_Remote(fd, buffer, bytes);
+                            else if (NTOHS(((INTAP_FMT_PTR)buffer)->id) == CMD_JOIN)
+                                Join_Remote(fd, buffer, bytes);
+                            else if (NTOHS(((INTAP_FMT_PTR)buffer)->id) == CMD_RESUME)
+                                Resume_Remote(fd, buffer, bytes);
                         } // end if
                         else
                         {
@@ -297,6 +378,7 @@ int main(int argc, char *argv[])
     } // end while
 
     Close_Sockets();
+    Log_Close();
     return 0;     
 } // end main
 
@@ -319,49 +401,428 @@ void Init(const int argc, char **argv)
     Dump("intailizing ..");
     std::string dummy;
     Process_Command_Line(argv, argc, dummy);
+    Log_Init("\033[33m> local-buddy:\033[37m", log_file.c_str());
+
+    if (!tls_cert.empty() && !Tls_Init(true, tls_cert, tls_key, tls_ca))
+        exit(EXIT_FAILURE);
 } // end Init
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Dumps the message to console (stdout) if we are allowed to do so; i.e. degbug_mode is set to DEBUG_L1 or 
- *  above.
+ *  Begins a connection for first time with remote buddy; adds it to the list of remote-buddies that we wait on
  * 
- * @param [msg] the message to dump 
+ * @param [fd] the descriptor for remote-buddy 
+ * @param [buffer] containing the received data 
+ * @param [len] length of it; frames that came along with the hello are dealt with right away
  */
-inline void Dump(const char* msg, ...)
+void New_Remote(const int fd, const char *buf, const size_t len)
 {
-    char buf[BUF_SIZE];
-    va_list arg_list;
+    Dump("new \033[32mremote-buddy\033[37m connection");
+    CONNECTION_INFO ci{};
+    ci.fd = fd;
+    ci.vlinks.push_back(fd);
+    ci.ip = ((INTAP_FMT_PTR)buf)->ip;
+
+    // the port of a hello is the INTAP version it speaks (those that predate v2 leave it 0) along with what
+    //  else it can do; what we can do as well is on
+    u16 offer = NTOHS(((INTAP_FMT_PTR)buf)->port);
+    ci.version = std::min(std::max((int)(offer & INTAP_VERSION_MASK), INTAP_V1), INTAP_VERSION);
+    if ((offer & INTAP_CAP_LZ) && lz_min > 0 && ci.version >= INTAP_V2)
+        ci.caps |= INTAP_CAP_LZ;
 
-    if (debug_mode & DEBUG_L1)
+    ci.frame_max = buffer_size;
+    if ((offer & INTAP_CAP_FRAME) && ci.version >= INTAP_V2)
     {
-        va_start(arg_list, msg);
-        vsnprintf(buf, BUF_SIZE, msg, arg_list);
-        printf("\033[33m> local-buddy:\033[37m %s.\n", buf);
-        va_end(arg_list);
-    } // end if
-} // end Dump
+        ci.frame_max = Intap_Frame_Max(offer, frame_max, buffer_size);
+        ci.caps |= Intap_Frame_Cap(ci.frame_max);
+    } // end if it says how big
+
+    if ((offer & INTAP_CAP_WINDOW) && ci.version >= INTAP_V2)
+        ci.caps |= INTAP_CAP_WINDOW;
+
+    // its links may come back after they're lost; under a session of its own that no one's to guess
+    if ((offer & INTAP_CAP_RESUME) && ci.version >= INTAP_V2 && resume_secs > 0)
+    {
+        std::random_device rd;
+        ci.caps |= INTAP_CAP_RESUME;
+        while (!ci.session)
+            ci.session = ((u64)rd() << 32) | rd();
+    } // end if resumable
+
+    // one that gave up resuming an earlier session says which; whatever's left of it goes right away
+    size_t hello_len = sizeof(INTAP_FMT);
+    if ((offer & INTAP_CAP_RESUME) && NTOHL(((INTAP_FMT_PTR)buf)->buf_len) == sizeof(u64) && 
+        len >= hello_len + sizeof(u64))
+    {
+        u64 stale;
+        memcpy(&stale, buf + hello_len, sizeof(stale));
+        hello_len += sizeof(stale);
+
+        CONNECTION_INFO_PTR pstale = Find_Session(NTOHLL(stale));
+        if (pstale)
+        {
+            Dump("\033[32mremote-buddy\033[37m on socket %d starts over; letting go of its last session", fd);
+            bsend_close = false;
+            Kill_Remote(pstale);
+        } // end if still around
+    } // end if starting over
+    
+    // the info itself becomes the context of the descriptor; the map never moves its values around
+    auto it = remote_fd.emplace(fd, ci).first;
+    Reactor_Set_Ctx(fd, &it->second);
+    Route_Add(&it->second);
+
+    // say hi back with our end and the version we settled on; the end is what any other links join with
+    INTAP_FMT intap;
+    u64 session = HTONLL(ci.session);
+    intap.id = HTONS(CMD_HELLO);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = ((INTAP_FMT_PTR)buf)->src_fd;
+    intap.port = HTONS(ci.version | ci.caps);
+    intap.buf_len = HTONL(ci.session ? sizeof(session) : 0);
+    Send(fd, (const char *)&intap, sizeof(intap));
+    if (ci.session)
+        Send(fd, (const char *)&session, sizeof(session));
+
+    // many a stream's frames go down it each loop iteration; they're better off going in one send, and in 
+    //  turns once it backs up
+    Send_Coalesce(fd);
+    Intap_Schedule(fd, weight_db, weight_rest);
+    if (ci.caps & INTAP_CAP_LZ)
+        Intap_Compress(fd, lz_min);
+    if (ci.caps & INTAP_CAP_RESUME)
+    {
+        Intap_Replay(fd, (size_t)replay_max << 20);
+        Tcp_Keep_Alive(fd, LINK_IDLE_SECS);
+    } // end if resumable
+
+    // a remote-buddy that doesn't wait on our answer may have sent more right behind the hello
+    if (len > hello_len)
+    {
+        Intap_Feed(it->second.mrx[fd], buf + hello_len, len - hello_len);
+        Tunnel_Frames(&it->second, fd);
+    } // end if more
+} // end Process_First_Time_Request
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Begins a connection for first time with remote buddy; adds it to the list of remote-buddies that we wait on
+ *  Another tunnel link of a remote-buddy we already know of; it names the first link (our end of it) and from 
+ *  here on it's just one more way to the same remote-buddy.
  * 
- * @param [fd] the descriptor for remote-buddy 
+ * @param [fd] the descriptor of the new link 
  * @param [buffer] containing the received data 
+ * @param [len] length of it 
  */
-void New_Remote(const int fd, const char *buf)
+void Join_Remote(const int fd, const char *buf, const size_t len)
 {
-    Dump("new \033[32mremote-buddy\033[37m connection");
-    CONNECTION_INFO ci{};
-    ci.ip = ((INTAP_FMT_PTR)buf)->ip;
-    ci.port = NTOHS(((INTAP_FMT_PTR)buf)->port);
+    auto it = remote_fd.find((s16)NTOHS(((INTAP_FMT_PTR)buf)->dest_fd));
+    if (it == remote_fd.end())
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m link on socket %d joins no one!\n", fd);
+        Kill_Sock(fd);
+        return;
+    } // end if no such remote
+
+    Dump("\033[32mremote-buddy\033[37m on socket %d got another link on socket %d", it->first, fd);
+    it->second.vlinks.push_back(fd);
+    Reactor_Set_Ctx(fd, &it->second);
+
+    INTAP_FMT intap;
+    intap.id = HTONS(CMD_JOIN);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = ((INTAP_FMT_PTR)buf)->src_fd;
+    intap.port = HTONS(it->second.version | it->second.caps);
+    intap.buf_len = 0;
+    Send(fd, (const char *)&intap, sizeof(intap));
+    Send_Coalesce(fd);
+    Intap_Schedule(fd, weight_db, weight_rest);
+    if (it->second.caps & INTAP_CAP_LZ)
+        Intap_Compress(fd, lz_min);
+    if (it->second.caps & INTAP_CAP_RESUME)
+    {
+        Intap_Replay(fd, (size_t)replay_max << 20);
+        Tcp_Keep_Alive(fd, LINK_IDLE_SECS);
+    } // end if resumable
+
+    if (len > sizeof(INTAP_FMT))
+    {
+        Intap_Feed(it->second.mrx[fd], buf + sizeof(INTAP_FMT), len - sizeof(INTAP_FMT));
+        Tunnel_Frames(&it->second, fd);
+    } // end if more
+} // end Join_Remote
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A remote-buddy whose link got lost reconnects it (INTAP_CAP_RESUME); the new connection takes the link's 
+ *  place and both ends pick up from where the other says it left off, the streams on it never know. Its
+ *  CMD_RESUME has the session and how much it got off the link; we answer with how much we did. One we can't 
+ *  resume is told so with a CMD_BYEBYE; it starts over with a new session.
+ * 
+ * @param [fd] the new connection 
+ * @param [buf] containing the received data 
+ * @param [len] length of it 
+ */
+void Resume_Remote(const int fd, const char *buf, const size_t len)
+{
+    INTAP_FMT_PTR pintap = (INTAP_FMT_PTR)buf;
+    u64 vals[2];        // the session and what the remote-buddy got off the link
+    int link = (s16)NTOHS(pintap->dest_fd);
+    CONNECTION_INFO_PTR pci{nullptr};
+    if (NTOHL(pintap->buf_len) == sizeof(vals) && len >= sizeof(INTAP_FMT) + sizeof(vals))
+    {
+        memcpy(vals, buf + sizeof(INTAP_FMT), sizeof(vals));
+        pci = Find_Session(NTOHLL(vals[0]));
+    } // end if well formed
+
+    if (pci && std::find(pci->vlinks.begin(), pci->vlinks.end(), link) == pci->vlinks.end())
+        pci = nullptr;
     
-    remote_fd.emplace(fd, ci);
-} // end Process_First_Time_Request
+    // it may find out before we do; the link's no good to either of us anymore
+    if (pci && !Intap_Park(link))
+    {
+        Kill_Remote(pci);
+        pci = nullptr;
+    } // end if can't be
+
+    INTAP_FMT answer;
+    u64 rcvd = pci ? HTONLL(pci->mrx[link].rcvd) : 0;
+    char lead[sizeof(answer) + sizeof(rcvd)];
+    answer.id = HTONS(pci ? CMD_RESUME : CMD_BYEBYE);
+    answer.src_fd = HTONS(link);
+    answer.dest_fd = pintap->src_fd;
+    answer.buf_len = HTONL(pci ? sizeof(rcvd) : 0);
+    memcpy(lead, &answer, sizeof(answer));
+    memcpy(lead + sizeof(answer), &rcvd, sizeof(rcvd));
+
+    if (!pci)
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m link on socket %d resumes no session we have\n", fd);
+        Send_Block(fd, lead, sizeof(answer));
+        Kill_Sock(fd);
+        return;
+    } // end if no such session
+
+    if (!Intap_Resume(link, fd, NTOHLL(vals[1]), pci, lead, sizeof(lead)))
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m link on socket %d can't be resumed from where "
+            "remote-buddy says\n", link);
+        Send_Block(fd, lead, sizeof(answer));
+        Kill_Sock(fd);
+        Kill_Remote(pci);
+        return;
+    } // end if can't
+
+    // the connection's the link now; what it was known by goes with it
+    fdip[fd] = 0;
+    fdtls[fd] = false;
+    Dump("\033[32mremote-buddy\033[37m link on socket %d resumed", link);
+
+    bool bparked{false};
+    for (int x : pci->vlinks)
+        bparked = bparked || Intap_Parked(x);
+    if (!bparked)
+        pci->resume_by = 0;
+
+    // frames read off it before it got lost may still be waiting on the link
+    Tunnel_Frames(pci, link);
+} // end Resume_Remote
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The remote-buddy with the session given; nullptr if there's none
+ * 
+ * @param [session] the session it got in the hello (see New_Remote)
+ */
+CONNECTION_INFO_PTR Find_Session(const u64 session)
+{
+    if (!session)
+        return nullptr;
+
+    for (auto &x : remote_fd)
+    {
+        if (x.second.session == session)
+            return &x.second;
+    } // end for
+
+    return nullptr;
+} // end Find_Session
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Deals with every whole frame read off a remote-buddy link so far (see Intap_Fill); one cut short waits for
+ *  the rest of it, unless it's a big enough payload to go straight through to its stream.
+ * 
+ * @param [pci] the remote-buddy 
+ * @param [fd] the link 
+ */
+void Tunnel_Frames(CONNECTION_INFO_PTR pci, const int fd)
+{
+    INTAP_RX &rx = pci->mrx[fd];
+    INTAP_FMT intap;
+    const char *payload;
+    int status;
+
+    while ( (status = Intap_Next(rx, intap, payload)) != INTAP_RX_MORE)
+    {
+        if (status == INTAP_RX_SPLICE)
+        {
+            if (NTOHS(intap.id) != CMD_ECHO || (status = Splice_Echo(pci, fd, intap)) == 0)
+                break;          // the rest comes the usual way
+            else if (status < 0)
+            {
+                Lose_Link(pci, fd);
+                return;
+            } // end if link's gone
+
+            continue;
+        } // end if big one
+
+        if (status == INTAP_RX_BAD || strncmp(intap.signature, "INTAP11", 8))
+        {
+            fprintf(stderr, "\033[31m> local-buddy:\033[37m no hablo comprende, error de protocolo!\n");
+            Kill_Sock(fd);
+            return;
+        } // end if garbage
+
+        Tunnel_Frame(pci, fd, intap, payload, NTOHL(intap.buf_len));
+        if (Reactor_Ctx(fd) != pci)
+            return;             // the link went down along with it
+    } // end while
+
+    if (pci->caps & INTAP_CAP_RESUME)
+        Intap_Ack(fd, rx, pci->version);
+} // end Tunnel_Frames
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Does as a frame from the remote-buddy says
+ * 
+ * @param [pci] the remote-buddy 
+ * @param [fd] the link it came on 
+ * @param [intap] the frame's header 
+ * @param [buf] its payload 
+ * @param [bytes] length of the payload 
+ */
+void Tunnel_Frame(CONNECTION_INFO_PTR pci, const int fd, INTAP_FMT &intap, const char *buf, const int bytes)
+{
+    if (debug_mode & DEBUG_L3)
+    {
+        Dump("got %d bytes from \033[32mremote-buddy\033[37m on socket %d.\n",
+             (int)(bytes + sizeof(intap)), fd);
+        Dump_Hex((char*)&intap, sizeof(intap));
+        Dump_Hex(buf, bytes);
+    } // end if debug_mode
+
+    // this is from our remote side;
+    int id = NTOHS(intap.id);
+    switch (id)
+    {
+        case CMD_BYEBYE:    // socket sent FIN
+        {
+            int lfd = Paired_Fd(pci, intap);
+            if (lfd < 0 || Keep_Alive(lfd))
+                break;      // long gone or kept for the next client
+
+            bsend_close = false;
+            Kill_Sock(lfd);
+        } break;
+
+        case CMD_ECHO:  // just echoing on existing
+        {
+            int lfd = Paired_Fd(pci, intap);
+            int rfd = (s16)NTOHS(intap.src_fd);
+            if (lfd < 0)
+                break;      // long gone
+
+            STREAM_PTR ps = Stream_Get(lfd);
+            Upstream_Send(ps, lfd, buf, bytes);
+            if (ps->flags & SF_HTTP)
+                Http_Request(mrest[lfd].http, buf, bytes);
+
+            if (ps->rfd == -1 && rfd > 0)
+                ps->rfd = rfd;
+            Grant_Credit(pci, ps, lfd, bytes);
+        } break;
+
+        case CMD_WINDOW:    // the remote-buddy took in some of a stream; that much more may go
+        {
+            int lfd = Paired_Fd(pci, intap);
+            if (lfd < 0 || bytes != sizeof(u32))
+                break;      // long gone
+
+            STREAM_PTR ps = Stream_Get(lfd);
+
+            if (Stream_Credit(ps, NTOHL(*(const u32 *)buf)) && !(ps->flags & SF_PAUSED))
+                Reactor_Mod(lfd, EV_READ | EV_RECV);
+        } break;
+
+        case CMD_ACK:       // the remote-buddy got this much off the link; it needn't be kept for a replay anymore
+            if (bytes == sizeof(u64))
+                Intap_Acked(fd, NTOHLL(*(const u64 *)buf));
+            break;
+
+        case CMD_CLI_CONNECT:   // new client connection
+        {
+            // a warm one from the pool if there's any; the first request to a server opens its pool
+            intap.port = NTOHS(intap.port);
+            int status{0};
+            UPSTREAM_POOL_PTR ppool = Pool_Open(intap.ip, intap.port, pool_size, pool_keep, pool_idle_ms, 
+                connect_timeout);
+            int nfd = Pool_Claim(ppool);
+            if (nfd < 0)
+            {
+                Dump("connecting with RESTful server at %s:%d ..", intap.ip, intap.port);
+                nfd = Socket();
+                status = Connect_Async(nfd, intap.ip, intap.port);
+            } // end if none warm
+            STREAM_PTR ps = status < 0 ? nullptr : Stream_Open(nfd, pci, (s16)NTOHS(intap.src_fd), 
+                status == 0 ? STREAM_OPEN : STREAM_CONNECTING, SF_UNNAMED | SF_HTTP);
+            if (!ps)
+            {
+                // let the client on the other side know it's not happening
+                CLOSE(nfd);
+                intap.id = HTONS(CMD_BYEBYE);
+                intap.dest_fd = intap.src_fd;
+                intap.src_fd = HTONS(-1);
+                intap.buf_len = 0;
+                CPY_SND_BUFFER(fd, snd_buffer, intap, "", 0, pci->version);
+                break;
+            } // end if failed
+
+            // it gets to know ours with the response; its frames come to us by its descriptor till then
+            pci->mrfd[ps->rfd] = nfd;
+            REST_STREAM &rs = mrest[nfd];
+            rs.ppool = ppool;
+            Http_Request(rs.http, buf, bytes);
+            if (status == 0)
+            {
+                Dump("connected to RESTful server at %s:%d", intap.ip, intap.port);
+                Send(nfd, buf, bytes);
+                Reactor_Add(nfd, EV_READ | EV_RECV);
+            } // end if connected
+            else
+            {
+                // the request waits along with the connect; so does the rest of it
+                Reactor_Add(nfd, EV_WRITE);
+                mconnecting[nfd] = {Now_Ms() + (u64)connect_timeout, std::string(buf, bytes)};
+            } // end else in progress
+
+            Grant_Credit(pci, ps, nfd, bytes);
+        } break;
+    } // end switch
+} // end Tunnel_Frame
 
 
 //==============================================================================================================|
@@ -377,44 +838,360 @@ void New_Remote(const int fd, const char *buf)
 void New_Db(const int fd, const char *buf, const size_t len)
 {
     Dump("new connection request to RDBMS");
+
+    // the remote-buddy its address is bound to, or else one yet to be bound (0.0.0.0) that's bound to it now
+    CONNECTION_INFO_PTR pci = Route_Find((size_t)fd < fdip.size() ? fdip[fd] : 0);
+    if (!pci)
+    {
+        // at this point means an error
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m la problema, shouldn't get here!\n");
+        return;
+    } // end if no one
+
+    INTAP_FMT intap{};
+    intap.id = HTONS(CMD_DB_CONNECT);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = HTONS(-1);
+    intap.buf_len = HTONL(len);
+
+    STREAM_PTR ps = Stream_Open(fd, pci, -1, STREAM_OPEN, SF_DB);
+    if (!ps)
+    {
+        Kill_Sock(fd);
+        return;
+    } // end if no room
+
+    ps->credit -= len;
+    CPY_SND_BUFFER(Stream_Link(pci, fd), snd_buffer, intap, buf, len, pci->version, fd, EGRESS_DB);
+    Reactor_Mod(fd, EV_READ | EV_RECV);     // a plain stream from here on
+} // end New_Db
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Finds our end of a stream a remote-buddy frame is meant for. The remote side doesn't know our descriptor
+ *  till we've responded at least once (it sends -1 till then), so those are looked up by its descriptor.
+ *  A frame naming both ends has to name the stream's own remote end too; one meant for an earlier stream on
+ *  the descriptor is no good to the one there now.
+ * 
+ * @param [pci] the remote-buddy the frame came from 
+ * @param [intap] the frame 
+ * 
+ * @return int
+ *  the descriptor or -1 if there's no such stream
+ */
+int Paired_Fd(CONNECTION_INFO_PTR pci, const INTAP_FMT &intap)
+{
+    int rfd = (s16)NTOHS(intap.src_fd);
+    int lfd = (s16)NTOHS(intap.dest_fd);
+    if (lfd <= 0)
+    {
+        auto it = pci->mrfd.find(rfd);
+        lfd = it == pci->mrfd.end() ? -1 : it->second;
+    } // end if not named
+
+    STREAM_PTR ps = Stream_Get(lfd);
+    if (!ps || ps->ppeer != pci || (rfd > 0 && ps->rfd > 0 && ps->rfd != rfd))
+        return -1;
+
+    return lfd;
+} // end Paired_Fd
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Relays the payload of a CMD_ECHO straight from the remote-buddy link into the stream with Intap_Splice(), 
+ *  never bringing what's still in the kernel into user space; only streams that are up (not still connecting) 
+ *  get it this way.
+ * 
+ * @param [pci] the remote-buddy 
+ * @param [fd] the link the frame came on; most of the payload is still in it 
+ * @param [intap] the frame's header 
+ * 
+ * @return int
+ *  1 if it's on its way, 0 if the payload is to be read the usual way or -1 if the link's gone
+ */
+int Splice_Echo(CONNECTION_INFO_PTR pci, const int fd, const INTAP_FMT &intap)
+{
+    int lfd = Paired_Fd(pci, intap);
+    STREAM_PTR ps = Stream_Get(lfd);
+    if (!ps || ps->state != STREAM_OPEN)
+        return 0;
+
+    int status = Intap_Splice(fd, pci->mrx[fd], lfd);
+    if (status <= 0)
+        return status;
+
+    if (debug_mode & DEBUG_L3)
+        Dump("splicing %u bytes from \033[32mremote-buddy\033[37m on socket %d to socket %d", 
+            NTOHL(intap.buf_len), fd, lfd);
+
+    if (ps->flags & SF_HTTP)
+        Http_Request_Skip(mrest[lfd].http, NTOHL(intap.buf_len));
+
+    int rfd = (s16)NTOHS(intap.src_fd);
+    if (ps->rfd == -1 && rfd > 0)
+        ps->rfd = rfd;
+
+    Grant_Credit(pci, ps, lfd, NTOHL(intap.buf_len));
+    return 1;
+} // end Splice_Echo
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The client of a RESTServer stream is gone; if the stream's between messages with every request answered 
+ *  it goes back to its pool for the next client instead of being closed (and left in TIME_WAIT).
+ * 
+ * @param [fd] the stream 
+ * 
+ * @return bool
+ *  true if it's kept
+ */
+bool Keep_Alive(const int fd)
+{
+    STREAM_PTR ps = Stream_Get(fd);
+    if (!(ps->flags & SF_HTTP) || ps->state != STREAM_OPEN)
+        return false;
+
+    REST_STREAM &rs = mrest[fd];
+    if (!Http_Idle(rs.http) || !Pool_Return(rs.ppool, fd))
+        return false;
+
+    Dump("keeping socket %d to RESTful server alive after %u request(s)", fd, rs.http.req.messages);
+    Forget_Stream(fd);
+    return true;
+} // end Keep_Alive
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends to a RESTServer stream; held on to if the stream is still connecting
+ * 
+ * @param [ps] the stream 
+ * @param [fd] its descriptor 
+ * @param [buf] the data 
+ * @param [len] length of data 
+ */
+void Upstream_Send(STREAM_PTR ps, const int fd, const char *buf, const size_t len)
+{
+    if (ps->state == STREAM_CONNECTING)
+        mconnecting[fd].pending.append(buf, len);
+    else
+        Send(fd, buf, len);
+} // end Upstream_Send
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Flow control; a stream passed on what it took off the tunnel to its descriptor. The credit for it goes back 
+ *  to the remote-buddy in a CMD_WINDOW once there's enough of it and the descriptor is keeping up; one that's 
+ *  backed up gets it granted as it drains (see On_Congestion).
+ * 
+ * @param [pci] the remote-buddy 
+ * @param [ps] the stream 
+ * @param [fd] its descriptor 
+ * @param [bytes] how many more were passed on 
+ */
+void Grant_Credit(CONNECTION_INFO_PTR pci, STREAM_PTR ps, const int fd, const size_t bytes)
+{
+    if (!(pci->caps & INTAP_CAP_WINDOW))
+        return;
+
+    u32 grant = Stream_Grant(ps, bytes, ps->state == STREAM_OPEN && ps->rfd > 0 && !Send_Congested(fd));
+    if (!grant)
+        return;
+
+    INTAP_FMT intap;
+    intap.id = HTONS(CMD_WINDOW);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = HTONS(ps->rfd);
+    intap.buf_len = HTONL(sizeof(grant));
+    grant = HTONL(grant);
+    CPY_SND_BUFFER(Stream_Link(pci, fd), snd_buffer, intap, (const char *)&grant, sizeof(grant), pci->version);
+} // end Grant_Credit
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A pending connect turned writable (or failed); on success whatever was held on to goes out and the stream
+ *  goes on like any other, on failure the stream is killed and the client on the other side told so.
+ * 
+ * @param [fd] the descriptor 
+ */
+void Finish_Connect(const int fd)
+{
+    auto it = mconnecting.find(fd);
+    if (Connect_Finish(fd) < 0)
+    {
+        perror("connect");
+        Kill_Sock(fd);
+        return;
+    } // end if failed
+
+    Dump("connected to RESTful server on socket %d", fd);
+    std::string pending = std::move(it->second.pending);
+    mconnecting.erase(it);
+    stream_table[fd].state = STREAM_OPEN;
+
+    Reactor_Mod(fd, EV_READ | EV_RECV);
+    Send(fd, pending.data(), pending.size());
+    Grant_Credit((CONNECTION_INFO_PTR)stream_table[fd].ppeer, &stream_table[fd], fd, 0);
+} // end Finish_Connect
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Gives up on the connects that took too long
+ */
+void Expire_Connects()
+{
+    if (mconnecting.empty())
+        return;
+
+    std::vector<int> vexpired;
+    u64 now = Now_Ms();
+    for (auto &x : mconnecting)
+    {
+        if (x.second.deadline <= now)
+            vexpired.push_back(x.first);
+    } // end for
+
+    for (int fd : vexpired)
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m connect timed out on socket %d\n", fd);
+        Kill_Sock(fd);
+    } // end for
+} // end Expire_Connects
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A remote-buddy link lost its connection. One that can be resumed (INTAP_CAP_RESUME) is held for the 
+ *  remote-buddy to reconnect, its streams waiting on it as though it were backed up; for no longer than 
+ *  -resume seconds though (see Expire_Sessions). Anything else takes the remote-buddy down with it.
+ * 
+ * @param [pci] the remote-buddy 
+ * @param [fd] the link
+ */
+void Lose_Link(CONNECTION_INFO_PTR pci, const int fd)
+{
+    if (!(pci->caps & INTAP_CAP_RESUME) || !Intap_Park(fd))
+    {
+        Kill_Remote(pci);
+        return;
+    } // end if can't be resumed
+
+    fprintf(stderr, "\033[31m> local-buddy:\033[37m link on socket %d lost; its streams wait %d s for it\n", 
+        fd, resume_secs);
+    if (!pci->resume_by)
+        pci->resume_by = Now_Ms() + (u64)resume_secs * 1000;
+} // end Lose_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Gives up on the remote-buddies whose lost links didn't come back in time
+ */
+void Expire_Sessions()
+{
+    std::vector<CONNECTION_INFO_PTR> vexpired;
+    u64 now = Now_Ms();
     for (auto &x : remote_fd)
     {
-        if (!strncmp(fdip[fd].c_str(), x.second.ip.c_str(), fdip[fd].size()))
-        {
-            INTAP_FMT intap;
-            intap.id = HTONS(CMD_DB_CONNECT);
-            intap.src_fd = HTONS(fd);
-            intap.dest_fd = HTONS(-1);
-            intap.buf_len = HTONL(len);
-
-            CPY_SND_BUFFER(x.first, snd_buffer, intap, buf, len);
-            x.second.mfds.emplace(fd, -1);
-            return;
-        } // end if same
+        if (x.second.resume_by && x.second.resume_by <= now)
+            vexpired.push_back(&x.second);
     } // end for
 
-    // let's look for a remote descriptor with ip 0.0.0.0:0
+    for (CONNECTION_INFO_PTR pci : vexpired)
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m remote-buddy on socket %d never came back\n", pci->fd);
+        bsend_close = false;
+        Kill_Remote(pci);
+    } // end for
+} // end Expire_Sessions
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  How long the reactor may wait, with the remote-buddies waiting on lost links in mind (see Expire_Sessions)
+ * 
+ * @param [timeout] what it'd wait otherwise in milli-seconds; -1 for forever 
+ */
+int Resume_Wait_Ms(int timeout)
+{
+    u64 now = Now_Ms();
     for (auto &x : remote_fd)
     {
-        if (!strncmp(x.second.ip.c_str(), "0.0.0.0", x.second.ip.length()))
-        {
-            x.second.ip = fdip[fd];
-            INTAP_FMT intap;
-            intap.id = HTONS(CMD_DB_CONNECT);
-            intap.src_fd = HTONS(fd);
-            intap.dest_fd = HTONS(-1);
-            intap.buf_len = HTONL(len);
-
-            CPY_SND_BUFFER(x.first, snd_buffer, intap, buf, len);
-            x.second.mfds.emplace(fd, -1);
-            return;
-        } // end if new db connection request with a new remote
+        if (!x.second.resume_by)
+            continue;
+
+        int left = x.second.resume_by > now ? (int)(x.second.resume_by - now) : 0;
+        if (timeout < 0 || left < timeout)
+            timeout = left;
     } // end for
 
+    return timeout;
+} // end Resume_Wait_Ms
 
-    // at this point means an error
-    fprintf(stderr, "\033[31m> local-buddy:\033[37m la problema, shouldn't get here!\n");
-} // end New_Db
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Backpressure; a remote-buddy that's backed up has its streams stop reading as they turn ready (see main),
+ *  once it drains they all go back to reading. A RESTServer or db stream backing up holds nothing up, as the
+ *  only thing feeding it is the remote-buddy which every other stream shares; it's left to queue up, and with
+ *  flow control on the credit it's owed is only granted back once it drains.
+ * 
+ * @param [fd] the descriptor whose queue crossed a water mark 
+ * @param [bcongested] over the high-water mark or back under the low one?
+ */
+void On_Congestion(const int fd, const bool bcongested)
+{
+    CONNECTION_INFO_PTR pci = (CONNECTION_INFO_PTR)Reactor_Ctx(fd);
+    if (!pci)
+    {
+        STREAM_PTR ps = Stream_Get(fd);
+        if (ps && !bcongested)
+            Grant_Credit((CONNECTION_INFO_PTR)ps->ppeer, ps, fd, 0);
+        return;
+    } // end if a stream
+
+    Dump("\033[32mremote-buddy\033[37m link on socket %d %s", fd, bcongested ? "backed up" : "drained");
+    if (bcongested)
+        return;
+
+    // only the streams going down this link were held back for it; those gone since are forgotten
+    std::vector<int> vheld;
+    for (int sfd : pci->vpaused)
+    {
+        STREAM_PTR ps = Stream_Get(sfd);
+        if (!ps || ps->ppeer != pci || !(ps->flags & SF_PAUSED))
+            continue;
+
+        if (Stream_Link(pci, sfd) != fd)
+        {
+            vheld.push_back(sfd);
+            continue;
+        } // end if another link's
+
+        ps->flags &= ~SF_PAUSED;
+        if (!(ps->flags & SF_STALLED))
+            Reactor_Mod(sfd, EV_READ | EV_RECV);
+    } // end for
+
+    pci->vpaused.swap(vheld);
+} // end On_Congestion
 
 
 //==============================================================================================================|
@@ -424,18 +1201,174 @@ void New_Db(const int fd, const char *buf, const size_t len)
  */
 void Close_Sockets()
 {
-    for (auto &x : remote_fd)
+    // killing a remote-buddy takes its paired descriptors along
+    while (!remote_fd.empty())
+        Kill_Remote(&remote_fd.begin()->second);
+
+    Pool_Close();
+    CLOSE(listen_fd);
+} // end Close_Sockets
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets go of everything kept on a stream; the descriptor itself is the caller's
+ * 
+ * @param [fd] the stream 
+ */
+void Forget_Stream(const int fd)
+{
+    STREAM_PTR ps = Stream_Get(fd);
+    CONNECTION_INFO_PTR pci = (CONNECTION_INFO_PTR)ps->ppeer;
+    auto it = pci->mrfd.find(ps->rfd);
+    if (it != pci->mrfd.end() && it->second == fd)
+        pci->mrfd.erase(it);
+
+    if (ps->flags & SF_HTTP)
+        mrest.erase(fd);
+
+    mconnecting.erase(fd);
+    if ((size_t)fd < fdip.size())
+        fdip[fd] = 0;
+    Stream_Close(fd);
+} // end Forget_Stream
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Has the descriptor been through the TLS handshake (see Tls_Step)?
+ * 
+ * @param [fd] one we accepted
+ */
+bool Tls_Done(const int fd)
+{
+    return (size_t)fd < fdtls.size() && fdtls[fd];
+} // end Tls_Done
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Goes on with the TLS handshake of a remote-buddy link as it turns ready; nothing on it is routed till it's 
+ *  through, its hello comes after by way of the kernel. The reactor never waits on it, however slow the other
+ *  side is (see Expire_Handshakes).
+ * 
+ * @param [fd] the link
+ */
+void Tls_Step(const int fd)
+{
+    TLS_WAIT &wait = maccepting[fd];
+    u32 events{EV_READ};
+    int status = Tls_Accept_Step(fd, wait.pssl, events);
+    if (status == 0)
+    {
+        Reactor_Mod(fd, events);
+        return;
+    } // end if still on
+
+    maccepting.erase(fd);
+    if (status < 0)
     {
-        for (auto &y : x.second.mfds)
-            Kill_Sock(y.first);
+        Kill_Sock(fd);
+        return;
+    } // end if failed
 
-        x.second.mfds.clear();
-        Kill_Sock(x.first);
+    fdtls[fd] = true;
+    Reactor_Mod(fd, EV_READ);
+} // end Tls_Step
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Gives up on the TLS handshakes that took too long
+ */
+void Expire_Handshakes()
+{
+    if (maccepting.empty())
+        return;
+
+    std::vector<int> vexpired;
+    u64 now = Now_Ms();
+    for (auto &x : maccepting)
+    {
+        if (x.second.deadline <= now)
+            vexpired.push_back(x.first);
     } // end for
 
-    remote_fd.clear();
-    CLOSE(listen_fd);
-} // end Close_Sockets
+    for (int fd : vexpired)
+    {
+        fprintf(stderr, "\033[31m> local-buddy:\033[37m TLS handshake timed out on socket %d\n", fd);
+        Kill_Sock(fd);
+    } // end for
+} // end Expire_Handshakes
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  How long the reactor may wait, with the TLS handshakes on in mind (see Expire_Handshakes)
+ * 
+ * @param [timeout] what it'd wait otherwise in milli-seconds; -1 for forever 
+ */
+int Tls_Wait_Ms(int timeout)
+{
+    u64 now = Now_Ms();
+    for (auto &x : maccepting)
+    {
+        int left = x.second.deadline > now ? (int)(x.second.deadline - now) : 0;
+        if (timeout < 0 || left < timeout)
+            timeout = left;
+    } // end for
+
+    return timeout;
+} // end Tls_Wait_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets go of a remote-buddy, every link and stream it has along with it; it's told so unless bsend_close 
+ *  says otherwise.
+ * 
+ * @param [pci] the remote-buddy 
+ */
+void Kill_Remote(CONNECTION_INFO_PTR pci)
+{
+    if (bsend_close)
+    {
+        // only if this is self initated
+        INTAP_FMT intap;
+        intap.id = HTONS(CMD_BYEBYE);
+        intap.src_fd = HTONS(pci->fd);
+        intap.dest_fd = HTONS(-1);
+        intap.buf_len = 0;
+        CPY_SND_BUFFER(pci->fd, snd_buffer, intap, "", 0, pci->version);
+    } // end if send kill 
+
+    // the descriptors paired with this remote-buddy have no where to go now
+    for (int sfd = Stream_Next(pci, 0); sfd >= 0; sfd = Stream_Next(pci, sfd + 1))
+    {
+        Forget_Stream(sfd);
+        Erase_Sock(sfd);
+        CLOSE(sfd);
+    } // end for
+
+    // losing any one link loses the remote-buddy; its streams are spread all over them
+    for (int link : pci->vlinks)
+    {
+        Erase_Sock(link);
+        if ((size_t)link < fdip.size())
+            fdip[link] = 0;
+        CLOSE(link);
+    } // end for
+
+    Route_Remove(pci);
+    remote_fd.erase(pci->fd);
+    bsend_close = true;      // restore
+} // end Kill_Remote
 
 
 //==============================================================================================================|
@@ -455,46 +1388,76 @@ void Kill_Sock(const int fd)
 
     Dump("killin' em softly, socket %d", fd);
     
-    auto it = remote_fd.find(fd);
-    if (it != remote_fd.end())
-    {
-        if (bsend_close)
-        {
-            // only if this is self initated
-            memcpy(snd_buffer, &intap, sizeof(intap));
-            Send(fd, (const char *)&intap, sizeof(intap));
-        } // end if send kill 
-
-        CLOSE(it->first);
-        remote_fd.erase(it);
-    } // end if remote desc ending
-    else
+    CONNECTION_INFO_PTR pci = (CONNECTION_INFO_PTR)Reactor_Ctx(fd);
+    STREAM_PTR ps = Stream_Get(fd);
+    bool bclose{false};
+    if (pci)
+        Kill_Remote(pci);       // a protocol error on any one link; the others are no good either
+    else if (ps)
     {
         // this must be one of paired-descriptors let's end
-        for (auto &x : remote_fd)
+        pci = (CONNECTION_INFO_PTR)ps->ppeer;
+        if (bsend_close)
         {
-            auto it2 = x.second.mfds.find(fd);
-            if (it2 != x.second.mfds.end())
-            {
-                if (bsend_close)
-                {
-                    intap.dest_fd = HTONS(it2->second);
-                    memcpy(snd_buffer, &intap, sizeof(intap));
-                    Send(x.first, snd_buffer, sizeof(intap));
-                } // end if sending kill
+            intap.dest_fd = HTONS(ps->rfd);
+            CPY_SND_BUFFER(Stream_Link(pci, fd), snd_buffer, intap, "", 0, pci->version, fd, Stream_Class(ps));
+        } // end if sending kill
 
-                CLOSE(it2->first);
-                x.second.mfds.erase(it2);
-            } // end for
-        } // end foreach
-    } // end else
+        Forget_Stream(fd);
+        bclose = true;
+    } // end else if paired
+    else if (bsend_close && fd != listen_fd)
+        bclose = true;          // never got paired with anyone; just let it go
 
     bsend_close = true;      // restore
-    fdip.erase(fd);
+    mconnecting.erase(fd);
+    auto it = maccepting.find(fd);
+    if (it != maccepting.end())
+    {
+        Tls_Abort(it->second.pssl);
+        maccepting.erase(it);
+    } // end if handshake on
+
+    if ((size_t)fd < fdip.size())
+        fdip[fd] = 0;
     Erase_Sock(fd);
+    if (bclose)
+        CLOSE(fd);              // last; once it's closed the number is anyone's
 } // end Kill_Sock
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Adds the streams open over each remote-buddy to a metrics scrape (see Metrics_Listen); by the address it 
+ *  came from and our end of its first link
+ * 
+ * @param [out] the scrape 
+ */
+void Remote_Metrics(std::string &out)
+{
+    std::unordered_map<void*, int> mstreams;
+    for (int sfd = 0, top = stream_top; sfd < top; sfd++)
+    {
+        STREAM_PTR ps = Stream_Get(sfd);
+        if (ps && ps->ppeer)
+            mstreams[ps->ppeer]++;
+    } // end for
+
+    out += "# HELP jw_remote_streams Streams open over a remote-buddy.\n# TYPE jw_remote_streams gauge\n";
+    for (auto &x : remote_fd)
+    {
+        char line[128], addr[INET_ADDRSTRLEN]{};
+        if ((size_t)x.first < fdip.size() && fdip[x.first])
+            inet_ntop(AF_INET, &fdip[x.first], addr, sizeof(addr));
+
+        snprintf(line, sizeof(line), "jw_remote_streams{remote=\"%s\",link=\"%d\"} %d\n", 
+            addr, x.first, mstreams[&x.second]);
+        out += line;
+    } // end for
+} // end Remote_Metrics
+
+
 //==============================================================================================================|
 //          THE END
 //==============================================================================================================|
\ No newline at end of file
@@ -0,0 +1,743 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Logging off the event loop; see logger.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "logger.h"
+#include <mutex>
+#include <time.h>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define LOG_REC_MAX     2048        // the longest a LOG_TEXT record gets; arguments past it are left out
+#define LOG_OUT_BATCH   (64 * 1024) // what the drainer piles up before writing it out
+
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A conversion in a format as both the thread logging and the drainer see it
+ */
+typedef struct LOG_SPEC_FMT
+{
+    size_t len;         // from the '%' through the conversion
+    size_t mod;         // where its length modifier starts (the conversion itself if there's none)
+    char conv;          // the conversion; 0 if it makes no sense to us
+    char size;          // its argument is an int unless: 'l' long, 'L' long long, 'z' size_t, 'j' intmax_t,
+                        //  't' ptrdiff_t or 'D' long double
+    int stars;          // widths and precisions given as arguments ('*'); an int each ahead of it
+} LOG_SPEC, *LOG_SPEC_PTR;
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static std::mutex log_lock;                     // guards the list of rings; never taken while logging
+static std::vector<LOG_RING_PTR> vrings;        // every thread's that ever logged
+static thread_local LOG_RING_PTR pring{nullptr};    // the calling thread's
+
+static std::string log_prefix;                  // leads every line; who's talking
+static FILE *plog{nullptr};                     // where the lines go
+static std::thread drainer;
+static std::atomic<bool> blog_stop{false};
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the conversion a '%' starts; the same way for the thread logging and the drainer so they always agree
+ *  on what arguments a format takes
+ *
+ * @param [p] the '%'
+ * @param [spec] out: the conversion
+ */
+static void Parse_Spec(const char *p, LOG_SPEC &spec)
+{
+    size_t i{1};
+    spec.stars = 0;
+    spec.size = 0;
+
+    while (p[i] && strchr("-+ #0'", p[i]))
+        i++;
+
+    if (p[i] == '*')
+    {
+        spec.stars++;
+        i++;
+    } // end if width given
+    else while (isdigit((u8)p[i]))
+        i++;
+
+    if (p[i] == '.')
+    {
+        if (p[++i] == '*')
+        {
+            spec.stars++;
+            i++;
+        } // end if precision given
+        else while (isdigit((u8)p[i]))
+            i++;
+    } // end if precision
+
+    spec.mod = i;
+    if (p[i] == 'h')
+        i += p[i + 1] == 'h' ? 2 : 1;       // promoted to int all the same
+    else if (p[i] == 'l')
+    {
+        spec.size = p[i + 1] == 'l' ? 'L' : 'l';
+        i += p[i + 1] == 'l' ? 2 : 1;
+    } // end if long
+    else if (p[i] && strchr("zjt", p[i]))
+        spec.size = p[i++];
+    else if (p[i] == 'L')
+    {
+        spec.size = 'D';
+        i++;
+    } // end if long double
+
+    spec.conv = p[i] && strchr("diuoxXcspfFeEgGaAn%", p[i]) ? p[i] : 0;
+    spec.len = i + 1;
+} // end Parse_Spec
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The calling thread's ring; one's made the first time round
+ */
+static LOG_RING_PTR Ring()
+{
+    if (pring)
+        return pring;
+
+    pring = new LOG_RING;
+    std::lock_guard<std::mutex> lock(log_lock);
+    vrings.push_back(pring);
+    return pring;
+} // end Ring
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes room for a record in the calling thread's ring; one that won't fit before the end of it goes at the
+ *  start (past a LOG_SKIP). It's in for the drainer to see once the new tail is stored.
+ *
+ * @param [pr] the ring
+ * @param [size] the record; a multiple of 8
+ * @param [tail] out: the tail to store once it's written
+ *
+ * @return char*
+ *  where it goes or nullptr if the ring's too full; dropped and counted that is
+ */
+static char *Reserve(LOG_RING_PTR pr, const size_t size, u64 &tail)
+{
+    u64 at = pr->tail.load(std::memory_order_relaxed);
+    size_t off = at & (LOG_RING_SIZE - 1);
+    size_t skip = size > LOG_RING_SIZE - off ? LOG_RING_SIZE - off : 0;
+    if (at + skip + size - pr->head.load(std::memory_order_acquire) > LOG_RING_SIZE)
+    {
+        pr->dropped.store(pr->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return nullptr;
+    } // end if full
+
+    if (skip)
+    {
+        LOG_REC_PTR prec = (LOG_REC_PTR)(pr->vbuf + off);
+        prec->size = (u32)skip;
+        prec->kind = LOG_SKIP;
+        off = 0;
+    } // end if wrapping
+
+    tail = at + skip + size;
+    return pr->vbuf + off;
+} // end Reserve
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Wall clock in micro-seconds; what a record is stamped with
+ */
+static u64 Stamp()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+} // end Stamp
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Logs a line; its format is kept by address (so it must be a literal) and its arguments as they are, nothing
+ *  gets formatted here. The caller checks the level before it gets this far.
+ *
+ * @param [fmt] printf style format
+ * @param [args] its arguments
+ */
+void Log_Print(const char *fmt, va_list args)
+{
+    alignas(8) char rec[LOG_REC_MAX];
+    size_t at = sizeof(LOG_REC);
+
+    // one 8 byte slot an argument; a string is its length and then itself
+    auto put = [&rec, &at](const u64 val) -> bool
+    {
+        if (at + sizeof(u64) > LOG_REC_MAX)
+            return false;
+
+        memcpy(rec + at, &val, sizeof(u64));
+        at += sizeof(u64);
+        return true;
+    }; // end put
+
+    for (const char *p = fmt; *p; p++)
+    {
+        if (*p != '%')
+            continue;
+
+        LOG_SPEC spec;
+        Parse_Spec(p, spec);
+        if (!spec.conv)
+            break;          // no telling what follows; the drainer stops right here too
+
+        p += spec.len - 1;
+        bool bput{true};
+        for (int i = 0; i < spec.stars; i++)
+            bput = put((u64)(s64)va_arg(args, int)) && bput;
+
+        switch (spec.conv)
+        {
+            case '%':
+                break;
+
+            case 'd': case 'i':
+                switch (spec.size)
+                {
+                    case 'l': bput = put((u64)(s64)va_arg(args, long)) && bput; break;
+                    case 'L': bput = put((u64)(s64)va_arg(args, long long)) && bput; break;
+                    case 'z': bput = put((u64)(s64)va_arg(args, ssize_t)) && bput; break;
+                    case 'j': bput = put((u64)(s64)va_arg(args, intmax_t)) && bput; break;
+                    case 't': bput = put((u64)(s64)va_arg(args, ptrdiff_t)) && bput; break;
+                    default: bput = put((u64)(s64)va_arg(args, int)) && bput; break;
+                } // end switch
+                break;
+
+            case 'u': case 'o': case 'x': case 'X':
+                switch (spec.size)
+                {
+                    case 'l': bput = put((u64)va_arg(args, unsigned long)) && bput; break;
+                    case 'L': bput = put((u64)va_arg(args, unsigned long long)) && bput; break;
+                    case 'z': bput = put((u64)va_arg(args, size_t)) && bput; break;
+                    case 'j': bput = put((u64)va_arg(args, uintmax_t)) && bput; break;
+                    case 't': bput = put((u64)va_arg(args, ptrdiff_t)) && bput; break;
+                    default: bput = put((u64)va_arg(args, unsigned)) && bput; break;
+                } // end switch
+                break;
+
+            case 'c':
+                bput = put((u64)va_arg(args, int)) && bput;
+                break;
+
+            case 'p': case 'n':
+                bput = put((u64)(uintptr_t)va_arg(args, void *)) && bput;
+                break;
+
+            case 's':
+            {
+                const char *str = va_arg(args, const char *);
+                u64 len = str ? strnlen(str, LOG_STR_MAX) : UINT64_MAX;
+                if (str && at + sizeof(u64) + len > LOG_REC_MAX)
+                    len = at + sizeof(u64) < LOG_REC_MAX ? LOG_REC_MAX - at - sizeof(u64) : 0;
+
+                if ( (bput = put(len) && bput) && str)
+                {
+                    memcpy(rec + at, str, len);
+                    at += (len + 7) & ~(u64)7;
+                } // end if room
+            } break;
+
+            default:    // floating point
+            {
+                double val = spec.size == 'D' ? (double)va_arg(args, long double) : va_arg(args, double);
+                u64 bits;
+                memcpy(&bits, &val, sizeof(bits));
+                bput = put(bits) && bput;
+            } break;
+        } // end switch
+
+        if (!bput)
+            break;          // out of room; the rest of the arguments are left out
+    } // end for
+
+    at = std::min<size_t>((at + 7) & ~(size_t)7, LOG_REC_MAX);
+    LOG_REC_PTR prec = (LOG_REC_PTR)rec;
+    prec->size = (u32)at;
+    prec->kind = LOG_TEXT;
+    prec->us = Stamp();
+    prec->fmt = fmt;
+
+    LOG_RING_PTR pr = Ring();
+    u64 tail;
+    char *dst = Reserve(pr, at, tail);
+    if (!dst)
+        return;
+
+    memcpy(dst, rec, at);
+    pr->tail.store(tail, std::memory_order_release);
+} // end Log_Print
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Logs bytes to be dumped in hex alongside their ASCII; much like hex viewers do. Those longer than
+ *  LOG_HEX_MAX aren't.
+ *
+ * @param [buf] the bytes
+ * @param [len] how many
+ */
+void Log_Hex(const char *buf, const size_t len)
+{
+    if (len > LOG_HEX_MAX)
+        return;
+
+    size_t size = (sizeof(LOG_REC) + sizeof(u64) + len + 7) & ~(size_t)7;
+    LOG_RING_PTR pr = Ring();
+    u64 tail;
+    char *dst = Reserve(pr, size, tail);
+    if (!dst)
+        return;
+
+    LOG_REC_PTR prec = (LOG_REC_PTR)dst;
+    prec->size = (u32)size;
+    prec->kind = LOG_HEX;
+    prec->us = Stamp();
+    prec->fmt = nullptr;
+
+    u64 len64 = len;
+    memcpy(dst + sizeof(LOG_REC), &len64, sizeof(u64));
+    memcpy(dst + sizeof(LOG_REC) + sizeof(u64), buf, len);
+    pr->tail.store(tail, std::memory_order_release);
+} // end Log_Hex
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats one argument of a record the way its conversion says; the widths and precisions given as arguments
+ *  go ahead of it
+ */
+template <typename T>
+static void Put_Arg(std::string &out, const char *conv, const int *pstars, const int stars, const T val)
+{
+    char buf[LOG_STR_MAX + 64];
+    int n;
+    if (stars == 0)
+        n = snprintf(buf, sizeof(buf), conv, val);
+    else if (stars == 1)
+        n = snprintf(buf, sizeof(buf), conv, pstars[0], val);
+    else
+        n = snprintf(buf, sizeof(buf), conv, pstars[0], pstars[1], val);
+
+    if (n > 0)
+        out.append(buf, std::min((size_t)n, sizeof(buf) - 1));
+} // end Put_Arg
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats a LOG_TEXT record; its format walked the same way Log_Print did
+ *
+ * @param [out] where it goes
+ * @param [prec] the record
+ */
+static void Put_Text(std::string &out, const LOG_REC_PTR prec)
+{
+    const char *args = (const char *)prec + sizeof(LOG_REC);
+    const char *end = (const char *)prec + prec->size;
+    auto get = [&args, end](u64 &val) -> bool
+    {
+        if (args + sizeof(u64) > end)
+            return false;
+
+        memcpy(&val, args, sizeof(u64));
+        args += sizeof(u64);
+        return true;
+    }; // end get
+
+    const char *p = prec->fmt;
+    while (*p)
+    {
+        const char *pct = strchr(p, '%');
+        if (!pct)
+        {
+            out += p;
+            break;
+        } // end if no more
+
+        out.append(p, pct - p);
+        LOG_SPEC spec;
+        Parse_Spec(pct, spec);
+        if (!spec.conv)
+        {
+            out += pct;
+            break;
+        } // end if beyond us
+
+        p = pct + spec.len;
+        if (spec.conv == '%')
+        {
+            out += '%';
+            continue;
+        } // end if a percent
+
+        u64 val{0};
+        int stars[2]{0, 0};
+        bool bok{true};
+        for (int i = 0; i < spec.stars && bok; i++)
+        {
+            bok = get(val);
+            stars[i] = (int)(s64)val;
+        } // end for
+
+        if (!bok || !get(val))
+            break;          // cut short; it was out of room
+
+        // the integers are all passed as long long; the rest of the conversion is as it came
+        char conv[32];
+        size_t keep = std::min(spec.mod, sizeof(conv) - 4);
+        memcpy(conv, pct, keep);
+        conv[keep] = '\0';
+        switch (spec.conv)
+        {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                snprintf(conv + keep, sizeof(conv) - keep, "ll%c", spec.conv);
+                Put_Arg(out, conv, stars, spec.stars, (long long)val);
+                break;
+
+            case 'c':
+                snprintf(conv + keep, sizeof(conv) - keep, "c");
+                Put_Arg(out, conv, stars, spec.stars, (int)val);
+                break;
+
+            case 'p':
+                snprintf(conv + keep, sizeof(conv) - keep, "p");
+                Put_Arg(out, conv, stars, spec.stars, (void *)(uintptr_t)val);
+                break;
+
+            case 'n':
+                break;
+
+            case 's':
+            {
+                if (val == UINT64_MAX)
+                {
+                    out += "(null)";
+                    break;
+                } // end if no string
+
+                std::string str(args, std::min<u64>(val, end - args));
+                args += (val + 7) & ~(u64)7;
+                snprintf(conv + keep, sizeof(conv) - keep, "s");
+                Put_Arg(out, conv, stars, spec.stars, str.c_str());
+            } break;
+
+            default:
+            {
+                double dval;
+                memcpy(&dval, &val, sizeof(dval));
+                snprintf(conv + keep, sizeof(conv) - keep, "%c", spec.conv);
+                Put_Arg(out, conv, stars, spec.stars, dval);
+            } break;
+        } // end switch
+    } // end while
+} // end Put_Text
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats a LOG_HEX record; eight bytes a row, in hex and then as they are
+ *
+ * @param [out] where it goes
+ * @param [prec] the record
+ */
+static void Put_Hex(std::string &out, const LOG_REC_PTR prec)
+{
+    u64 len;
+    const u8 *p = (const u8 *)prec + sizeof(LOG_REC) + sizeof(u64);
+    memcpy(&len, (const char *)prec + sizeof(LOG_REC), sizeof(u64));
+
+    char buf[64];
+    out += "\n      ";
+    for (int i = 0; i < 8; i++)
+    {
+        snprintf(buf, sizeof(buf), "\033[36m%02X ", i);
+        out += buf;
+    } // end for
+    out += "\033[37m\n";
+
+    for (u64 row = 0; row < len; row += 8)
+    {
+        u64 n = std::min<u64>(8, len - row);
+        snprintf(buf, sizeof(buf), "\033[36m%04X:\033[37m ", (u16)row);
+        out += buf;
+        for (u64 j = 0; j < 8; j++)
+        {
+            if (j < n)
+                snprintf(buf, sizeof(buf), "%02X ", p[row + j]);
+            out += j < n ? buf : "   ";
+        } // end for
+
+        out += '\t';
+        for (u64 j = 0; j < n; j++)
+        {
+            out += isprint(p[row + j]) ? (char)p[row + j] : '.';
+            out += ". ";
+        } // end for
+        out += '\n';
+    } // end for
+
+    out += '\n';
+} // end Put_Hex
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats a record as a line of its own (a dump as several); the time it was logged, who logged it and what
+ */
+static void Put_Record(std::string &out, const LOG_REC_PTR prec)
+{
+    static time_t last{0};
+    static char when[16];
+    time_t sec = (time_t)(prec->us / 1000000);
+    if (sec != last)
+    {
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        strftime(when, sizeof(when), "%H:%M:%S", &tm);
+        last = sec;
+    } // end if a new second
+
+    char stamp[32];
+    snprintf(stamp, sizeof(stamp), "%s.%06u ", when, (u32)(prec->us % 1000000));
+    out += stamp;
+    out += log_prefix;
+    if (prec->kind == LOG_HEX)
+    {
+        out += " hex dump:";
+        Put_Hex(out, prec);
+        return;
+    } // end if dump
+
+    out += ' ';
+    Put_Text(out, prec);
+    out += ".\n";
+} // end Put_Record
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The record at the head of a ring; the LOG_SKIPs on the way are drained as they're found
+ *
+ * @return LOG_REC_PTR
+ *  the record or nullptr if the ring's empty
+ */
+static LOG_REC_PTR Head(LOG_RING_PTR pr)
+{
+    while (true)
+    {
+        u64 head = pr->head.load(std::memory_order_relaxed);
+        if (head == pr->tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        LOG_REC_PTR prec = (LOG_REC_PTR)(pr->vbuf + (head & (LOG_RING_SIZE - 1)));
+        if (prec->kind != LOG_SKIP)
+            return prec;
+
+        pr->head.store(head + prec->size, std::memory_order_release);
+    } // end while
+} // end Head
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out whatever all the rings have; oldest record first whichever ring it's in, then the count of those
+ *  that were dropped since the last time
+ *
+ * @return bool
+ *  false if there was nothing
+ */
+static bool Drain()
+{
+    static std::string out;
+    std::vector<LOG_RING_PTR> vall;
+    {
+        std::lock_guard<std::mutex> lock(log_lock);
+        vall = vrings;
+    } // end lock
+
+    bool bany{false};
+    while (true)
+    {
+        LOG_RING_PTR pfirst{nullptr};
+        LOG_REC_PTR prec{nullptr};
+        for (auto pr : vall)
+        {
+            LOG_REC_PTR p = Head(pr);
+            if (p && (!prec || p->us < prec->us))
+            {
+                pfirst = pr;
+                prec = p;
+            } // end if earlier
+        } // end for
+
+        if (!prec)
+            break;
+
+        Put_Record(out, prec);
+        pfirst->head.store(pfirst->head.load(std::memory_order_relaxed) + prec->size, std::memory_order_release);
+        bany = true;
+        if (out.size() >= LOG_OUT_BATCH)
+        {
+            fwrite(out.data(), 1, out.size(), plog);
+            out.clear();
+        } // end if plenty
+    } // end while
+
+    for (auto pr : vall)
+    {
+        u64 dropped = pr->dropped.load(std::memory_order_relaxed);
+        if (dropped == pr->reported)
+            continue;
+
+        char line[128];
+        snprintf(line, sizeof(line), " %" PRIu64 " log record(s) dropped; the log couldn't keep up.\n",
+            dropped - pr->reported);
+        out += log_prefix;
+        out += line;
+        pr->reported = dropped;
+        bany = true;
+    } // end for
+
+    if (!out.empty())
+    {
+        fwrite(out.data(), 1, out.size(), plog);
+        fflush(plog);
+        out.clear();
+    } // end if something
+
+    return bany;
+} // end Drain
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The drainer; it goes through the rings for as long as they have anything and takes a nap once they don't
+ */
+static void Drain_Loop()
+{
+    while (!blog_stop.load(std::memory_order_relaxed))
+    {
+        if (!Drain())
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOG_IDLE_MS));
+    } // end while
+
+    Drain();
+} // end Drain_Loop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts the drainer; what's logged before this waits in the rings
+ *
+ * @param [prefix] leads every line
+ * @param [path] the file the lines go to (appended); nullptr or "" for stdout
+ */
+void Log_Init(const char *prefix, const char *path)
+{
+    log_prefix = prefix;
+    plog = stdout;
+    if (path && *path && !(plog = fopen(path, "a")))
+    {
+        perror(path);
+        plog = stdout;
+    } // end if no file
+
+    drainer = std::thread(Drain_Loop);
+    atexit(Log_Close);      // an exit() along the way still writes out what's left (and doesn't abort on it)
+} // end Log_Init
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Records dropped so far for want of room, all threads together
+ */
+u64 Log_Dropped()
+{
+    u64 dropped{0};
+    std::lock_guard<std::mutex> lock(log_lock);
+    for (auto pr : vrings)
+        dropped += pr->dropped.load(std::memory_order_relaxed);
+
+    return dropped;
+} // end Log_Dropped
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out what's left and stops the drainer
+ */
+void Log_Close()
+{
+    if (!drainer.joinable())
+        return;
+
+    blog_stop.store(true, std::memory_order_relaxed);
+    drainer.join();
+    if (plog != stdout)
+        fclose(plog);
+} // end Log_Close
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,278 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  A small LZ77 block codec in the manner of LZ4. A block is a run of sequences, each a token byte (literal
+//  count in the high nibble, match length less LZ_MIN_MATCH in the low one; 15 says more follows in bytes of
+//  255), the literals themselves, then a 2 byte little endian offset back to the match and the rest of its
+//  length. The last sequence is literals only.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "lz-codec.h"
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+#define LZ_TAIL             12          // no match starts this close to the end; it all goes as literals
+#define LZ_SKIP_TRIGGER     6           // every 2^this misses in a row the match finder steps one byte further
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static thread_local u32 hash_table[1 << LZ_HASH_LOG];      // where each hashed 4 bytes were last seen
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hashes the 4 bytes at p down to a table index of hlog bits
+ */
+static inline u32 Hash4(const u8 *p, const int hlog)
+{
+    u32 seq;
+    memcpy(&seq, p, sizeof(seq));
+    return (seq * 2654435761u) >> (32 - hlog);
+} // end Hash4
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out the rest of a length that didn't fit its nibble; bytes of 255 and whatever's left
+ */
+static inline u8 *Put_Length(u8 *op, size_t len)
+{
+    while (len >= 255)
+    {
+        *op++ = 255;
+        len -= 255;
+    } // end while
+
+    *op++ = (u8)len;
+    return op;
+} // end Put_Length
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Compresses a block. The match finder remembers only the last place each 4 byte sequence was seen, so it's
+ *  a single pass with no searching; the longer it goes without finding anything the bigger the steps it takes.
+ *
+ * @param [src] what to compress
+ * @param [len] how much of it
+ * @param [dst] where to
+ * @param [cap] room at dst; LZ_BOUND(len) always does
+ *
+ * @return size_t
+ *  the length of the block or 0 if it won't fit in cap
+ */
+size_t LZ_Compress(const char *src, const size_t len, char *dst, const size_t cap)
+{
+    const u8 *base = (const u8 *)src;
+    const u8 *end = base + len;
+    const u8 *anchor = base;            // start of the literals yet to be written out
+    const u8 *ip = base;
+    u8 *op = (u8 *)dst;
+    u8 *oend = op + cap;
+
+    // a smaller table for smaller blocks; it's cleared on every call
+    int hlog = LZ_HASH_LOG;
+    while (hlog > 8 && ((size_t)1 << (hlog - 2)) > len)
+        hlog--;
+    memset(hash_table, 0, sizeof(u32) << hlog);
+
+    if (len > LZ_TAIL)
+    {
+        const u8 *mflimit = end - LZ_TAIL;
+        u32 misses{0};
+        while (ip < mflimit)
+        {
+            u32 h = Hash4(ip, hlog);
+            const u8 *ref = base + hash_table[h];
+            hash_table[h] = (u32)(ip - base);
+
+            if (ref >= ip || ip - ref > LZ_MAX_OFFSET || memcmp(ref, ip, LZ_MIN_MATCH))
+            {
+                ip += 1 + (misses++ >> LZ_SKIP_TRIGGER);
+                continue;
+            } // end if no match
+
+            misses = 0;
+            size_t offset = ip - ref;
+
+            // it may well have started a little earlier
+            while (ip > anchor && ref > base && ip[-1] == ref[-1])
+            {
+                ip--;
+                ref--;
+            } // end while
+
+            const u8 *mstart = ip;
+            ip += LZ_MIN_MATCH;
+            ref += LZ_MIN_MATCH;
+            while (ip < end - 5 && *ip == *ref)
+            {
+                ip++;
+                ref++;
+            } // end while
+
+            size_t lit = mstart - anchor;
+            size_t mlen = ip - mstart - LZ_MIN_MATCH;
+            if (op + 1 + lit + lit / 255 + 1 + 2 + mlen / 255 + 1 > oend)
+                return 0;
+
+            u8 *token = op++;
+            *token = (u8)((lit >= 15 ? 15 : lit) << 4);
+            if (lit >= 15)
+                op = Put_Length(op, lit - 15);
+            memcpy(op, anchor, lit);
+            op += lit;
+
+            *op++ = (u8)(offset & 0xFF);
+            *op++ = (u8)(offset >> 8);
+
+            *token |= (u8)(mlen >= 15 ? 15 : mlen);
+            if (mlen >= 15)
+                op = Put_Length(op, mlen - 15);
+
+            anchor = ip;
+            if (ip < mflimit)
+                hash_table[Hash4(ip - 2, hlog)] = (u32)(ip - 2 - base);     // helps the next one along
+        } // end while
+    } // end if long enough
+
+    // whatever's left goes as literals
+    size_t lit = end - anchor;
+    if (op + 1 + lit + lit / 255 + 1 > oend)
+        return 0;
+
+    *op++ = (u8)((lit >= 15 ? 15 : lit) << 4);
+    if (lit >= 15)
+        op = Put_Length(op, lit - 15);
+    memcpy(op, anchor, lit);
+    op += lit;
+
+    return op - (u8 *)dst;
+} // end LZ_Compress
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Decompresses a block written by LZ_Compress. It comes off the wire, so every length and offset in it is
+ *  checked against both ends; a block that doesn't add up is refused rather than trusted.
+ *
+ * @param [src] the block
+ * @param [len] its length
+ * @param [dst] where to
+ * @param [cap] room at dst
+ *
+ * @return int
+ *  bytes written out or -1 if the block is bad (or won't fit)
+ */
+int LZ_Decompress(const char *src, const size_t len, char *dst, const size_t cap)
+{
+    const u8 *ip = (const u8 *)src;
+    const u8 *iend = ip + len;
+    u8 *op = (u8 *)dst;
+    u8 *oend = op + cap;
+
+    while (ip < iend)
+    {
+        u8 token = *ip++;
+
+        // literals
+        size_t lit = token >> 4;
+        if (lit == 15)
+        {
+            u8 b;
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                lit += b;
+            } while (b == 255);
+        } // end if long run
+
+        if ((size_t)(iend - ip) < lit || (size_t)(oend - op) < lit)
+            return -1;
+
+        memcpy(op, ip, lit);
+        ip += lit;
+        op += lit;
+
+        if (ip == iend)
+            break;      // the last sequence has no match
+
+        // the match
+        if (iend - ip < 2)
+            return -1;
+
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - (u8 *)dst))
+            return -1;
+
+        size_t mlen = token & 0x0F;
+        if (mlen == 15)
+        {
+            u8 b;
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                mlen += b;
+            } while (b == 255);
+        } // end if long match
+
+        mlen += LZ_MIN_MATCH;
+        if ((size_t)(oend - op) < mlen)
+            return -1;
+
+        const u8 *ref = op - offset;
+        if (offset >= mlen)
+        {
+            memcpy(op, ref, mlen);
+            op += mlen;
+        } // end if apart
+        else
+        {
+            // overlapping; it repeats what it's just written out
+            while (mlen--)
+                *op++ = *ref++;
+        } // end else
+    } // end while
+
+    return (int)(op - (u8 *)dst);
+} // end LZ_Decompress
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,365 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  The counters and their endpoint; see metrics.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "metrics.h"
+#include "logger.h"
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A histogram as read at scrape time; those of several threads added up
+ */
+typedef struct HIST_SNAP_FMT
+{
+    u64 vcount[METRICS_BUCKETS]{};
+    u64 sum{0};
+} HIST_SNAP, *HIST_SNAP_PTR;
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static METRICS metrics_sink;                            // what threads that aren't counted count into
+thread_local METRICS_PTR pmetrics{&metrics_sink};
+
+static std::mutex metrics_lock;                         // guards the list below; never taken while counting
+static std::vector<METRICS_PTR> vmetrics;               // every reactor thread's, in the order they came
+
+static thread_local int metrics_fd{-1};                 // the listener; only on the thread serving it
+static thread_local std::vector<int> vclients;          // scrapes yet to say what they're after
+static thread_local METRICS_CB on_render{nullptr};      // the buddy's own gauges
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Has the calling thread count into a METRICS of its own from here on; once per reactor thread (see
+ *  Reactor_Init). They're kept for as long as the process is.
+ */
+void Metrics_Thread()
+{
+    if (pmetrics != &metrics_sink)
+        return;
+
+    pmetrics = new METRICS();       // value initialized; zeroed that is
+    std::lock_guard<std::mutex> lock(metrics_lock);
+    vmetrics.push_back(pmetrics);
+} // end Metrics_Thread
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts serving the metrics on the loopback interface off the calling thread's reactor; its loop is to hand
+ *  every event to Metrics_Event
+ *
+ * @param [port] the port
+ * @param [cb] adds the buddy's own to every scrape; nullptr for none
+ *
+ * @return bool
+ *  false if the port can't be had
+ */
+bool Metrics_Listen(const u16 port, METRICS_CB cb)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = HTONS(port);
+    addr.sin_addr.s_addr = HTONL(INADDR_LOOPBACK);     // never off the box
+
+    int fd = Socket();
+    Tcp_Reuse_Addr(fd);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0)
+    {
+        perror("metrics");
+        close(fd);
+        return false;
+    } // end if no port
+
+    metrics_fd = fd;
+    on_render = cb;
+    Reactor_Add(fd, EV_READ);
+    return true;
+} // end Metrics_Listen
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes the event if it's the metrics listener's or one of its scrapes'. A scrape is answered as soon as it
+ *  asks and closed right behind the answer (which goes out on its own as the socket takes it).
+ *
+ * @param [ev] the ready event
+ *
+ * @return bool
+ *  true if it was one of ours
+ */
+bool Metrics_Event(const REACTOR_EVENT &ev)
+{
+    if (metrics_fd < 0)
+        return false;
+
+    if (ev.fd == metrics_fd)
+    {
+        char addr_str[INET_ADDRSTRLEN];
+        u16 port;
+        int fd = Accept(metrics_fd, addr_str, port);
+        if (fd > 0)
+            vclients.push_back(fd);
+        return true;
+    } // end if a new scrape
+
+    auto it = std::find(vclients.begin(), vclients.end(), ev.fd);
+    if (it == vclients.end())
+        return false;
+
+    vclients.erase(it);
+    char req[1024];
+    ssize_t bytes = recv(ev.fd, req, sizeof(req) - 1, MSG_DONTWAIT);
+    if (bytes > 0)
+    {
+        req[bytes] = '\0';
+        std::string body, head;
+        if (!strncmp(req, "GET /metrics", 12) || !strncmp(req, "GET / ", 6))
+        {
+            Metrics_Render(body);
+            head = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n";
+        } // end if metrics
+        else
+        {
+            body = "not found\n";
+            head = "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n";
+        } // end else
+
+        head += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+        Send(ev.fd, head.data(), head.size());
+        Send(ev.fd, body.data(), body.size());
+    } // end if asked
+
+    CLOSE(ev.fd);
+    Erase_Sock(ev.fd);
+    return true;
+} // end Metrics_Event
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds the histogram of a thread to the snapshot
+ */
+static void Snap(HIST_SNAP &snap, const METRICS_HIST &hist)
+{
+    for (int i = 0; i < METRICS_BUCKETS; i++)
+        snap.vcount[i] += hist.vcount[i].load(std::memory_order_relaxed);
+
+    snap.sum += hist.sum.load(std::memory_order_relaxed);
+} // end Snap
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out the # HELP and # TYPE of a metric
+ */
+static void Put_Help(std::string &out, const char *name, const char *type, const char *help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+} // end Put_Help
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out a sample of a counter or gauge
+ *
+ * @param [out] the scrape
+ * @param [name] the metric
+ * @param [labels] its labels as they go between the braces; "" for none
+ * @param [value] the value
+ */
+static void Put_Value(std::string &out, const char *name, const char *labels, const s64 value)
+{
+    char line[256];
+    snprintf(line, sizeof(line), *labels ? "%s{%s} %" PRId64 "\n" : "%s%s %" PRId64 "\n", name, labels, value);
+    out += line;
+} // end Put_Value
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out a histogram; its buckets made cumulative and the bounds scaled to the unit it goes in
+ *
+ * @param [out] the scrape
+ * @param [name] the metric
+ * @param [labels] its labels as they go between the braces; "" for none
+ * @param [snap] the histogram
+ * @param [shift] what it was counted with (METRICS_SHIFT_xxx)
+ * @param [scale] a bound times this is what goes out (1e-6 turns micro-seconds into seconds)
+ */
+static void Put_Hist(std::string &out, const char *name, const char *labels, const HIST_SNAP &snap,
+    const u8 shift, const double scale)
+{
+    char line[320];
+    const char *sep = *labels ? "," : "";
+    u64 total{0};
+    for (int i = 0; i < METRICS_BUCKETS; i++)
+    {
+        total += snap.vcount[i];
+        if (i == METRICS_BUCKETS - 1)
+            snprintf(line, sizeof(line), "%s_bucket{%s%sle=\"+Inf\"} %" PRIu64 "\n", name, labels, sep, total);
+        else
+            snprintf(line, sizeof(line), "%s_bucket{%s%sle=\"%g\"} %" PRIu64 "\n", name, labels, sep,
+                (double)((u64)1 << (shift + i)) * scale, total);
+        out += line;
+    } // end for
+
+    char sum[32];
+    if (scale == 1)
+        snprintf(sum, sizeof(sum), "%" PRIu64, snap.sum);
+    else
+        snprintf(sum, sizeof(sum), "%.9g", (double)snap.sum * scale);
+
+    snprintf(line, sizeof(line), *labels ? "%s_sum{%s} %s\n%s_count{%s} %" PRIu64 "\n" :
+        "%s_sum%s %s\n%s_count%s %" PRIu64 "\n", name, labels, sum, name, labels, total);
+    out += line;
+} // end Put_Hist
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The scrape; the tunnel and the streams summed over all the threads, the reactors thread by thread (as
+ *  thread="n", in the order they started), then whatever the buddy adds of its own
+ *
+ * @param [out] where it goes
+ */
+void Metrics_Render(std::string &out)
+{
+    std::vector<METRICS_PTR> vall;
+    {
+        std::lock_guard<std::mutex> lock(metrics_lock);
+        vall = vmetrics;
+    } // end lock
+
+    u64 frames[2]{}, bytes[2]{}, failed{0}, opened{0}, closed{0}, lost{0}, resumed{0};
+    HIST_SNAP frame_bytes[2], connect_us;
+    for (auto pm : vall)
+    {
+        for (int dir : {METRICS_TX, METRICS_RX})
+        {
+            frames[dir] += pm->frames[dir].load(std::memory_order_relaxed);
+            bytes[dir] += pm->bytes[dir].load(std::memory_order_relaxed);
+            Snap(frame_bytes[dir], pm->frame_bytes[dir]);
+        } // end for
+
+        failed += pm->connects_failed.load(std::memory_order_relaxed);
+        Snap(connect_us, pm->connect_us);
+        opened += pm->streams_opened.load(std::memory_order_relaxed);
+        closed += pm->streams_closed.load(std::memory_order_relaxed);
+        lost += pm->links_lost.load(std::memory_order_relaxed);
+        resumed += pm->links_resumed.load(std::memory_order_relaxed);
+    } // end for
+
+    const char *dirs[2]{"dir=\"tx\"", "dir=\"rx\""};
+    Put_Help(out, "jw_tunnel_frames_total", "counter", "INTAP frames down (tx) and off (rx) the tunnel.");
+    for (int dir : {METRICS_TX, METRICS_RX})
+        Put_Value(out, "jw_tunnel_frames_total", dirs[dir], frames[dir]);
+
+    Put_Help(out, "jw_tunnel_payload_bytes_total", "counter", "Payload carried by those frames, uncompressed.");
+    for (int dir : {METRICS_TX, METRICS_RX})
+        Put_Value(out, "jw_tunnel_payload_bytes_total", dirs[dir], bytes[dir]);
+
+    Put_Help(out, "jw_tunnel_frame_payload_bytes", "histogram", "Payload length of a frame.");
+    for (int dir : {METRICS_TX, METRICS_RX})
+        Put_Hist(out, "jw_tunnel_frame_payload_bytes", dirs[dir], frame_bytes[dir], METRICS_SHIFT_BYTES, 1);
+
+    Put_Help(out, "jw_upstream_connect_seconds", "histogram", "Time upstream connects took to go through.");
+    Put_Hist(out, "jw_upstream_connect_seconds", "", connect_us, METRICS_SHIFT_US, 1e-6);
+    Put_Help(out, "jw_upstream_connect_failures_total", "counter", "Upstream connects that failed.");
+    Put_Value(out, "jw_upstream_connect_failures_total", "", failed);
+
+    Put_Help(out, "jw_tunnel_links_lost_total", "counter", "Tunnel links that lost their connection.");
+    Put_Value(out, "jw_tunnel_links_lost_total", "", lost);
+    Put_Help(out, "jw_tunnel_links_resumed_total", "counter", "Tunnel links taken up again over a new connection.");
+    Put_Value(out, "jw_tunnel_links_resumed_total", "", resumed);
+
+    Put_Help(out, "jw_streams_opened_total", "counter", "Streams opened.");
+    Put_Value(out, "jw_streams_opened_total", "", opened);
+    Put_Help(out, "jw_streams_active", "gauge", "Streams open right now.");
+    Put_Value(out, "jw_streams_active", "", (s64)(opened - closed));
+
+    char label[32];
+    Put_Help(out, "jw_reactor_wakeups_total", "counter", "Times the reactor came back from waiting.");
+    for (size_t i = 0; i < vall.size(); i++)
+    {
+        snprintf(label, sizeof(label), "thread=\"%zu\"", i);
+        Put_Value(out, "jw_reactor_wakeups_total", label, vall[i]->wakeups.load(std::memory_order_relaxed));
+    } // end for
+
+    Put_Help(out, "jw_reactor_events", "histogram", "Events the reactor came back with per wakeup.");
+    for (size_t i = 0; i < vall.size(); i++)
+    {
+        HIST_SNAP snap;
+        Snap(snap, vall[i]->events);
+        snprintf(label, sizeof(label), "thread=\"%zu\"", i);
+        Put_Hist(out, "jw_reactor_events", label, snap, METRICS_SHIFT_ONE, 1);
+    } // end for
+
+    Put_Help(out, "jw_reactor_loop_seconds", "histogram", "Time an event loop iteration took, waiting aside.");
+    for (size_t i = 0; i < vall.size(); i++)
+    {
+        HIST_SNAP snap;
+        Snap(snap, vall[i]->loop_us);
+        snprintf(label, sizeof(label), "thread=\"%zu\"", i);
+        Put_Hist(out, "jw_reactor_loop_seconds", label, snap, METRICS_SHIFT_US, 1e-6);
+    } // end for
+
+    Put_Help(out, "jw_log_dropped_total", "counter", "Log records dropped for want of room (see Log_Print).");
+    Put_Value(out, "jw_log_dropped_total", "", (s64)Log_Dropped());
+
+    if (on_render)
+        on_render(out);
+} // end Metrics_Render
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -12,7 +12,7 @@
 //  13th of Feburary 2023, Monday
 //
 // Last Updated:
-//  13th of Feburary 2023, Monday
+//  17th of October 2026, Saturday
 //
 // NOTES:
 //  In linux using g++ (however choice C/C++ compiler is not imposed) compile as (in realse mode):
@@ -27,18 +27,112 @@
 // INCLUDES
 //==============================================================================================================|
 #include "net-wrappers.h"
+#include "io-uring.h"
+#include "mpsc-queue.h"
+#include "lz-codec.h"
+#include "buf-pool.h"
+#include "egress-sched.h"
+#include "metrics.h"
+
 
 
 //==============================================================================================================|
 // DEFINES
 //==============================================================================================================|
+// sends never block and never raise SIGPIPE; systems without the flags get as close as they can
+#if !defined (MSG_NOSIGNAL)
+#define MSG_NOSIGNAL    0
+#endif
+#if !defined (MSG_DONTWAIT)
+#define MSG_DONTWAIT    0
+#endif
 
-
+#define LINGER_TICK     1000        // how often (milli-seconds) lingering descriptors are checked on
 
 
 //==============================================================================================================|
 // TYPES
 //==============================================================================================================|
+/**
+ * @brief 
+ *  A frame on its way down a compressing link (see Intap_Send). The big ones are compressed on the pool while
+ *  whatever is sent to the link after them waits its turn, so that a link's frames always go out in the order
+ *  they were sent in.
+ */
+typedef struct LZ_FRAME_FMT
+{
+    int fd{-1};             // the link; -1 once it's been closed under it (then it's just thrown away)
+    bool bdone{false};      // ready to go out
+    INTAP_FMT intap;        // the header; for those to be compressed
+    int version{INTAP_V2};  // and the version it goes in
+    std::string plain;      // the payload as is; likewise
+    std::string frame;      // the frame as it goes out
+    size_t off{0};          // where in frame it starts
+    size_t bytes{0};        // what it counts for in the link's lzq_bytes till it goes
+    MPSC_QUEUE<LZ_FRAME_FMT*> *powner{nullptr};     // the reactor thread it goes back to once compressed
+} LZ_FRAME, *LZ_FRAME_PTR;
+
+
+
+/**
+ * @brief 
+ *  What's gone down a tunnel link that the peer is yet to say it got (see Intap_Replay); it goes down again from
+ *  where the peer says it left off once a lost link is resumed. Both ends count the bytes from the first one 
+ *  after the hello, so where either is at is known by the count alone.
+ */
+typedef struct LINK_REPLAY_FMT
+{
+    char *pbuf{nullptr};    // the bytes; a pooled buffer only while there are any
+    size_t size{0};         //  and how big it is
+    size_t off{0};          // where the first one the peer is yet to get is in it
+    size_t len{0};          // and one past the last
+    u64 sent{0};            // bytes sent down the link all told (those still queued too)
+    u64 acked{0};           // of those the peer said it got; pbuf picks up right after them
+    size_t max{0};          // the most kept; 0 keeps none (the link can't be resumed)
+    bool bbroken{false};    // more than that went unacknowledged; it can't be resumed anymore
+} LINK_REPLAY, *LINK_REPLAY_PTR;
+
+
+
+/**
+ * @brief 
+ *  Book keeping for each descriptor registered with the reactor; the table is indexed by the descriptor
+ *  itself so every lookup is but a single array access.
+ */
+typedef struct REACTOR_SLOT_FMT
+{
+    bool bused{false};      // is this descriptor registered?
+    u32 events{0};          // what we are waiting on
+    u32 gen{0};             // bumped everytime the slot is released
+    void *ctx{nullptr};     // the caller's context pointer
+    size_t index{0};        // position inside vpoll (only used by the poll() backend)
+    u32 armed{0};           // what the backend is actually waiting on; events plus writability if queued
+
+    char *poutq{nullptr};   // bytes Send() took but the socket didn't (yet); a pooled buffer only while there are
+    size_t outq_size{0};    //  any, and how big it is
+    size_t outq_len{0};     // how much of it is queued
+    size_t outq_off{0};     // and how much of that has gone out already
+    bool bdirty{false};     // waiting for the batched send at the end of the loop iteration
+    bool bcoalesce{false};  // sends wait for the end of the loop iteration, even off io_uring (Send_Coalesce)
+    bool bnonblock{false};  // switched to non-blocking mode for splicing (see Intap_Splice)
+    bool bcongested{false}; // went over SEND_HIGH_WATER and is yet to come back under SEND_LOW_WATER
+    bool bfailed{false};    // a send failed; nothing more goes and the caller gets an error event
+    bool blinger{false};    // closed by the caller but kept open till its queue drains
+    u64 linger_deadline{0}; // when we stop waiting on it to drain
+
+    size_t lz_min{0};       // frames sent with Intap_Send() are compressed from this long on (0 never)
+    std::vector<LZ_FRAME_PTR> lzq;  // frames still being compressed and those waiting behind them
+    size_t lzq_bytes{0};    // and how long they are (before compressing)
+
+    EGRESS_SCHED_PTR psched{nullptr};   // frames held back for their turn (see Intap_Schedule); if scheduling
+    bool breleasing{false};             // letting them out right now (see Egress_Release)
+
+    u64 connect_us{0};      // when a connect still on its way got started (Now_Us() based); 0 for none
+
+    LINK_REPLAY_PTR preplay{nullptr};   // what's gone down a tunnel link unacknowledged (see Intap_Replay)
+    bool bparked{false};                // a tunnel link that lost its connection; sends are only kept for when
+                                        //  it's resumed (see Intap_Park)
+} REACTOR_SLOT, *REACTOR_SLOT_PTR;
 
 
 
@@ -46,8 +140,25 @@
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
-std::vector<struct pollfd> vpoll;       // vector of poll structus
-struct pollfd fdpoll;                   // a generalized storage
+// each reactor thread runs its own reactor; hence the state is per thread
+static thread_local std::vector<REACTOR_SLOT> vslots;   // descriptor indexed context table
+static thread_local std::vector<struct pollfd> vpoll;   // vector of poll structus (poll() backend only)
+static thread_local int epoll_fd{-1};                   // the epoll instance; -1 means we're running on poll()
+static thread_local std::vector<int> vdirty;            // descriptors with sends for the batched flush
+static thread_local int splice_pipe[2]{-1, -1};         // what spliced payloads pass through (see Intap_Splice)
+static thread_local std::vector<int> vfailed;           // descriptors whose sends failed; reported as errors
+static thread_local std::vector<int> vlinger;           // closed descriptors still draining their queues
+static thread_local std::vector<URING_SEND> vbatch;     // the batched flush itself
+static thread_local CONGESTION_CB on_congestion{nullptr};   // the caller's backpressure hook
+static thread_local MPSC_QUEUE<LZ_FRAME_PTR> *plz_done{nullptr};   // frames the pool is done compressing
+static thread_local u64 loop_us{0};                     // when the reactor last came back from waiting
+
+// the compression pool is shared by all the reactor threads; a queue for each worker fed round robin
+static std::vector<MPSC_QUEUE<LZ_FRAME_PTR>*> vlz_jobs;
+static std::atomic<u32> lz_next{0};
+
+static REACTOR_SLOT_PTR Slot(const int fd);
+static void Egress_Release(const int fd, REACTOR_SLOT_PTR pslot);     // Settle() lets frames out as a link drains
 
 
 
@@ -103,6 +214,194 @@ void Connect(int fds, const char *ip, const u16 port)
 } // end connect
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Starts a TCP connection without waiting on the handshake; the socket is left non-blocking till the connect
+ *  is done with (see Connect_Finish). Like those off Accept it goes without Nagle; what's relayed to it is
+ *  written as it comes and a request spanning writes mustn't wait on the upstream's delayed ACK.
+ * 
+ * @param [fds] the descriptor to connect 
+ * @param [ip] the ip address 
+ * @param [port] the the port number 
+ * 
+ * @return int
+ *  0 if connected right away (back in blocking mode), 1 if still in progress and -1 on error
+ */
+int Connect_Async(int fds, const char *ip, const u16 port)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;      // IPv4 family
+    addr.sin_port = HTONS(port);    // port # in network-byte-order
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0)
+    {
+        fprintf(stderr, "invalid address: %s\n", ip);
+        return -1;
+    } // end if no good address
+
+    Tcp_NoDelay(fds);
+    Set_Non_Blocking(fds);
+    if (connect(fds, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+    {
+        Set_Non_Blocking(fds, false);
+        Metrics_Observe(pmetrics->connect_us, 0, METRICS_SHIFT_US);
+        return 0;
+    } // end if done already
+
+#if defined(WIN32) || defined(_WIN64)
+    if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+    if (errno == EINPROGRESS)
+#endif
+    {
+        Slot(fds)->connect_us = Now_Us();
+        return 1;
+    } // end if on its way
+
+    perror("connect");
+    Metrics_Add(pmetrics->connects_failed, 1);
+    return -1;
+} // end Connect_Async
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Tells how a connect started with Connect_Async went once the socket turns writable; on success the socket
+ *  is put back into blocking mode like the rest.
+ * 
+ * @param [fds] the descriptor 
+ * 
+ * @return int
+ *  0 on success, -1 on failure (errno tells why)
+ */
+int Connect_Finish(int fds)
+{
+    int err{0};
+    socklen_t len = sizeof(err);
+
+    u64 started = Slot(fds)->connect_us;
+    Slot(fds)->connect_us = 0;
+    if (getsockopt(fds, SOL_SOCKET, SO_ERROR, (char*)&err, &len) < 0 || err)
+    {
+        if (err)
+            errno = err;
+        Metrics_Add(pmetrics->connects_failed, 1);
+        return -1;
+    } // end if failed
+
+    if (started)
+        Metrics_Observe(pmetrics->connect_us, Now_Us() - started, METRICS_SHIFT_US);
+    Set_Non_Blocking(fds, false);
+    return 0;
+} // end Connect_Finish
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Connect() for the ones that mustn't take the app down or hang on forever; such as the tunnel links as 
+ *  remote-buddy starts up. Blocks for no more than the time given; the socket's left in blocking mode either 
+ *  way.
+ * 
+ * @param [fds] the descriptor to connect 
+ * @param [ip] the ip address 
+ * @param [port] the the port number 
+ * @param [ms] how long it may take in milli-seconds
+ * 
+ * @return int
+ *  0 on success, -1 on failure (errno tells why)
+ */
+int Connect_Timeout(int fds, const char *ip, const u16 port, const int ms)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;      // IPv4 family
+    addr.sin_port = HTONS(port);    // port # in network-byte-order
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0)
+    {
+        fprintf(stderr, "invalid address: %s\n", ip);
+        errno = EINVAL;
+        return -1;
+    } // end if no good address
+
+    Set_Non_Blocking(fds);
+    int status = connect(fds, (struct sockaddr *)&addr, sizeof(addr));
+    if (status < 0 && errno == EINPROGRESS)
+    {
+        struct pollfd pfd{fds, POLLOUT, 0};
+        do
+        {
+            status = POLL_TIMEOUT(&pfd, 1, ms);
+        } while (status < 0 && errno == EINTR);
+
+        int err{0};
+        socklen_t len = sizeof(err);
+        if (status == 0)
+            err = ETIMEDOUT;
+        else if (status > 0 && getsockopt(fds, SOL_SOCKET, SO_ERROR, (char*)&err, &len) < 0)
+            err = errno;
+
+        if (err)
+            errno = err;
+        status = (status > 0 && !err) ? 0 : -1;
+    } // end if on its way
+
+    int saved = errno;
+    Set_Non_Blocking(fds, false);
+    errno = saved;
+    return status;
+} // end Connect_Timeout
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Monotonic clock in milli-seconds; for deadlines
+ */
+u64 Now_Ms()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Monotonic clock in micro-seconds; for timing things (see metrics.h)
+ */
+u64 Now_Us()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Us
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  How long the reactor may wait before the earliest of the pending connects runs out of time
+ * 
+ * @param [mconnecting] the pending connects 
+ * 
+ * @return int
+ *  time left in milli-seconds or -1 if nothing's pending (wait forever)
+ */
+int Connect_Wait_Ms(const std::unordered_map<int, CONNECT_WAIT> &mconnecting)
+{
+    if (mconnecting.empty())
+        return -1;
+
+    u64 now = Now_Ms(), earliest{UINT64_MAX};
+    for (auto &x : mconnecting)
+        earliest = std::min(earliest, x.second.deadline);
+
+    return earliest <= now ? 0 : (int)std::min<u64>(earliest - now, INT32_MAX);
+} // end Connect_Wait_Ms
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -171,11 +470,7 @@ int Accept(const int listen_fd, char *addr_str, u16 &port)
     port = NTOHS(addr.sin_port);
     Tcp_NoDelay(fd);
     Set_RecvTimeout(fd, 3);
-
-    memset(&fdpoll, 0, sizeof(fdpoll));
-    fdpoll.fd = fd;
-    fdpoll.events = POLLIN;
-    vpoll.push_back({fd, POLLIN, 0});
+    Reactor_Add(fd, EV_READ);
 
     return fd;
 } // end Accept
@@ -184,201 +479,2404 @@ int Accept(const int listen_fd, char *addr_str, u16 &port)
 //==============================================================================================================|
 /**
  * @brief 
- *  Sends the contents of the buffer over the connected socket
- * 
- * @param [fds] a descriptor 
- * @param [buf] buffer containing data 
- * @param [buf_len] length of buffer 
+ *  Returns the slot of a descriptor; grows the table as needed
  */
-void Send(int fds, const char *buf, const size_t buf_len)
+static REACTOR_SLOT_PTR Slot(const int fd)
 {
-    size_t bytes{0};      // sent thus far
-    char *alias = (char *)buf;
-
-    do {
-        bytes = send(fds, alias, buf_len - bytes, 0);
-
-        if (bytes < 0)
-        {
-            perror("send");
-            exit(0);
-        } // end if bytes
+    if ((size_t)fd >= vslots.size())
+        vslots.resize(fd + 64);
 
-        alias += bytes;
-    } while (bytes < buf_len);
-} // end Send
+    return &vslots[fd];
+} // end Slot
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Recievs incomming signal from peer on a given socket
- * 
- * @param [fds] the descriptor 
- * @param [buf] the buffer to get the data 
- * @param [buf_len] the length of buffer
- *  
- * @return int
- *  the number of bytes actually read 
+ *  Bytes queued up on the slot that are yet to go out
  */
-int Recv(int fds, char *buf, const size_t buf_len)
+static inline size_t Pending(const REACTOR_SLOT_PTR pslot)
 {
-    int bytes, total_bytes{0};
-    char *alias = buf;
-
-    do 
-    {
-        bytes = recv(fds, alias, buf_len - total_bytes, 0);
-        if (bytes == -1)
-        {
-            perror("recv");
-            break;
-        } // end if error or so
-
-        total_bytes += bytes;
-        alias += bytes;
-    } while (total_bytes < (int)buf_len); // end while
-
-    return total_bytes;
-} // end Recv
+    return pslot->outq_len - pslot->outq_off;
+} // end Pending
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Select based async socket multiplexing
- * 
- * @param [maxfdp] maximum descriptor 
- * @param [rset] the reading sets 
+ *  Bytes the slot has yet to send, counting the frames still held back by its scheduler or being compressed;
+ *  what the water marks go by
  */
-void Select(int maxfdp, fd_set &rset)
+static inline size_t Backlog(const REACTOR_SLOT_PTR pslot)
 {
-    if (select(maxfdp, &rset, NULL, NULL, NULL) <= 0)
-    {
-        perror("select");
-        exit(EXIT_FAILURE);
-    } // end if
-} // end Select
+    return Pending(pslot) + pslot->lzq_bytes + (pslot->psched ? pslot->psched->bytes : 0);
+} // end Backlog
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Helps certain linux/unix system to reuse the existing socket whenerver system restarts. This is usually 
- *  applied to a listening descriptor.
- * 
- * @param [lfd] listening socket 
+ *  Queues bytes up on the slot; its buffer is taken from the pool (or grown) as need be
  */
-void Tcp_Reuse_Addr(const int lfd)
+static void Queue(REACTOR_SLOT_PTR pslot, const char *buf, const size_t len)
 {
-    u32 on{1};
-    if (setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, (char*)&on, sizeof(on)) < 0)
+    if (pslot->outq_len + len > pslot->outq_size && pslot->outq_off > 0)
     {
-        perror("setsockopt()");
-        exit(EXIT_FAILURE);
-    } // end if socket option failure
-} // end Tcp_Reuse_Addr
+        memmove(pslot->poutq, pslot->poutq + pslot->outq_off, Pending(pslot));
+        pslot->outq_len -= pslot->outq_off;
+        pslot->outq_off = 0;
+    } // end if moving back
+
+    Buf_Grow(pslot->poutq, pslot->outq_size, pslot->outq_len, pslot->outq_len + len);
+    memcpy(pslot->poutq + pslot->outq_len, buf, len);
+    pslot->outq_len += len;
+} // end Queue
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Sets a socket as a non-blocking mode
- * 
- * @param [fd] the descriptor to set as non-blocking 
+ *  Empties the slot's queue and hands its buffer back to the pool; the next send takes another
  */
-void Set_Non_Blocking(int fd)
+static void Release_Queue(REACTOR_SLOT_PTR pslot)
 {
-#if defined (__unix__) || defined (__linux__)
-    u32 on = 1;
-    if (ioctl(fd, FIONBIO, (char *)&on) < 0)
-        perror("ioctl() failed");
-#elif defined (WIN32) || defined (_WIN64)
-    unsigned long i_mode = 1;
-    if (ioctlsocket(fd, FIONBIO, &i_mode))
-        fprintf(stderr, "ioctlsocket() fail");
-#endif
-} // end Set_Non_Blocking
+    Buf_Put(pslot->poutq, pslot->outq_size);
+    pslot->poutq = nullptr;
+    pslot->outq_size = pslot->outq_len = pslot->outq_off = 0;
+} // end Release_Queue
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Turns on the keep alive heart-beat signal
+ *  Hands the interest of a descriptor over to the backend; that's whatever the caller wants from it plus 
+ *  writability for as long as it has something queued. A descriptor the caller never registered gets 
+ *  registered (with no interest of its own) the moment it has something queued.
  * 
- * @param [fd] the descriptor to keep-alive 
+ * @param [fd] the descriptor 
+ * @param [pslot] its slot 
+ * @param [badd] is it new to the backend?
  */
-void Tcp_Keep_Alive(const int fd)
+static void Arm(const int fd, REACTOR_SLOT_PTR pslot, bool badd=false)
 {
-    u32 on{1};
-    if (setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, (char*)&on, sizeof(on)) < 0)
+    if (!pslot->bused)
     {
-        perror("setsocketopt()");
-        exit(EXIT_FAILURE);
-    } // end if
-} // end Tcp_Keep_Alive
+        if (!Pending(pslot))
+            return;
+
+        pslot->bused = badd = true;
+        pslot->events = 0;
+        pslot->ctx = nullptr;
+    } // end if not registered
+
+    u32 events = pslot->events;
+    if (Pending(pslot))
+        events |= EV_WRITE;
+
+    if (!badd && pslot->armed == events)
+        return;
+
+    pslot->armed = events;
+    if (Uring_Active())
+    {
+        Uring_Arm(fd, pslot->gen, events);
+        return;
+    } // end if io_uring
+
+#if defined (__linux__)
+    if (epoll_fd >= 0)
+    {
+        struct epoll_event ev;
+        ev.events = events & ~EV_RECV;
+        ev.data.u64 = ((uint64_t)pslot->gen << 32) | (u32)fd;
+        if (epoll_ctl(epoll_fd, badd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) < 0)
+            perror(badd ? "epoll_ctl(ADD)" : "epoll_ctl(MOD)");
+        return;
+    } // end if epoll
+#endif
+
+    if (badd)
+    {
+        pslot->index = vpoll.size();
+        vpoll.push_back({fd, (short)(events & ~EV_RECV), 0});
+    } // end if new
+    else
+        vpoll[pslot->index].events = (short)(events & ~EV_RECV);
+} // end Arm
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Toggles the Tcp_NoDelay on/off; i.e. the Negel's algorithim (don't know what that is yet ...)
- * 
- * @param [fds] the socket descriptor 
- *  
- * @return int 
- *  a 0 on success alas -1
+ *  Takes the descriptor out of the backend; any events for it still pending in the current batch become stale.
  */
-int Tcp_NoDelay(const int fds)
+static void Unregister(const int fd, REACTOR_SLOT_PTR pslot)
 {
-#if defined(__unix__) || defined(__linux__)
-    u32 flag{1};
-    if (setsockopt(fds, SOL_TCP, TCP_NODELAY, (void*)&flag, sizeof(flag)) < 0)
-        return -1;
+    pslot->bused = false;
+    pslot->ctx = nullptr;
+    pslot->armed = 0;
+    pslot->gen++;
+
+    if (Uring_Active())
+    {
+        Uring_Disarm(fd);
+        return;
+    } // end if io_uring
+
+#if defined (__linux__)
+    if (epoll_fd >= 0)
+    {
+        // a closed descriptor is already gone from the set; no need to cry about it
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL) < 0 && errno != EBADF && errno != ENOENT)
+            perror("epoll_ctl(DEL)");
+        return;
+    } // end if epoll
 #endif
-    return 0;
-} // end Tcp_NoDelay
+
+    // swap with the last one and pop; constant time removal
+    size_t index = pslot->index;
+    vpoll[index] = vpoll.back();
+    vslots[vpoll[index].fd].index = index;
+    vpoll.pop_back();
+} // end Unregister
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Specifies the socket to time out in the number of seconds provided, this is useful for avoiding blocking
- *  recv calls, but there are better ways for that.
- * 
- * @param [fds] the socket descriptor 
- *  
- * @return int
- *  a 0 on successful setting of the timeout, else -1 on fail 
+ *  Throws away the frames on the slot's compression queue; those still on the pool are let go of as they come
+ *  back
  */
-int Set_RecvTimeout(const int fds, const int sec)
+static void Drop_Lz(REACTOR_SLOT_PTR pslot)
 {
-    struct timeval timeout;
-    timeout.tv_sec = sec;
-    timeout.tv_usec = 0;
+    for (LZ_FRAME_PTR pf : pslot->lzq)
+    {
+        if (pf->bdone)
+            delete pf;
+        else
+            pf->fd = -1;
+    } // end for
 
-    // set socket options
-    if (setsockopt(fds, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0)
-        return -1;
-    
-    return 0;
-} // end Set_Recv_Timeout
+    pslot->lzq.clear();
+    pslot->lzq_bytes = 0;
+} // end Drop_Lz
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Removes the descriptor
- * 
- * @param fd 
+ *  Can the link be resumed should it lose its connection (see Intap_Replay)? Frames held back for it then keep
+ *  their place behind the rest when a send fails, till it's parked.
  */
-void Erase_Sock(const int fd)
+static inline bool Resumable(const REACTOR_SLOT_PTR pslot)
 {
-    // scan the socket from vector by its descriptor value
-    auto it = std::find_if(vpoll.begin(), vpoll.end(), [&fd](auto &x) { return x.fd == fd; });
-    if (it != std::end(vpoll))
-        vpoll.erase(it);
-} // end Erase_Sock
+    return pslot->preplay && pslot->preplay->max && !pslot->preplay->bbroken;
+} // end Resumable
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets go of the bytes a link kept for replaying; the counts stay as they are
+ */
+static void Release_Replay(LINK_REPLAY_PTR pr)
+{
+    Buf_Put(pr->pbuf, pr->size);
+    pr->pbuf = nullptr;
+    pr->size = pr->off = pr->len = 0;
+} // end Release_Replay
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Forgets whatever was queued on the slot; the descriptor is going away
+ */
+static void Reset_Queue(REACTOR_SLOT_PTR pslot)
+{
+    Release_Queue(pslot);
+    pslot->bcongested = false;
+    pslot->bfailed = false;
+    pslot->blinger = false;
+    pslot->bcoalesce = false;
+    pslot->bnonblock = false;
+    pslot->lz_min = 0;
+    delete pslot->psched;
+    pslot->psched = nullptr;
+    pslot->breleasing = false;
+    Drop_Lz(pslot);
+
+    if (pslot->preplay)
+        Release_Replay(pslot->preplay);
+    delete pslot->preplay;
+    pslot->preplay = nullptr;
+    pslot->bparked = false;
+} // end Reset_Queue
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A lingering descriptor is done with (drained, failed or out of time); now it's closed for real
+ */
+static void Finish_Linger(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    if (pslot->bused)
+        Unregister(fd, pslot);
+
+    Reset_Queue(pslot);
+    close(fd);
+} // end Finish_Linger
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Tells the caller about a queue crossing either of the water marks
+ */
+static void Check_Pressure(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    if (pslot->bparked)
+        return;         // backed up till it's resumed, however little it has
+
+    size_t pending = Backlog(pslot);
+    if (!pslot->bcongested && pending > SEND_HIGH_WATER)
+    {
+        pslot->bcongested = true;
+        if (on_congestion)
+            on_congestion(fd, true);
+    } // end if congested
+    else if (pslot->bcongested && pending < SEND_LOW_WATER)
+    {
+        pslot->bcongested = false;
+        if (on_congestion)
+            on_congestion(fd, false);
+    } // end else if flowing again
+} // end Check_Pressure
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The descriptor can't be sent to anymore; whatever's queued is dropped and the caller hears of it as an
+ *  error event on the next wait (unless it has closed it already).
+ */
+static void Fail(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    if (pslot->blinger)
+    {
+        Finish_Linger(fd, pslot);
+        return;
+    } // end if closed already
+
+    // a link that may be resumed keeps the frames still held back; what's queued is in its replay
+    Release_Queue(pslot);
+    if (pslot->psched && !Resumable(pslot))
+        Egress_Clear(*pslot->psched);
+    pslot->bfailed = true;
+    vfailed.push_back(fd);
+    Arm(fd, pslot);
+} // end Fail
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends what the socket takes of the pieces without blocking
+ * 
+ * @return ssize_t
+ *  bytes sent (0 if the socket is full) or -1 on error
+ */
+static ssize_t Send_Now(const int fd, const struct iovec *piov, const int count)
+{
+    struct msghdr msg{};
+    msg.msg_iov = (struct iovec *)piov;
+    msg.msg_iovlen = count;
+
+    while (true)
+    {
+        ssize_t bytes = sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (bytes >= 0)
+            return bytes;
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+
+        perror("send");
+        return -1;
+    } // end while
+} // end Send_Now
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Brings a queue up to date after some of it went out: compacts it, (un)arms writability, checks on the
+ *  water marks and closes a lingering descriptor once it's drained.
+ */
+static void Settle(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    if (!Pending(pslot))
+    {
+        Release_Queue(pslot);
+        if (pslot->blinger)
+        {
+            Finish_Linger(fd, pslot);
+            return;
+        } // end if closed
+    } // end if drained
+    else if (pslot->outq_off >= pslot->outq_len / 2)
+    {
+        memmove(pslot->poutq, pslot->poutq + pslot->outq_off, Pending(pslot));
+        pslot->outq_len -= pslot->outq_off;
+        pslot->outq_off = 0;
+    } // end else if half gone
+
+    Egress_Release(fd, pslot);
+    Arm(fd, pslot);
+    Check_Pressure(fd, pslot);
+} // end Settle
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends as much of the queue as the socket takes right now
+ */
+static void Flush_Out(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    struct iovec iov{(void *)(pslot->poutq + pslot->outq_off), Pending(pslot)};
+    ssize_t bytes = Send_Now(fd, &iov, 1);
+    if (bytes < 0)
+    {
+        Fail(fd, pslot);
+        return;
+    } // end if error
+
+    pslot->outq_off += bytes;
+    Settle(fd, pslot);
+} // end Flush_Out
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends the queues of everything sent to during the loop iteration; in one batch on io_uring, otherwise a
+ *  send a descriptor (that being the coalescing ones) for all it got.
+ */
+static void Flush_Dirty()
+{
+    if (vdirty.empty())
+        return;
+
+    if (!Uring_Active())
+    {
+        for (size_t i = 0; i < vdirty.size(); i++)
+        {
+            int fd = vdirty[i];
+            REACTOR_SLOT_PTR pslot = &vslots[fd];
+            if (!pslot->bdirty)
+                continue;
+
+            pslot->bdirty = false;
+            if (!Pending(pslot) || pslot->bfailed)
+                continue;
+
+            // one that's waiting on writability is full; it goes out with the rest as it drains
+            if (pslot->armed & EV_WRITE)
+                Check_Pressure(fd, pslot);
+            else
+                Flush_Out(fd, pslot);
+        } // end for
+
+        vdirty.clear();
+        return;
+    } // end if not io_uring
+
+    // exactly one send a descriptor, all its queue in one go (bdirty has it listed once); the batch doesn't link
+    //  its sends, so that's the only thing keeping a descriptor's bytes in order (see Uring_Send_Batch)
+    vbatch.clear();
+    for (int fd : vdirty)
+    {
+        REACTOR_SLOT_PTR pslot = &vslots[fd];
+        if (!pslot->bdirty)
+            continue;
+
+        pslot->bdirty = false;
+        if (Pending(pslot) && !pslot->bfailed)
+            vbatch.push_back({fd, pslot->poutq + pslot->outq_off, Pending(pslot), 0});
+    } // end for
+    vdirty.clear();
+
+    Uring_Send_Batch(vbatch.data(), vbatch.size());
+    for (auto &x : vbatch)
+    {
+        REACTOR_SLOT_PTR pslot = &vslots[x.fd];
+        if (x.res < 0 && x.res != -EAGAIN && x.res != -ECANCELED)
+        {
+            errno = -x.res;
+            perror("send");
+            Fail(x.fd, pslot);
+            continue;
+        } // end if error
+
+        if (x.res > 0)
+            pslot->outq_off += x.res;
+        Settle(x.fd, pslot);
+    } // end for
+} // end Flush_Dirty
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Closes the lingering descriptors that ran out of time
+ */
+static void Expire_Lingers()
+{
+    u64 now = Now_Ms();
+    for (size_t i = 0; i < vlinger.size(); )
+    {
+        int fd = vlinger[i];
+        REACTOR_SLOT_PTR pslot = &vslots[fd];
+        if (pslot->blinger && pslot->linger_deadline <= now)
+        {
+            fprintf(stderr, "socket %d didn't drain in time, dropping %zu bytes\n", fd, Pending(pslot));
+            Finish_Linger(fd, pslot);
+        } // end if out of time
+
+        if (!pslot->blinger)
+        {
+            vlinger[i] = vlinger.back();
+            vlinger.pop_back();
+            continue;
+        } // end if done with
+
+        i++;
+    } // end for
+} // end Expire_Lingers
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends the contents of the buffer over the connected socket without ever blocking; what the socket won't 
+ *  take right away is queued up and goes out as it turns writable. The caller finds out about a destination
+ *  falling behind through the hook set with Reactor_On_Congestion(), and about a failed one through an error
+ *  event on it.
+ * 
+ * @param [fds] a descriptor 
+ * @param [buf] buffer containing data 
+ * @param [buf_len] length of buffer 
+ */
+void Send(int fds, const char *buf, const size_t buf_len)
+{
+    struct iovec iov{(void *)buf, buf_len};
+    Send_Iov(fds, &iov, 1);
+} // end Send
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Keeps what's sent down a tunnel link for replaying till the peer says it got it (see Intap_Replay); a link
+ *  that has more than its max unacknowledged is given up on resuming, the rest of it goes on as usual.
+ */
+static void Replay_Keep(const int fd, LINK_REPLAY_PTR pr, const struct iovec *piov, const int count, 
+    const size_t len)
+{
+    pr->sent += len;
+    if (!pr->max || pr->bbroken)
+        return;
+
+    if (pr->len - pr->off + len > pr->max)
+    {
+        fprintf(stderr, "socket %d has more than %zu KiB unacknowledged, it can't be resumed anymore\n", fd, 
+            pr->max >> 10);
+        pr->bbroken = true;
+        Release_Replay(pr);
+        return;
+    } // end if too much
+
+    if (pr->len + len > pr->size && pr->off >= pr->len / 2)
+    {
+        memmove(pr->pbuf, pr->pbuf + pr->off, pr->len - pr->off);
+        pr->len -= pr->off;
+        pr->off = 0;
+    } // end if mostly acknowledged
+
+    Buf_Grow(pr->pbuf, pr->size, pr->len, pr->len + len);
+    for (int i = 0; i < count; i++)
+    {
+        memcpy(pr->pbuf + pr->len, piov[i].iov_base, piov[i].iov_len);
+        pr->len += piov[i].iov_len;
+    } // end for
+} // end Replay_Keep
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Send_Iov() past the book keeping; the bytes go out, or are queued, as they are
+ */
+static void Send_Out(const int fds, REACTOR_SLOT_PTR pslot, const struct iovec *piov, const int count, 
+    const size_t buf_len)
+{
+    size_t pending = Pending(pslot);
+    if (pending + buf_len > SEND_QUEUE_MAX)
+    {
+        fprintf(stderr, "send queue of socket %d overflowed, giving up on it\n", fds);
+        Fail(fds, pslot);
+        return;
+    } // end if too far behind
+
+    // on io_uring the sends wait for the end of the loop iteration and go down in one go; so do those of a 
+    //  coalescing descriptor, unless a good deal piles up
+    if (Uring_Active() || pslot->bcoalesce)
+    {
+        for (int i = 0; i < count; i++)
+            Queue(pslot, (const char *)piov[i].iov_base, piov[i].iov_len);
+
+        if (!Uring_Active() && Pending(pslot) >= SEND_BATCH_MAX && !(pslot->armed & EV_WRITE))
+        {
+            Flush_Out(fds, pslot);
+            return;
+        } // end if batch is full
+
+        if (!pslot->bdirty)
+        {
+            pslot->bdirty = true;
+            vdirty.push_back(fds);
+        } // end if
+        return;
+    } // end if io_uring
+
+    size_t sent{0};
+    if (pending == 0)
+    {
+        ssize_t bytes = Send_Now(fds, piov, count);
+        if (bytes < 0)
+        {
+            Fail(fds, pslot);
+            return;
+        } // end if error
+
+        if ((size_t)bytes == buf_len)
+            return;
+
+        sent = bytes;
+    } // end if nothing ahead of it
+
+    // queue up whatever didn't make it
+    for (int i = 0; i < count; i++)
+    {
+        size_t skip = std::min(sent, piov[i].iov_len);
+        Queue(pslot, (const char *)piov[i].iov_base + skip, piov[i].iov_len - skip);
+        sent -= skip;
+    } // end for
+
+    Settle(fds, pslot);
+} // end Send_Out
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Send() for data that's in pieces, such as a header and its payload; they go out together (or are queued 
+ *  together) without first being copied into one buffer.
+ * 
+ * @param [fds] a descriptor 
+ * @param [piov] the pieces 
+ * @param [count] how many of them 
+ */
+void Send_Iov(int fds, const struct iovec *piov, const int count)
+{
+    size_t buf_len{0};
+    for (int i = 0; i < count; i++)
+        buf_len += piov[i].iov_len;
+
+    if (fds < 0 || buf_len == 0)
+        return;
+
+    REACTOR_SLOT_PTR pslot = Slot(fds);
+    if (pslot->preplay)
+        Replay_Keep(fds, pslot->preplay, piov, count, buf_len);
+
+    if (pslot->bfailed || pslot->bparked)
+        return;         // given up on already, or it goes once the link's resumed
+
+    Send_Out(fds, pslot, piov, count, buf_len);
+} // end Send_Iov
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Tells how many bytes are queued up on a descriptor waiting to go out
+ * 
+ * @param [fds] the descriptor 
+ */
+size_t Send_Pending(const int fds)
+{
+    if (fds < 0 || (size_t)fds >= vslots.size())
+        return 0;
+
+    return Pending(&vslots[fds]);
+} // end Send_Pending
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Is the descriptor over its high-water mark? Sources feeding it had better hold off.
+ * 
+ * @param [fds] the descriptor 
+ */
+bool Send_Congested(const int fds)
+{
+    return fds >= 0 && (size_t)fds < vslots.size() && vslots[fds].bcongested;
+} // end Send_Congested
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends all of the buffer there and then, blocking till it's gone; for the odd handshake on a socket the 
+ *  reactor has nothing queued on (such as answering a CMD_RESUME before the link's taken back).
+ * 
+ * @param [fds] a blocking descriptor 
+ * @param [buf] buffer containing data 
+ * @param [buf_len] length of buffer 
+ * 
+ * @return bool
+ *  false if it failed; it's on stderr
+ */
+bool Send_Block(const int fds, const char *buf, const size_t buf_len)
+{
+    size_t sent{0};
+    while (sent < buf_len)
+    {
+        ssize_t bytes = send(fds, buf + sent, buf_len - sent, MSG_NOSIGNAL);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        else if (bytes <= 0)
+        {
+            perror("send");
+            return false;
+        } // end if failed
+
+        sent += bytes;
+    } // end while
+
+    return true;
+} // end Send_Block
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Has the sends to a descriptor coalesce; they pile up and go out in a single send before the reactor waits
+ *  again (or as soon as SEND_BATCH_MAX of them piles up). Meant for descriptors many small frames are sent 
+ *  to each loop iteration, such as a tunnel; it costs them at most the rest of the iteration in latency. On 
+ *  io_uring every descriptor works this way anyway. Lasts till the descriptor is closed.
+ * 
+ * @param [fds] the descriptor 
+ * @param [bon] coalesce or go back to sending right away
+ */
+void Send_Coalesce(const int fds, const bool bon)
+{
+    if (fds < 0)
+        return;
+
+    REACTOR_SLOT_PTR pslot = Slot(fds);
+    pslot->bcoalesce = bon;
+    if (!bon && pslot->bdirty && Pending(pslot) && !(pslot->armed & EV_WRITE))
+        Flush_Out(fds, pslot);
+} // end Send_Coalesce
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Recievs incomming signal from peer on a given socket
+ * 
+ * @param [fds] the descriptor 
+ * @param [buf] the buffer to get the data 
+ * @param [buf_len] the length of buffer
+ *  
+ * @return int
+ *  the number of bytes actually read 
+ */
+int Recv(int fds, char *buf, const size_t buf_len)
+{
+    int bytes, total_bytes{0};
+    char *alias = buf;
+
+    do 
+    {
+        bytes = recv(fds, alias, buf_len - total_bytes, 0);
+        if (bytes == -1 && errno == EINTR)
+            continue;           // io_uring task work interrupts blocking calls too
+        else if (bytes == -1)
+        {
+            perror("recv");
+            break;
+        } // end if error or so
+        else if (bytes == 0)
+            break;              // peer's gone
+
+        total_bytes += bytes;
+        alias += bytes;
+    } while (total_bytes < (int)buf_len); // end while
+
+    return total_bytes;
+} // end Recv
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Writes an unsigned LEB128 varint; 7 bits a byte, low bits first, the top bit says more follow
+ * 
+ * @return size_t
+ *  bytes written (5 at most)
+ */
+static size_t Put_Varint(char *dst, u32 val)
+{
+    size_t len{0};
+    while (val >= 0x80)
+    {
+        dst[len++] = (char)(val | 0x80);
+        val >>= 7;
+    } // end while
+
+    dst[len++] = (char)val;
+    return len;
+} // end Put_Varint
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Reads back a varint written by Put_Varint
+ * 
+ * @return int
+ *  bytes taken, 0 if it's not all there yet or -1 if it runs longer than a u32 ever does
+ */
+static int Get_Varint(const char *src, const size_t len, u32 &val)
+{
+    val = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (i == 5)
+            return -1;
+
+        val |= (u32)(src[i] & 0x7F) << (7 * i);
+        if (!(src[i] & 0x80))
+            return (int)i + 1;
+    } // end for
+
+    return len >= 5 ? -1 : 0;
+} // end Get_Varint
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  What goes in the INTAP_CAP_FRAME bits of a hello for the longest payload we'd take in a frame; it's rounded
+ *  down to a power of two, no less than 4 KiB and no more than INTAP_FRAME_MAX
+ * 
+ * @param [frame_max] the longest payload 
+ */
+u16 Intap_Frame_Cap(const size_t frame_max)
+{
+    u16 n{1};
+    while (n < 15 && ((size_t)2048 << (n + 1)) <= std::min<size_t>(frame_max, INTAP_FRAME_MAX))
+        n++;
+
+    return n << INTAP_FRAME_SHIFT;
+} // end Intap_Frame_Cap
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Settles the longest payload a frame may carry with a peer; the lesser of what it and we offered, but never
+ *  past what we read into (our buffer is the larger of -fm and -bs)
+ * 
+ * @param [offer] the port field of its hello (or the answer to ours) 
+ * @param [frame_max] the longest we'd take 
+ * @param [legacy] what goes for a peer that offers nothing; its reads are no longer than -bs 
+ */
+size_t Intap_Frame_Max(const u16 offer, const size_t frame_max, const size_t legacy)
+{
+    u16 n = (offer & INTAP_CAP_FRAME) >> INTAP_FRAME_SHIFT;
+    if (n == 0)
+        return legacy;
+
+    u16 ours = Intap_Frame_Cap(frame_max) >> INTAP_FRAME_SHIFT;
+    return std::min((size_t)2048 << std::min(n, ours), std::max(frame_max, legacy));
+} // end Intap_Frame_Max
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Writes out the header of a frame in the given INTAP version. v1 is the packed INTAP_FMT as is. v2 is a type 
+ *  byte (INTAP_V2_xxx) followed by the destination and source descriptors as varints, each only if it's 
+ *  there (>= 0), the port and the length prefixed ip on CMD_CLI_CONNECT/CMD_DB_CONNECT and last the payload 
+ *  length as a varint. On a running stream that's about 3 bytes.
+ * 
+ * @param [dst] where to; INTAP_MAX_HDR bytes will always do 
+ * @param [intap] the header (in network order as always) 
+ * @param [version] INTAP_V1 or INTAP_V2
+ * @param [blz] is the payload compressed? (v2 only, see Intap_Send)
+ * 
+ * @return size_t
+ *  length of the header
+ */
+size_t Intap_Encode(char *dst, const INTAP_FMT &intap, const int version, const bool blz)
+{
+    if (version < INTAP_V2)
+    {
+        memcpy(dst, &intap, sizeof(intap));
+        return sizeof(intap);
+    } // end if v1
+
+    u16 id = NTOHS(intap.id);
+    s16 dest = (s16)NTOHS(intap.dest_fd);
+    s16 src = (s16)NTOHS(intap.src_fd);
+    size_t len{1};
+
+    dst[0] = (char)(INTAP_V2_TAG | (blz ? INTAP_V2_LZ : 0) | (id & INTAP_V2_ID));
+    if (dest >= 0)
+    {
+        dst[0] |= INTAP_V2_DEST;
+        len += Put_Varint(dst + len, dest);
+    } // end if destination
+
+    if (src >= 0)
+    {
+        dst[0] |= INTAP_V2_SRC;
+        len += Put_Varint(dst + len, src);
+    } // end if source
+
+    if (id == CMD_CLI_CONNECT || id == CMD_DB_CONNECT)
+    {
+        u16 port = intap.port;
+        size_t ip_len = strnlen(intap.ip, INET_ADDRSTRLEN - 1);
+
+        memcpy(dst + len, &port, sizeof(port));
+        len += sizeof(port);
+        dst[len++] = (char)ip_len;
+        memcpy(dst + len, intap.ip, ip_len);
+        len += ip_len;
+    } // end if connecting
+
+    return len + Put_Varint(dst + len, NTOHL(intap.buf_len));
+} // end Intap_Encode
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Reads a frame header of either version back into an INTAP_FMT; what a v2 header leaves out comes back as
+ *  it would in v1 (-1 for descriptors, zeroes otherwise).
+ * 
+ * @param [src] the bytes at hand 
+ * @param [len] how many of them 
+ * @param [intap] the header 
+ * @param [pblz] set if the payload is compressed; optional 
+ * 
+ * @return int
+ *  length of the header, 0 if it's not all there yet or -1 if it makes no sense
+ */
+int Intap_Decode(const char *src, const size_t len, INTAP_FMT &intap, bool *pblz)
+{
+    if (len == 0)
+        return 0;
+
+    if (pblz)
+        *pblz = (src[0] & INTAP_V2_TAG) && (src[0] & INTAP_V2_LZ);
+
+    if (!(src[0] & INTAP_V2_TAG))
+    {
+        if (len < sizeof(intap))
+            return 0;
+
+        memcpy((void *)&intap, src, sizeof(intap));
+        return sizeof(intap);
+    } // end if v1
+
+    u8 type = (u8)src[0];
+    size_t off{1};
+    u32 val;
+    int n;
+
+    memset((void *)&intap, 0, sizeof(intap));
+    memcpy((void *)intap.signature, "INTAP11", 8);
+    intap.id = HTONS(type & INTAP_V2_ID);
+    intap.dest_fd = HTONS(-1);
+    intap.src_fd = HTONS(-1);
+
+    if (type & INTAP_V2_DEST)
+    {
+        if ( (n = Get_Varint(src + off, len - off, val)) <= 0)
+            return n;
+        if (val > 0x7FFF)
+            return -1;
+
+        intap.dest_fd = HTONS((u16)val);
+        off += n;
+    } // end if destination
+
+    if (type & INTAP_V2_SRC)
+    {
+        if ( (n = Get_Varint(src + off, len - off, val)) <= 0)
+            return n;
+        if (val > 0x7FFF)
+            return -1;
+
+        intap.src_fd = HTONS((u16)val);
+        off += n;
+    } // end if source
+
+    u16 id = type & INTAP_V2_ID;
+    if (id == CMD_CLI_CONNECT || id == CMD_DB_CONNECT)
+    {
+        if (len < off + sizeof(intap.port) + 1)
+            return 0;
+
+        u16 port;
+        memcpy(&port, src + off, sizeof(port));
+        intap.port = port;
+        off += sizeof(port);
+
+        size_t ip_len = (u8)src[off++];
+        if (ip_len >= INET_ADDRSTRLEN)
+            return -1;
+        if (len < off + ip_len)
+            return 0;
+
+        memcpy(intap.ip, src + off, ip_len);
+        off += ip_len;
+    } // end if connecting
+
+    if ( (n = Get_Varint(src + off, len - off, val)) <= 0)
+        return n;
+
+    intap.buf_len = HTONL(val);
+    return (int)(off + n);
+} // end Intap_Decode
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Makes sure there's at least room bytes free past the end of a tunnel receive buffer; what's left in it is
+ *  moved back to the start first, it only grows if that won't do. A buffer that's been grown for some big
+ *  frame goes back to its usual size once it's emptied out.
+ */
+static void Rx_Room(INTAP_RX &rx, const size_t room)
+{
+    if (rx.head == rx.tail)
+    {
+        rx.head = rx.tail = 0;
+        if (rx.vbuf.size() > 4 * INTAP_RX_SIZE)
+        {
+            rx.vbuf.resize(INTAP_RX_SIZE);
+            rx.vbuf.shrink_to_fit();
+        } // end if done with a big one
+    } // end if empty
+
+    if (rx.vbuf.size() - rx.tail >= room)
+        return;
+
+    if (rx.head > 0)
+    {
+        memmove(rx.vbuf.data(), rx.vbuf.data() + rx.head, rx.tail - rx.head);
+        rx.tail -= rx.head;
+        rx.head = 0;
+    } // end if moving back
+
+    if (rx.vbuf.size() - rx.tail < room)
+        rx.vbuf.resize(std::max(rx.tail + room, (size_t)INTAP_RX_SIZE));
+} // end Rx_Room
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Moves as much of the payload being spliced (see Intap_Splice) as the link has in right now into its stream
+ *  through a pipe, never bringing it into user space. Whatever the stream won't take right away is read back
+ *  out of the pipe and queued as Send() would; if the stream's gone by now (or fails along the way) it's 
+ *  thrown away instead, so the link is always left at the next frame once it's all through.
+ * 
+ * @param [from] the link; non-blocking by now 
+ * @param [rx] its receive buffer 
+ * 
+ * @return int
+ *  bytes moved off the link or -1 if it failed
+ */
+static int Splice_Rest(const int from, INTAP_RX &rx)
+{
+#if defined (__linux__)
+    int to = rx.splice_to;
+    REACTOR_SLOT_PTR pslot = &vslots[to];
+    if (!pslot->bused || pslot->gen != rx.splice_gen || pslot->blinger)
+        to = -1;        // closed since
+
+    char spill[4096];
+    size_t moved{0};
+    while (rx.splice_left > 0)
+    {
+        ssize_t in = splice(from, NULL, splice_pipe[1], NULL, rx.splice_left, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (in < 0 && errno == EINTR)
+            continue;
+        else if (in < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;      // the rest isn't in yet
+        else if (in <= 0)
+        {
+            if (in < 0)
+                perror("splice");
+            return -1;
+        } // end if link's gone
+
+        rx.splice_left -= in;
+        rx.rcvd += in;
+        moved += in;
+        while (in > 0 && to >= 0 && !pslot->bfailed && !Pending(pslot))
+        {
+            ssize_t out = splice(splice_pipe[0], NULL, to, NULL, in, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (out < 0 && errno == EINTR)
+                continue;
+            else if (out < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;      // it's full
+            else if (out <= 0)
+            {
+                perror("splice");
+                Fail(to, pslot);
+                break;
+            } // end if failed
+
+            in -= out;
+        } // end while
+
+        // the pipe is emptied out either way; into the queue or nowhere if the stream's no more
+        while (in > 0)
+        {
+            ssize_t bytes = read(splice_pipe[0], spill, std::min((size_t)in, sizeof(spill)));
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            else if (bytes <= 0)
+            {
+                perror("read(splice pipe)");
+                close(splice_pipe[0]);
+                close(splice_pipe[1]);
+                splice_pipe[0] = splice_pipe[1] = -1;
+                return -1;
+            } // end if can't be
+
+            if (to >= 0)
+                Send(to, spill, bytes);
+            in -= bytes;
+        } // end while
+    } // end while
+
+    return (int)moved;
+#else
+    return -1;
+#endif
+} // end Splice_Rest
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Reads whatever a tunnel link has in for us in one go, never blocking. A payload being spliced goes on 
+ *  first; the rest is read into the receive buffer with room enough for the frame at its front, however long
+ *  (up to INTAP_FRAME_MAX). Frames are then had with Intap_Next().
+ * 
+ * @param [fds] the link 
+ * @param [rx] its receive buffer 
+ * 
+ * @return int
+ *  bytes taken off the link, 0 if there was nothing to take yet or -1 if the link's gone
+ */
+int Intap_Fill(const int fds, INTAP_RX &rx)
+{
+    int spliced{0};
+    if (rx.splice_left > 0)
+    {
+        if ( (spliced = Splice_Rest(fds, rx)) < 0 || rx.splice_left > 0)
+            return spliced;
+    } // end if splicing
+
+    // room for the rest of the frame at the front if we know how long it is
+    INTAP_FMT intap;
+    size_t room{INTAP_RX_ROOM};
+    size_t have = rx.tail - rx.head;
+    int hlen = Intap_Decode(rx.vbuf.data() + rx.head, have, intap);
+    if (hlen > 0 && NTOHL(intap.buf_len) <= INTAP_FRAME_MAX && hlen + NTOHL(intap.buf_len) > have)
+        room = std::max(room, hlen + NTOHL(intap.buf_len) - have);
+
+    Rx_Room(rx, room);
+
+    ssize_t bytes;
+    do
+    {
+        bytes = recv(fds, rx.vbuf.data() + rx.tail, rx.vbuf.size() - rx.tail, MSG_DONTWAIT);
+    } while (bytes < 0 && errno == EINTR);
+
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return spliced;
+    else if (bytes <= 0)
+    {
+        if (bytes < 0)
+            perror("recv");
+        return -1;
+    } // end if gone
+
+    rx.tail += bytes;
+    rx.rcvd += bytes;
+    return spliced + (int)bytes;
+} // end Intap_Fill
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Puts bytes already read off a link some other way into its receive buffer; such as those that came along
+ *  with the hello
+ * 
+ * @param [rx] the receive buffer 
+ * @param [buf] the bytes 
+ * @param [len] how many
+ */
+void Intap_Feed(INTAP_RX &rx, const char *buf, const size_t len)
+{
+    Rx_Room(rx, len);
+    memcpy(rx.vbuf.data() + rx.tail, buf, len);
+    rx.tail += len;
+    rx.rcvd += len;
+} // end Intap_Feed
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Counts a frame off the tunnel that's been handed out (see metrics.h)
+ * 
+ * @param [len] its payload length
+ */
+static inline void Rx_Count(const size_t len)
+{
+    Metrics_Add(pmetrics->frames[METRICS_RX], 1);
+    Metrics_Add(pmetrics->bytes[METRICS_RX], len);
+    Metrics_Observe(pmetrics->frame_bytes[METRICS_RX], len, METRICS_SHIFT_BYTES);
+} // end Rx_Count
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Hands out the frame at the front of a tunnel receive buffer if it's all in. The payload is left right where
+ *  it is, so it's good till the next Intap_Fill() (a compressed one is decompressed on the side and is good
+ *  till the next Intap_Next()). A frame whose payload is mostly still in the kernel and big
+ *  enough to be spliced is reported as such; it's for the caller to take it up with Intap_Splice() or wait on
+ *  the rest like any other.
+ * 
+ * @param [rx] the receive buffer 
+ * @param [intap] the frame's header 
+ * @param [payload] and its payload; NTOHL(intap.buf_len) bytes of it 
+ * 
+ * @return int
+ *  one of INTAP_RX_xxx
+ */
+int Intap_Next(INTAP_RX &rx, INTAP_FMT &intap, const char *&payload)
+{
+    bool blz;
+    size_t have = rx.tail - rx.head;
+    int hlen = Intap_Decode(rx.vbuf.data() + rx.head, have, intap, &blz);
+    if (hlen <= 0)
+        return hlen < 0 ? INTAP_RX_BAD : INTAP_RX_MORE;
+
+    size_t len = NTOHL(intap.buf_len);
+    if (len > INTAP_FRAME_MAX)
+        return INTAP_RX_BAD;
+
+    if (have < hlen + len)
+    {
+        rx.hlen = hlen;
+        rx.plen = len;
+#if defined (__linux__)
+        if (hlen + len - have >= SPLICE_MIN && !blz && !Uring_Active())
+            return INTAP_RX_SPLICE;
+#endif
+        return INTAP_RX_MORE;
+    } // end if not all in
+
+    payload = rx.vbuf.data() + rx.head + hlen;
+    rx.head += hlen + len;
+    if (!blz)
+    {
+        Rx_Count(len);
+        return INTAP_RX_FRAME;
+    } // end if plain
+
+    // a compressed one is handed out decompressed; its length as it was leads it
+    u32 plain;
+    int n = Get_Varint(payload, len, plain);
+    if (n <= 0 || plain > INTAP_FRAME_MAX)
+        return INTAP_RX_BAD;
+
+    rx.vplain.resize(plain);
+    if (LZ_Decompress(payload + n, len - n, rx.vplain.data(), plain) != (int)plain)
+        return INTAP_RX_BAD;
+
+    payload = rx.vplain.data();
+    intap.buf_len = HTONL(plain);
+    Rx_Count(plain);
+    return INTAP_RX_FRAME;
+} // end Intap_Next
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Relays the payload of the frame Intap_Next() reported as INTAP_RX_SPLICE straight from the link into a
+ *  stream, never bringing what's still in the kernel into user space; what's in the receive buffer already
+ *  goes first. It only goes if the stream has nothing queued ahead of it. Whatever isn't in yet follows as it
+ *  comes in with the next Intap_Fill()s; frames after it wait till it's all through.
+ * 
+ *  Not on io_uring (its recvs don't mix with non-blocking descriptors). Both ends are switched to non-blocking
+ *  mode the first time round; sends never block anyway and the link is never read any other way.
+ * 
+ * @param [fds] the link 
+ * @param [rx] its receive buffer 
+ * @param [to] the stream 
+ * 
+ * @return int
+ *  1 if taken, 0 if it's not to be spliced (wait on the rest as usual) or -1 if the link failed
+ */
+int Intap_Splice(const int fds, INTAP_RX &rx, const int to)
+{
+#if defined (__linux__)
+    if (Uring_Active() || to < 0 || rx.hlen == 0)
+        return 0;
+
+    REACTOR_SLOT_PTR pslot = Slot(to);
+    if (!pslot->bused || Pending(pslot) || pslot->bfailed || pslot->blinger || pslot->bcoalesce)
+        return 0;
+
+    if (splice_pipe[0] < 0 && pipe2(splice_pipe, O_NONBLOCK | O_CLOEXEC) < 0)
+    {
+        perror("pipe2");
+        return 0;
+    } // end if no pipe
+
+    for (int fd : {to, fds})
+    {
+        if (!Slot(fd)->bnonblock)
+        {
+            Set_Non_Blocking(fd);
+            Slot(fd)->bnonblock = true;
+        } // end if first time
+    } // end for
+
+    pslot = Slot(to);       // the table may have grown
+    size_t have = rx.tail - rx.head - rx.hlen;
+    if (have > 0)
+        Send(to, rx.vbuf.data() + rx.head + rx.hlen, have);
+
+    Rx_Count(rx.plen);
+    rx.splice_left = rx.plen - have;
+    rx.splice_to = to;
+    rx.splice_gen = pslot->gen;
+    rx.head = rx.tail;
+    rx.hlen = rx.plen = 0;
+
+    return Splice_Rest(fds, rx) < 0 ? -1 : 1;
+#else
+    return 0;
+#endif
+} // end Intap_Splice
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Has what's sent down a tunnel link kept till the peer says it got it (see Intap_Acked), so that the link 
+ *  can be resumed from where the peer left off should it lose its connection (see Intap_Park). Counting starts
+ *  with the call, which is to be right after the hello (or whatever starts the link off) on both ends. Called
+ *  again it starts the count over for a new session on the link; anything the old one had on its way is 
+ *  thrown away. Lasts till the link is closed.
+ * 
+ * @param [fds] the link 
+ * @param [max] most it may have unacknowledged before it's given up on resuming; 0 keeps nothing, the link
+ *  can still be parked but not resumed
+ */
+void Intap_Replay(const int fds, const size_t max)
+{
+    if (fds < 0)
+        return;
+
+    REACTOR_SLOT_PTR pslot = Slot(fds);
+    if (pslot->preplay)
+    {
+        Release_Replay(pslot->preplay);
+        *pslot->preplay = LINK_REPLAY();
+        Release_Queue(pslot);
+        if (pslot->psched)
+            Egress_Clear(*pslot->psched);
+        Drop_Lz(pslot);
+    } // end if starting over
+    else
+        pslot->preplay = new LINK_REPLAY;
+
+    pslot->preplay->max = max;
+} // end Intap_Replay
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The peer got this much off a link (a CMD_ACK or a resume); what it's got needn't be kept anymore. Counts 
+ *  behind the last one or ahead of what's been sent make no sense and are ignored.
+ * 
+ * @param [fds] the link 
+ * @param [seq] bytes the peer got off it all told
+ */
+void Intap_Acked(const int fds, const u64 seq)
+{
+    LINK_REPLAY_PTR pr = (fds >= 0 && (size_t)fds < vslots.size()) ? vslots[fds].preplay : nullptr;
+    if (!pr || seq <= pr->acked || seq > pr->sent)
+        return;
+
+    if (pr->pbuf)
+    {
+        pr->off += seq - pr->acked;
+        if (pr->off == pr->len)
+            Release_Replay(pr);
+    } // end if kept
+
+    pr->acked = seq;
+} // end Intap_Acked
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Tells the peer how much has come off a link in a CMD_ACK once another INTAP_ACK_BYTES has since the last 
+ *  time; it lets go of that much of what it keeps for replaying. Called after the frames read off it are dealt
+ *  with.
+ * 
+ * @param [fds] the link 
+ * @param [rx] its receive buffer 
+ * @param [version] INTAP version of the link
+ */
+void Intap_Ack(const int fds, INTAP_RX &rx, const int version)
+{
+    if (rx.rcvd - rx.acked < INTAP_ACK_BYTES)
+        return;
+
+    INTAP_FMT intap;
+    char hdr[INTAP_MAX_HDR];
+    u64 seq = HTONLL(rx.rcvd);
+    intap.id = HTONS(CMD_ACK);
+    intap.src_fd = HTONS(-1);
+    intap.dest_fd = HTONS(-1);
+    intap.buf_len = HTONL(sizeof(seq));
+    rx.acked = rx.rcvd;
+    Intap_Send(fds, hdr, intap, (const char *)&seq, sizeof(seq), version);
+} // end Intap_Ack
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A tunnel link lost its connection; it's taken out of the reactor and held, backed up, till it's resumed 
+ *  (Intap_Resume) or closed. What's sent to it meanwhile is only kept for the replay, frames held back by its
+ *  scheduler or still being compressed stay that way. The caller hears of it as the link backing up (see 
+ *  Reactor_On_Congestion) and no more from the link till then. A link parked already stays as it is.
+ * 
+ * @param [fds] the link; one with Intap_Replay() on 
+ * 
+ * @return bool
+ *  true if it can be resumed; false if it's to be closed (or was never kept for replaying)
+ */
+bool Intap_Park(const int fds)
+{
+    if (fds < 0 || (size_t)fds >= vslots.size() || !vslots[fds].preplay)
+        return false;
+
+    REACTOR_SLOT_PTR pslot = &vslots[fds];
+    if (!pslot->bparked)
+    {
+        if (!pslot->bcongested)
+        {
+            pslot->bcongested = true;
+            if (on_congestion)
+                on_congestion(fds, true);
+        } // end if flowing
+        
+        if (pslot->bused)
+            Unregister(fds, pslot);
+        Release_Queue(pslot);           // it's all in the replay
+        pslot->bfailed = false;
+        pslot->bparked = true;
+        Metrics_Add(pmetrics->links_lost, 1);
+    } // end if not yet
+
+    return pslot->preplay->max && !pslot->preplay->bbroken;
+} // end Intap_Park
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Is the link parked, waiting to be resumed?
+ * 
+ * @param [fds] the link 
+ */
+bool Intap_Parked(const int fds)
+{
+    return fds >= 0 && (size_t)fds < vslots.size() && vslots[fds].bparked;
+} // end Intap_Parked
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Resumes a parked link over a new connection; the connection takes the link's descriptor (dup2), so 
+ *  whatever the caller keeps by it stays good. Whatever the peer says it didn't get goes again, then 
+ *  everything held back for the link meanwhile; nothing's ever lost or sent twice. It's back in the reactor
+ *  and flowing again (see Reactor_On_Congestion) as it drains.
+ * 
+ * @param [fds] the parked link 
+ * @param [nfd] the new connection; blocking, with the handshake done with. It's closed unless this fails 
+ * @param [seq] bytes the peer got off the link all told; the replay goes from there 
+ * @param [ctx] the link's context in the reactor 
+ * @param [lead] what goes ahead of the replay; not part of the link's bytes (an answer to the peer, say) 
+ * @param [lead_len] its length
+ * 
+ * @return bool
+ *  false if the link can't be resumed from there; nothing's changed then
+ */
+bool Intap_Resume(const int fds, const int nfd, const u64 seq, void *ctx, const char *lead, const size_t lead_len)
+{
+    if (fds < 0 || nfd < 0 || fds == nfd)
+        return false;
+
+    Slot(std::max(fds, nfd));       // the table grows here if it must; the two below stay put
+    REACTOR_SLOT_PTR pslot = &vslots[fds];
+    REACTOR_SLOT_PTR pnew = &vslots[nfd];
+    LINK_REPLAY_PTR pr = pslot->preplay;
+    if (!pslot->bparked || seq < pr->acked || seq > pr->sent || (seq < pr->sent && (!pr->max || pr->bbroken)))
+        return false;
+
+    if (pnew->bused)
+        Unregister(nfd, pnew);
+    Reset_Queue(pnew);
+    if (dup2(nfd, fds) < 0)
+    {
+        perror("dup2");
+        return false;
+    } // end if can't
+
+    close(nfd);
+    if (pslot->bnonblock)
+        Set_Non_Blocking(fds);      // spliced as before; a new connection starts out blocking
+
+    Intap_Acked(fds, seq);
+    pslot->bparked = false;
+    Reactor_Add(fds, EV_READ, ctx);
+    Metrics_Add(pmetrics->links_resumed, 1);
+
+    int count{0};
+    struct iovec iov[2];
+    if (lead_len)
+        iov[count++] = {(void *)lead, lead_len};
+    if (pr->len > pr->off)
+        iov[count++] = {(void *)(pr->pbuf + pr->off), pr->len - pr->off};
+    if (count)
+        Send_Out(fds, pslot, iov, count, lead_len + pr->len - pr->off);
+
+    if (!pslot->bfailed)
+        Settle(fds, pslot);
+    return true;
+} // end Intap_Resume
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Compresses a frame; on the pool. One that won't shrink goes as it is.
+ */
+static void Lz_Frame(LZ_FRAME_PTR pf)
+{
+    size_t len = pf->plain.size();
+    size_t lead = INTAP_MAX_HDR + 5;    // room for the header and the length varint ahead of the block
+    char vlen[5];
+    size_t nvlen = Put_Varint(vlen, (u32)len);
+
+    pf->frame.resize(lead + LZ_BOUND(len));
+    size_t clen = LZ_Compress(pf->plain.data(), len, &pf->frame[lead], pf->frame.size() - lead);
+    if (clen == 0 || nvlen + clen >= len)
+    {
+        size_t hlen = Intap_Encode(&pf->frame[0], pf->intap, pf->version);
+        memcpy(&pf->frame[hlen], pf->plain.data(), len);
+        pf->frame.resize(hlen + len);
+        pf->off = 0;
+        return;
+    } // end if no better off
+
+    INTAP_FMT intap = pf->intap;
+    char hdr[INTAP_MAX_HDR];
+    intap.buf_len = HTONL(nvlen + clen);
+    size_t hlen = Intap_Encode(hdr, intap, pf->version, true);
+
+    pf->off = lead - nvlen - hlen;
+    memcpy(&pf->frame[pf->off], hdr, hlen);
+    memcpy(&pf->frame[lead - nvlen], vlen, nvlen);
+    pf->frame.resize(lead + clen);
+} // end Lz_Frame
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A compression worker; takes frames off its queue, compresses them and hands them back to the reactor thread
+ *  they came from
+ * 
+ * @param [pjobs] its queue 
+ */
+static void Lz_Worker(MPSC_QUEUE<LZ_FRAME_PTR> *pjobs)
+{
+    struct pollfd pfd{pjobs->wake_fd[0], POLLIN, 0};
+    while (true)
+    {
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR)
+        {
+            perror("poll(lz worker)");
+            return;
+        } // end if can't wait
+
+        LZ_FRAME_PTR pf;
+        pjobs->Clear();
+        while (pjobs->Pop(pf))
+        {
+            Lz_Frame(pf);
+            MPSC_QUEUE<LZ_FRAME_PTR> *powner = pf->powner;
+            powner->Push(std::move(pf));
+        } // end while
+    } // end while
+} // end Lz_Worker
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends the frames at the front of a link's compression queue that are ready; up to the first that isn't
+ */
+static void Lz_Flush(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    while (!pslot->lzq.empty() && pslot->lzq.front()->bdone)
+    {
+        LZ_FRAME_PTR pf = pslot->lzq.front();
+        pslot->lzq.erase(pslot->lzq.begin());
+        pslot->lzq_bytes -= pf->bytes;
+        Send(fd, pf->frame.data() + pf->off, pf->frame.size() - pf->off);
+        delete pf;
+    } // end while
+
+    Egress_Release(fd, pslot);
+} // end Lz_Flush
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Takes back the frames the pool is done with; run by the reactor as its wake-up descriptor turns ready
+ */
+static void Lz_Done()
+{
+    LZ_FRAME_PTR pf;
+    plz_done->Clear();
+    while (plz_done->Pop(pf))
+    {
+        if (pf->fd < 0)
+        {
+            delete pf;
+            continue;
+        } // end if link's gone
+
+        pf->bdone = true;
+        Lz_Flush(pf->fd, &vslots[pf->fd]);
+    } // end while
+} // end Lz_Done
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Starts the compression pool; without one, compression (if any) runs right on the reactor threads. Must be
+ *  called before any of them starts.
+ * 
+ * @param [threads] number of workers
+ */
+void Lz_Init(const int threads)
+{
+    for (int i = 0; i < threads; i++)
+    {
+        vlz_jobs.push_back(new MPSC_QUEUE<LZ_FRAME_PTR>);
+        std::thread(Lz_Worker, vlz_jobs.back()).detach();
+    } // end for
+} // end Lz_Init
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Has the frames sent down a tunnel link with Intap_Send() compressed from a given payload length on; only
+ *  once the peer's said it takes them (INTAP_CAP_LZ) and only in v2. Lasts till the link is closed.
+ * 
+ * @param [fds] the link 
+ * @param [min_len] shortest payload worth it; 0 turns it off
+ */
+void Intap_Compress(const int fds, const size_t min_len)
+{
+    if (fds >= 0)
+        Slot(fds)->lz_min = min_len;
+} // end Intap_Compress
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends a frame down a tunnel link; the header is written out to snd and goes along with the payload as is, 
+ *  no copying it over. On a compressing link (see Intap_Compress) a payload long enough is handed to the pool
+ *  instead, comes out LZ compressed if that makes it any shorter and then goes; till then whatever else is
+ *  sent to the link waits behind it.
+ * 
+ * @param [fds] the link 
+ * @param [pslot] its slot 
+ * @param [snd] room for the header; INTAP_MAX_HDR will do 
+ * @param [intap] the header 
+ * @param [buf] the payload 
+ * @param [len] its length 
+ * @param [version] INTAP version of the link
+ */
+static void Intap_Out(const int fds, REACTOR_SLOT_PTR pslot, char *snd, const INTAP_FMT &intap, const char *buf, 
+    const size_t len, const int version)
+{
+    u16 id = NTOHS(intap.id);
+    bool blz = pslot->lz_min && len >= pslot->lz_min && version >= INTAP_V2 && 
+        (id == CMD_ECHO || id == CMD_CLI_CONNECT || id == CMD_DB_CONNECT);
+
+    if (!blz && pslot->lzq.empty())
+    {
+        struct iovec iov[2];
+        iov[0].iov_base = snd;
+        iov[0].iov_len = Intap_Encode(snd, intap, version);
+        iov[1].iov_base = (void *)buf;
+        iov[1].iov_len = len;
+        Send_Iov(fds, iov, 2);
+        return;
+    } // end if straight out
+
+    LZ_FRAME_PTR pf = new LZ_FRAME;
+    pf->fd = fds;
+    pf->bytes = INTAP_MAX_HDR + len;
+    pslot->lzq_bytes += pf->bytes;
+    if (!blz)
+    {
+        // it waits its turn as it is
+        pf->frame.resize(INTAP_MAX_HDR + len);
+        size_t hlen = Intap_Encode(&pf->frame[0], intap, version);
+        memcpy(&pf->frame[hlen], buf, len);
+        pf->frame.resize(hlen + len);
+        pf->bdone = true;
+        pslot->lzq.push_back(pf);
+        return;
+    } // end if not to be compressed
+
+    memcpy((void *)&pf->intap, &intap, sizeof(intap));
+    pf->version = version;
+    pf->plain.assign(buf, len);
+    pslot->lzq.push_back(pf);
+
+    if (vlz_jobs.empty())
+    {
+        Lz_Frame(pf);
+        pf->bdone = true;
+        Lz_Flush(fds, pslot);
+        return;
+    } // end if no pool
+
+    if (!plz_done)
+    {
+        plz_done = new MPSC_QUEUE<LZ_FRAME_PTR>;
+        Reactor_Add(plz_done->wake_fd[0], EV_READ);
+    } // end if first time
+
+    pf->powner = plz_done;
+    vlz_jobs[lz_next.fetch_add(1, std::memory_order_relaxed) % vlz_jobs.size()]->Push(std::move(pf));
+} // end Intap_Out
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets the frames a scheduling link held back out onto it in the order its scheduler says, for as long as the
+ *  link has no more than EGRESS_BACKLOG on its way; the rest wait for it to drain some more (see Settle).
+ * 
+ * @param [fd] the link 
+ * @param [pslot] its slot 
+ */
+static void Egress_Release(const int fd, REACTOR_SLOT_PTR pslot)
+{
+    if (!pslot->psched || pslot->breleasing)
+        return;         // not scheduling or at it already further up
+
+    std::string frame;
+    char hdr[INTAP_MAX_HDR];
+
+    pslot->breleasing = true;
+    while (!pslot->bfailed && !pslot->bparked && Pending(pslot) + pslot->lzq_bytes < EGRESS_BACKLOG && 
+        Egress_Pop(*pslot->psched, frame))
+    {
+        Intap_Out(fd, pslot, hdr, *(const INTAP_FMT *)frame.data(), frame.data() + sizeof(INTAP_FMT), 
+            frame.size() - sizeof(INTAP_FMT), pslot->psched->version);
+    } // end while
+    pslot->breleasing = false;
+} // end Egress_Release
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Has the frames sent down a tunnel link with Intap_Send() scheduled; instead of going out in the order they 
+ *  were sent, they go deficit round-robin across the streams they're of, a stream's share weighted by its 
+ *  traffic class, with control frames ahead of them all (see egress-sched.h). Frames only ever wait while the 
+ *  link is backed up; one with room takes them as they come. Lasts till the link is closed.
+ * 
+ * @param [fds] the link 
+ * @param [weight_db] share of a database stream (EGRESS_DB) 
+ * @param [weight_rest] share of a RESTServer stream (EGRESS_REST) 
+ */
+void Intap_Schedule(const int fds, const int weight_db, const int weight_rest)
+{
+    if (fds < 0)
+        return;
+
+    REACTOR_SLOT_PTR pslot = Slot(fds);
+    if (!pslot->psched)
+        pslot->psched = new EGRESS_SCHED;
+
+    Egress_Weights(*pslot->psched, weight_db, weight_rest);
+} // end Intap_Schedule
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends a frame down a tunnel link (see Intap_Out). A scheduling link (see Intap_Schedule) with enough on 
+ *  its way already holds it back for its turn instead; a copy of it that is.
+ * 
+ * @param [fds] the link 
+ * @param [snd] room for the header; INTAP_MAX_HDR will do 
+ * @param [intap] the header 
+ * @param [buf] the payload 
+ * @param [len] its length 
+ * @param [version] INTAP version of the link
+ * @param [stream] the stream the frame is of (our descriptor); -1 for none
+ * @param [cls] the stream's traffic class (EGRESS_xxx); EGRESS_CONTROL for none
+ */
+void Intap_Send(const int fds, char *snd, const INTAP_FMT &intap, const char *buf, const size_t len, 
+    const int version, const int stream, const int cls)
+{
+    if (fds < 0)
+        return;
+
+    Metrics_Add(pmetrics->frames[METRICS_TX], 1);
+    Metrics_Add(pmetrics->bytes[METRICS_TX], len);
+    Metrics_Observe(pmetrics->frame_bytes[METRICS_TX], len, METRICS_SHIFT_BYTES);
+
+    REACTOR_SLOT_PTR pslot = Slot(fds);
+    EGRESS_SCHED_PTR psched = pslot->psched;
+    if (!psched || (pslot->bfailed && !Resumable(pslot)) || (!psched->bytes && !pslot->bfailed && 
+        !pslot->bparked && Pending(pslot) + pslot->lzq_bytes < EGRESS_BACKLOG))
+    {
+        Intap_Out(fds, pslot, snd, intap, buf, len, version);
+        return;
+    } // end if nothing to wait for
+
+    psched->version = version;
+    Egress_Push(*psched, stream, cls, intap, buf, len);
+    Egress_Release(fds, pslot);
+    Check_Pressure(fds, pslot);
+} // end Intap_Send
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Select based async socket multiplexing
+ * 
+ * @param [maxfdp] maximum descriptor 
+ * @param [rset] the reading sets 
+ */
+void Select(int maxfdp, fd_set &rset)
+{
+    if (select(maxfdp, &rset, NULL, NULL, NULL) <= 0)
+    {
+        perror("select");
+        exit(EXIT_FAILURE);
+    } // end if
+} // end Select
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Helps certain linux/unix system to reuse the existing socket whenerver system restarts. This is usually 
+ *  applied to a listening descriptor.
+ * 
+ * @param [lfd] listening socket 
+ */
+void Tcp_Reuse_Addr(const int lfd)
+{
+    u32 on{1};
+    if (setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, (char*)&on, sizeof(on)) < 0)
+    {
+        perror("setsockopt()");
+        exit(EXIT_FAILURE);
+    } // end if socket option failure
+} // end Tcp_Reuse_Addr
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets more than one listening socket bind the same port so that each reactor thread gets its own listener
+ *  and the kernel spreads the incoming connections among them. Systems without SO_REUSEPORT get a single
+ *  listener only (binding the rest fails).
+ * 
+ * @param [lfd] listening socket 
+ */
+void Tcp_Reuse_Port(const int lfd)
+{
+#if defined (SO_REUSEPORT)
+    u32 on{1};
+    if (setsockopt(lfd, SOL_SOCKET, SO_REUSEPORT, (char*)&on, sizeof(on)) < 0)
+    {
+        perror("setsockopt()");
+        exit(EXIT_FAILURE);
+    } // end if socket option failure
+#endif
+} // end Tcp_Reuse_Port
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sets a socket as a non-blocking mode
+ * 
+ * @param [fd] the descriptor to set as non-blocking 
+ * @param [bon] false puts it back into blocking mode
+ */
+void Set_Non_Blocking(int fd, const bool bon)
+{
+#if defined (__unix__) || defined (__linux__)
+    u32 on = bon ? 1 : 0;
+    if (ioctl(fd, FIONBIO, (char *)&on) < 0)
+        perror("ioctl() failed");
+#elif defined (WIN32) || defined (_WIN64)
+    unsigned long i_mode = bon ? 1 : 0;
+    if (ioctlsocket(fd, FIONBIO, &i_mode))
+        fprintf(stderr, "ioctlsocket() fail");
+#endif
+} // end Set_Non_Blocking
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Turns on the keep alive heart-beat signal; optionally a lot tighter than the system's two hours, for a 
+ *  tunnel link whose peer may vanish without a word (a WAN blip) and that's to be found out about in seconds.
+ * 
+ * @param [fd] the descriptor to keep-alive 
+ * @param [idle] seconds it may go quiet before it's probed, as many between probes; one that misses three of
+ *  them, or sits on sends that long without them being acknowledged, is given up on. 0 for the defaults
+ */
+void Tcp_Keep_Alive(const int fd, const int idle)
+{
+    u32 on{1};
+    if (setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, (char*)&on, sizeof(on)) < 0)
+    {
+        perror("setsocketopt()");
+        exit(EXIT_FAILURE);
+    } // end if
+
+#if defined (__linux__)
+    if (idle <= 0)
+        return;
+
+    int probes{3};
+    u32 user_ms = (u32)idle * (probes + 1) * 1000;
+    if (setsockopt(fd, SOL_TCP, TCP_KEEPIDLE, &idle, sizeof(idle)) < 0 ||
+        setsockopt(fd, SOL_TCP, TCP_KEEPINTVL, &idle, sizeof(idle)) < 0 ||
+        setsockopt(fd, SOL_TCP, TCP_KEEPCNT, &probes, sizeof(probes)) < 0 ||
+        setsockopt(fd, SOL_TCP, TCP_USER_TIMEOUT, &user_ms, sizeof(user_ms)) < 0)
+        perror("setsockopt(keep alive)");
+#endif
+} // end Tcp_Keep_Alive
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Toggles the Tcp_NoDelay on/off; i.e. the Negel's algorithim (don't know what that is yet ...)
+ * 
+ * @param [fds] the socket descriptor 
+ *  
+ * @return int 
+ *  a 0 on success alas -1
+ */
+int Tcp_NoDelay(const int fds)
+{
+#if defined(__unix__) || defined(__linux__)
+    u32 flag{1};
+    if (setsockopt(fds, SOL_TCP, TCP_NODELAY, (void*)&flag, sizeof(flag)) < 0)
+        return -1;
+#endif
+    return 0;
+} // end Tcp_NoDelay
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Specifies the socket to time out in the number of seconds provided, this is useful for avoiding blocking
+ *  recv calls, but there are better ways for that.
+ * 
+ * @param [fds] the socket descriptor 
+ *  
+ * @return int
+ *  a 0 on successful setting of the timeout, else -1 on fail 
+ */
+int Set_RecvTimeout(const int fds, const int sec)
+{
+    struct timeval timeout;
+    timeout.tv_sec = sec;
+    timeout.tv_usec = 0;
+
+    // set socket options
+    if (setsockopt(fds, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0)
+        return -1;
+    
+    return 0;
+} // end Set_Recv_Timeout
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Removes the descriptor from the reactor
+ * 
+ * @param fd 
+ */
+void Erase_Sock(const int fd)
+{
+    Reactor_Del(fd);
+} // end Erase_Sock
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Closes the descriptor. One with sends still queued up lingers on; it stays open (registered for writing 
+ *  only and invisible to the caller) till the queue drains, a send fails or LINGER_MS runs out, so that a
+ *  response isn't cut short just because the stream got closed right behind it.
+ * 
+ * @param [fd] the descriptor to close 
+ */
+void Close_Sock(const int fd)
+{
+    REACTOR_SLOT_PTR pslot = (fd >= 0 && (size_t)fd < vslots.size()) ? &vslots[fd] : nullptr;
+    if (pslot && Pending(pslot))
+    {
+        Flush_Out(fd, pslot);       // one last go at it right away
+        if (pslot->blinger || !Pending(pslot))
+            return;                 // dealt with (closed for real if it was already lingering)
+
+        pslot->blinger = true;
+        pslot->linger_deadline = Now_Ms() + LINGER_MS;
+        pslot->events = 0;
+        pslot->ctx = nullptr;
+        pslot->gen++;               // whatever the caller still has on it is stale now
+        Arm(fd, pslot);
+        vlinger.push_back(fd);
+        return;
+    } // end if something to drain
+
+    if (pslot)
+        Reset_Queue(pslot);
+
+    close(fd);
+} // end Close_Sock
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Creates the reactor; on linux that's an epoll instance (or io_uring if asked for and the kernel has it), 
+ *  everywhere else (or if epoll can't be had) we make do with plain old poll(). Must be called before any 
+ *  descriptor gets registered.
+ * 
+ * @param [backend] one of IO_EPOLL, IO_POLL or IO_URING 
+ * @param [buf_size] size of the buffers data gets delivered in (io_uring only)
+ */
+void Reactor_Init(const int backend, const size_t buf_size)
+{
+    Metrics_Thread();
+    if (backend == IO_URING)
+    {
+        if (Uring_Init(buf_size))
+            return;
+
+        fprintf(stderr, "io_uring not available, falling back to epoll.\n");
+    } // end if io_uring
+
+#if defined (__linux__)
+    if (backend != IO_POLL && (epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        perror("epoll_create1(), falling back to poll()");
+#endif
+} // end Reactor_Init
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Registers a descriptor with the reactor along with its context pointer
+ * 
+ * @param [fd] the descriptor to wait on 
+ * @param [events] what to wait for; EV_READ and/or EV_WRITE
+ * @param [ctx] the caller's context handed back with every event on this descriptor
+ */
+void Reactor_Add(const int fd, const u32 events, void *ctx)
+{
+    if (fd < 0)
+        return;
+
+    REACTOR_SLOT_PTR pslot = Slot(fd);
+    if (pslot->bused)
+    {
+        Reactor_Set_Ctx(fd, ctx);
+        Reactor_Mod(fd, events);
+        return;
+    } // end if already there
+
+    pslot->bused = true;
+    pslot->events = events;
+    pslot->ctx = ctx;
+    Arm(fd, pslot, true);
+} // end Reactor_Add
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Changes the interest set of an already registered descriptor
+ * 
+ * @param [fd] the descriptor 
+ * @param [events] the new set of events to wait for (0 pauses it save for errors)
+ */
+void Reactor_Mod(const int fd, const u32 events)
+{
+    if (fd < 0 || (size_t)fd >= vslots.size() || !vslots[fd].bused || vslots[fd].blinger)
+        return;
+
+    vslots[fd].events = events;
+    Arm(fd, &vslots[fd]);
+} // end Reactor_Mod
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Replaces the context pointer associated with a descriptor
+ * 
+ * @param [fd] the descriptor 
+ * @param [ctx] its new context
+ */
+void Reactor_Set_Ctx(const int fd, void *ctx)
+{
+    if (fd >= 0 && (size_t)fd < vslots.size() && vslots[fd].bused && !vslots[fd].blinger)
+        vslots[fd].ctx = ctx;
+} // end Reactor_Set_Ctx
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Returns the context pointer of a registered descriptor
+ * 
+ * @param [fd] the descriptor 
+ * 
+ * @return void*
+ *  the context or nullptr if none registered 
+ */
+void *Reactor_Ctx(const int fd)
+{
+    if (fd < 0 || (size_t)fd >= vslots.size() || !vslots[fd].bused)
+        return nullptr;
+
+    return vslots[fd].ctx;
+} // end Reactor_Ctx
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Unregisters the descriptor; any events for it still pending in the current batch become stale. Whatever's
+ *  queued on it stays queued (see Close_Sock).
+ * 
+ * @param [fd] the descriptor to remove 
+ */
+void Reactor_Del(const int fd)
+{
+    if (fd < 0 || (size_t)fd >= vslots.size() || !vslots[fd].bused)
+        return;
+
+    if (vslots[fd].blinger)
+        return;         // closed already; it lets go of the backend once it's drained
+
+    Unregister(fd, &vslots[fd]);
+} // end Reactor_Del
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Hands out error events for the descriptors whose sends failed since the last wait
+ */
+static int Failed_Events(REACTOR_EVENT_PTR pevents, const int max_events)
+{
+    int n{0};
+    size_t i{0};
+    for (; i < vfailed.size() && n < max_events; i++)
+    {
+        REACTOR_SLOT_PTR pslot = &vslots[vfailed[i]];
+        if (!pslot->bfailed || !pslot->bused || pslot->blinger)
+            continue;       // closed since (and maybe re-used)
+
+        pevents[n].fd = vfailed[i];
+        pevents[n].revents = EV_ERROR;
+        pevents[n].gen = pslot->gen;
+        pevents[n].ctx = pslot->ctx;
+        pevents[n].ibuf = -1;
+        n++;
+    } // end for
+
+    vfailed.erase(vfailed.begin(), vfailed.begin() + i);
+    return n;
+} // end Failed_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Writability is ours; queues get flushed right here and the caller only sees what it asked for. Events 
+ *  left with nothing in them (and those of lingering descriptors) are dropped, as is the compression pool's
+ *  wake-up once the frames it's done with are taken back.
+ * 
+ * @return int
+ *  the number of events left
+ */
+static int Filter_Events(REACTOR_EVENT_PTR pevents, const int nready)
+{
+    int n{0};
+    for (int i = 0; i < nready; i++)
+    {
+        REACTOR_EVENT ev = pevents[i];
+        if (plz_done && ev.fd == plz_done->wake_fd[0])
+        {
+            Lz_Done();
+            continue;
+        } // end if compressed frames are back
+
+        REACTOR_SLOT_PTR pslot = &vslots[ev.fd];
+        if ((ev.revents & (EV_WRITE | EV_ERROR)) && Pending(pslot))
+            Flush_Out(ev.fd, pslot);
+
+        if (!pslot->bused || pslot->blinger)
+            continue;
+
+        ev.revents &= pslot->events | EV_ERROR;
+        if (ev.revents == 0)
+            continue;
+
+        ev.ctx = pslot->ctx;
+        pevents[n++] = ev;
+    } // end for
+
+    return n;
+} // end Filter_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Waits on the backend itself; the events come back as the backend had them, before Filter_Events 
+ * 
+ * @return int
+ *  the number of ready events, 0 on timeout or interruption, -1 on error 
+ */
+static int Wait_Ready(REACTOR_EVENT_PTR pevents, const int max_events, const int timeout)
+{
+    int nready{0};
+
+    if (Uring_Active())
+        return Uring_Wait(pevents, std::min(max_events, MAX_EVENTS), timeout);
+
+#if defined (__linux__)
+    if (epoll_fd >= 0)
+    {
+        struct epoll_event evs[MAX_EVENTS];
+        if ( (nready = epoll_wait(epoll_fd, evs, std::min(max_events, MAX_EVENTS), timeout)) < 0)
+            return errno == EINTR ? 0 : -1;
+
+        for (int i = 0; i < nready; i++)
+        {
+            int fd = (int)(evs[i].data.u64 & 0xFFFFFFFF);
+            pevents[i].fd = fd;
+            pevents[i].revents = evs[i].events;
+            pevents[i].gen = (u32)(evs[i].data.u64 >> 32);
+            pevents[i].ibuf = -1;
+        } // end for
+
+        return nready;
+    } // end if epoll
+#endif
+
+    if (POLL_TIMEOUT(vpoll.data(), vpoll.size(), timeout) < 0)
+        return errno == EINTR ? 0 : -1;
+
+    for (auto &x : vpoll)
+    {
+        if (x.revents == 0)
+            continue;
+
+        pevents[nready].fd = x.fd;
+        pevents[nready].revents = x.revents;
+        pevents[nready].gen = vslots[x.fd].gen;
+        pevents[nready].ibuf = -1;
+        if (++nready == max_events)
+            break;
+    } // end for
+
+    return nready;
+} // end Wait_Ready
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Waits for ready descriptors and fills the events array with them; the sends batched up since the last 
+ *  wait go out first. The time from coming back from the last wait till now is what the loop took going 
+ *  through its events (see metrics.h).
+ * 
+ * @param [pevents] storage for the ready events 
+ * @param [max_events] the capacity of the array above 
+ * @param [timeout] timeout in milli-seconds; -1 waits forever
+ * 
+ * @return int
+ *  the number of ready events, 0 on timeout or interruption, -1 on error 
+ */
+int Reactor_Wait(REACTOR_EVENT_PTR pevents, const int max_events, int timeout)
+{
+    int nready{0};
+
+    Flush_Dirty();
+    if (!vlinger.empty())
+    {
+        Expire_Lingers();
+        if (!vlinger.empty() && (timeout < 0 || timeout > LINGER_TICK))
+            timeout = LINGER_TICK;
+    } // end if some lingering
+
+    if ( (nready = Failed_Events(pevents, max_events)) > 0)
+        return nready;
+
+    if (loop_us)
+        Metrics_Observe(pmetrics->loop_us, Now_Us() - loop_us, METRICS_SHIFT_US);
+
+    nready = Wait_Ready(pevents, max_events, timeout);
+    loop_us = Now_Us();
+    Metrics_Add(pmetrics->wakeups, 1);
+    if (nready <= 0)
+        return nready;
+
+    Metrics_Observe(pmetrics->events, nready, METRICS_SHIFT_ONE);
+    return Filter_Events(pevents, nready);
+} // end Reactor_Wait
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Tells if an event has gone stale; i.e. the descriptor got removed (and possibly re-used) while processing
+ *  the earlier events of the same batch.
+ * 
+ * @param [ev] the event to test 
+ * 
+ * @return true 
+ *  if the event must be ignored 
+ */
+bool Reactor_Stale(const REACTOR_EVENT &ev)
+{
+    return ev.fd < 0 || (size_t)ev.fd >= vslots.size() || !vslots[ev.fd].bused || vslots[ev.fd].gen != ev.gen;
+} // end Reactor_Stale
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Reads what's ready on the descriptor of an event; with io_uring the data usually came along with the event
+ *  so there's no system call to be made.
+ * 
+ * @param [ev] the ready event 
+ * @param [buf] where to put the data 
+ * @param [buf_len] the capacity of the buffer 
+ * 
+ * @return int
+ *  bytes read, 0 on end of file and -1 on error (errno is set)
+ */
+int Reactor_Recv(const REACTOR_EVENT &ev, char *buf, const size_t buf_len)
+{
+    if (Uring_Active())
+        return Uring_Recv(ev, buf, buf_len);
+
+    return (int)recv(ev.fd, buf, buf_len, 0);
+} // end Reactor_Recv
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sets the calling thread's backpressure hook; called as its outbound queues cross the water marks
+ * 
+ * @param [cb] the hook; nullptr for none
+ */
+void Reactor_On_Congestion(CONGESTION_CB cb)
+{
+    on_congestion = cb;
+} // end Reactor_On_Congestion
 
 
 //==============================================================================================================|
@@ -12,7 +12,7 @@
 //  20th of March 2023, Monday
 //
 // Last Updated:
-//  6th of April 2023, Thursday
+//  17th of October 2026, Saturday
 //
 //==============================================================================================================|
 
@@ -22,13 +22,34 @@
 // INCLUDES
 //==============================================================================================================|
 #include "utils.h"
+#include "mpsc-queue.h"
+#include "stream-table.h"
+#include "tunnel-tls.h"
 
 
 
 //==============================================================================================================|
 // DEFINES
 //==============================================================================================================|
+#define MAX_REACTOR_THREADS     64          // upper bound on "Reactor_Threads"
+#define MAX_SHARD_FDS           65536       // INTAP carries descriptors in 16 bits; so does the owner table
+#define MAX_TUNNEL_LINKS        16          // upper bound on "Tunnel_Links"
 
+// what's handed between reactor threads
+#define MSG_TO_TUNNEL           0           // a ready frame to go down the tunnel; for the thread owning it
+#define MSG_FROM_TUNNEL         1           // a frame off the tunnel; for the thread owning its descriptor
+#define MSG_RESUME              2           // the tunnel drained; streams held back may go on reading
+#define MSG_RESET               3           // the tunnel's session is gone; so are the streams over it
+
+// trying lost tunnel links again; the wait doubles from the least to the most, give or take half of it
+#define RESUME_WAIT_MIN         100         // milli-seconds
+#define RESUME_WAIT_MAX         5000
+#define LINK_ANSWER_MS          3000        // how long local-buddy may take answering a hello or a resume
+
+// the step a link being reconnected is on (see Dial_Link)
+#define DIAL_CONNECTING         0           // the connect's on its way
+#define DIAL_TLS                1           // the TLS handshake is
+#define DIAL_ANSWER             2           // it's said what it's for; local-buddy's answer is
 
 
 
@@ -36,13 +57,51 @@
 //==============================================================================================================|
 // TYPES
 //==============================================================================================================|
-// a little structure that helps sync request...responses -- WSIS clients have the tendency to send requests without
-//  awiating for responses during poll() or select().
-typedef struct SOCK_WAIT_FMT
+// a frame on its way from one reactor thread to another
+typedef struct SHARD_MSG_FMT
+{
+    int kind{MSG_TO_TUNNEL};    // one of MSG_xxx
+    int link{-1};               // the tunnel link it goes down (MSG_TO_TUNNEL)
+    int stream{-1};             // and the stream it's of along with its traffic class (see Intap_Schedule)
+    int cls{EGRESS_CONTROL};
+    std::string frame;          // INTAP header followed by its payload
+} SHARD_MSG, *SHARD_MSG_PTR;
+
+
+// a reactor thread; each one has its own listener, reactor and descriptors. Only the first one talks to
+//  local-buddy, the rest pass their frames through its inbox.
+typedef struct SHARD_FMT
+{
+    int id{0};                      // index in vshards; 0 owns the tunnel
+    MPSC_QUEUE<SHARD_MSG> inbox;    // frames handed to us by the others
+} SHARD, *SHARD_PTR;
+
+
+// a tunnel link being reconnected; a step at a time as it turns ready, on the reactor along with everything 
+//  else (see Dial_Link)
+typedef struct LINK_DIAL_FMT
 {
-    int fd;                 // a descriptor that's on the left side
-    bool brequest{true};    // indicates that its ready to process requests from clients
-} MI_SOCK_WAIT, *MI_SOCK_WAIT_PTR;
+    int fd{-1};                     // the new connection; -1 if none's on its way
+    size_t link{0};                 // index in vlinks of the link it's for
+    u16 cmd{CMD_RESUME};            // what it's for; CMD_RESUME, or CMD_HELLO and CMD_JOIN for a new session
+    int state{DIAL_CONNECTING};     // the step it's on (DIAL_xxx)
+    u64 deadline{0};                // and when that's given up on
+    void *pssl{nullptr};            // the TLS handshake while it's on
+    size_t got{0};                  // how much of local-buddy's answer is in
+    char answer[sizeof(INTAP_FMT) + sizeof(u64)];   // the answer; its header and the session or sequence number
+} LINK_DIAL, *LINK_DIAL_PTR;
+
+
+// a new session as the links are taken by local-buddy one after the other (see Take_Session)
+typedef struct SESSION_DIAL_FMT
+{
+    std::vector<int> vfd;           // the new connections so far, one a link in the order of vlinks
+    std::vector<int> vpeer;         // local-buddy's end of each; -1 for the one of old that never answers
+    int lead_fd{-1};                // local-buddy's end of the first one; the others join it
+    int version{INTAP_V1};          // the terms the first one's hello was answered with (see Hello_Terms)
+    u16 caps{0};
+    size_t frame{0};
+} SESSION_DIAL, *SESSION_DIAL_PTR;
 
 
 
@@ -51,10 +110,33 @@ typedef struct SOCK_WAIT_FMT
 //==============================================================================================================|
 // GLOBALS
 //===================================================================================================
-int listen_fd{-1};                      // the listening descriptor (one ring to rule them all)
 u16 listen_port{8888};                  // the port for listening server
-int local_fd = -1;                      // descriptor to local-buddy
-std::unordered_map<int, MI_SOCK_WAIT> mfds;      // map of remote-buddy to local-buddy descriptors
+std::vector<int> vlinks;                // the tunnel links to local-buddy; all kept by the first thread
+std::vector<INTAP_RX> vlink_rx;         // what's been read off each of them; the link's context
+std::vector<int> vlink_peer;            // and local-buddy's end of each; what a lost one's resumed by
+u64 session{0};                         // what local-buddy has the links under (INTAP_CAP_RESUME); 0 for none
+int tunnel_links{1};                    // how many we'd like ("Tunnel_Links" in config.dat)
+std::atomic<int> intap_version{INTAP_V1};       // what local-buddy and us settled on (see Hello_Buddy, Take_Session)
+std::atomic<u16> intap_caps{0};                 // likewise for the capabilities (INTAP_CAP_xxx)
+std::atomic<size_t> tunnel_frame_max{BUF_SIZE}; // and the longest payload a frame may carry (see INTAP_CAP_FRAME)
+int reactor_threads{1};                 // number of reactor threads ("Reactor_Threads" in config.dat)
+std::vector<SHARD_PTR> vshards;         // the reactor threads
+std::atomic<u8> fd_shard[MAX_SHARD_FDS];        // which thread owns a descriptor
+u32 next_shard{0};                      // round robin for new db connections (tunnel thread only)
+std::atomic<bool> blink_congested[MAX_TUNNEL_LINKS];    // which tunnel links are backed up (see On_Congestion)
+std::atomic<bool> btunnel_lost{false};  // the session's gone till there's a new one; new clients are turned away
+u64 resume_at{0};                       // when lost links are tried again (tunnel thread only); 0 if none's lost
+u64 resume_by{0};                       // and when they're given up on for a new session
+int resume_wait{RESUME_WAIT_MIN};       // the wait till the next try after this one
+LINK_DIAL dial;                         // the link being reconnected (tunnel thread only)
+SESSION_DIAL vsession;                  // and the new session it's for, if it's for one
+
+thread_local SHARD_PTR pshard;                          // the calling reactor thread
+thread_local int listen_fd{-1};                         // its listening descriptor (one ring to rule them all)
+thread_local std::unordered_map<int, int> mrfd;        // local-buddy's db stream descriptors back to ours
+thread_local std::vector<int> vpaused;                  // streams held back for a backed up link
+thread_local std::unordered_map<int, CONNECT_WAIT> mconnecting; // RDBMS connects still on their way
+thread_local UPSTREAM_POOL_PTR pdb_pool{nullptr};               // warm RDBMS sockets; each thread its share
 
 std::string server_ip,      // ip address of RESTful server
             db_ip,          // ip address of database
@@ -63,7 +145,7 @@ u16 server_port,            // port for RESTful server
     db_port,                // port for database server
     local_port;             // port for local-buddy
 
-bool bsend_close{true};      // direction of close
+thread_local bool bsend_close{true};      // direction of close
 
 
 
@@ -72,10 +154,49 @@ bool bsend_close{true};      // direction of close
 //==============================================================================================================|
 void Init(int argc, char **argv);
 inline void Hello_Buddy();
-void New_Db(const int fd, const char *pbuf, const INTAP_FMT_PTR pintap, const size_t len);
+int Hello_Link(const int i, const int lead_fd, INTAP_FMT &answer, u64 &sess, bool &banswered);
+std::string Hello_Request(const size_t i, const int lead_fd, const u64 stale, const int fd);
+std::string Resume_Request(const size_t i);
+void Hello_Terms(const INTAP_FMT *panswer, int &version, u16 &caps, size_t &frame);
+void Lose_Link(const int fd);
+void Lose_Tunnel();
+void Reset_Streams();
+void Resume_Links();
+void Retry_Later();
+bool Dial_Link(const size_t i, const u16 cmd);
+void Dial_Event(const u32 revents);
+void Dial_Connected();
+void Dial_Tls();
+void Dial_Request();
+void Dial_Read();
+void Dial_Expired();
+void Dial_Answered(const bool banswered);
+void Dial_Failed();
+void Dial_Close();
+void Drop_Session();
+void Take_Session();
+int Resume_Wait_Ms(int timeout);
+void Shard_Loop(SHARD_PTR ps);
+void Tunnel_Frames(const int fd, INTAP_RX &rx);
+void Tunnel_Frame(const INTAP_FMT_PTR pintap, const char *buf, const int bytes);
+void Process_Frame(const INTAP_FMT_PTR pintap, const char *buf, const int bytes);
+int Splice_Frame(const INTAP_FMT_PTR pintap, const int fd, INTAP_RX &rx);
+void To_Tunnel(const INTAP_FMT &intap, const char *buf, const int bytes, const int stream=-1, 
+    const int cls=EGRESS_CONTROL);
+void Drain_Inbox();
+int Link_Index(const int fd);
+int Tunnel_Link(const INTAP_FMT &intap, const int stream);
+bool Is_Link(const int fd);
+void On_Congestion(const int fd, const bool bcongested);
+void Resume_Streams();
+int Paired_Fd(const INTAP_FMT_PTR pintap);
+void Upstream_Send(STREAM_PTR pstream, const int fd, const char *buf, const size_t len);
+void Grant_Credit(STREAM_PTR pstream, const int fd, const size_t bytes);
+void Finish_Connect(const int fd);
+void Expire_Connects();
+void New_Db(const char *pbuf, const INTAP_FMT_PTR pintap, const size_t len);
 void Close_Sockets();
 void Kill_Sock(const int fd);
-inline void Dump(const char *msg, ...);
 
 
 
@@ -103,65 +224,135 @@ int main(int argc, char *argv[])
     // Initalize                
     Init(argc, argv);
 
+    if (lz_min > 0)
+        Lz_Init(lz_threads);
+
     // start connecting with local buddy
     Dump("connecting with \033[33mlocal-buddy\033[37m ..");
     Hello_Buddy();
-    Dump("connected to \033[33mlocal-buddy\033[37m");
+    Dump("connected to \033[33mlocal-buddy\033[37m over %d link(s)", (int)vlinks.size());
+
+    // the reactor threads; this one here becomes the first and keeps the tunnel
+    for (int i = 0; i < reactor_threads; i++)
+    {
+        vshards.push_back(new SHARD);
+        vshards.back()->id = i;
+    } // end for
+
+    for (int i = 1; i < reactor_threads; i++)
+        std::thread(Shard_Loop, vshards[i]).detach();
+
+    Dump("running on %d reactor thread(s)", reactor_threads);
+    Shard_Loop(vshards[0]);
+
+    Close_Sockets();
+    Log_Close();
+    return 0;
+} // end main
+
 
+//==============================================================================================================|
+/**
+ * @brief
+ *  The event loop of a reactor thread. Each has its own SO_REUSEPORT listener so the kernel spreads clients
+ *  among them, and each keeps to its own descriptors; what's bound for the tunnel goes through the inbox of
+ *  the first thread and what comes off the tunnel goes to the inbox of the thread owning the descriptor.
+ *
+ * @param [ps] the reactor thread
+ */
+void Shard_Loop(SHARD_PTR ps)
+{
+    pshard = ps;
+    if (ps->id > 0)
+        Alloc_Buffers();        // the first one got them along the command line
     
     // get me sockets for the remote side and local sides; for now lets make things simple
     //  by requesting IPv4 format on TCP layer; TCP/IPv4
     listen_fd = Socket();
 
-    // force the reusing of address on linux systems
+    // force the reusing of address on linux systems; every thread listens on the same port
     Tcp_Reuse_Addr(listen_fd);
+    Tcp_Reuse_Port(listen_fd);
     Tcp_NoDelay(listen_fd);
 
     // Bind and start listen
     Bind(listen_fd, listen_port);
     Listen(listen_fd, backlog);
 
-    memset(&fdpoll, 0, sizeof(fdpoll));
-    fdpoll.fd = listen_fd;
-    fdpoll.events = POLLIN;
-    vpoll.push_back(fdpoll);        // now add to the list of 'we'd wanna wait on descriptors'
+    Reactor_Init(io_backend, buffer_size);
+    Reactor_Add(listen_fd, EV_READ);    // now add to the list of 'we'd wanna wait on descriptors'
+    Reactor_Add(ps->inbox.wake_fd[0], EV_READ);
+    Reactor_On_Congestion(On_Congestion);      // the links on the tunnel thread; streams draining on all
+    if (ps->id == 0)
+    {
+        for (size_t i = 0; i < vlinks.size(); i++)
+            Reactor_Add(vlinks[i], EV_READ, &vlink_rx[i]);
+
+        // it's the tunnel thread that serves the metrics; all the threads' are there to read
+        if (metrics_port > 0 && Metrics_Listen(metrics_port))
+            Dump("serving metrics on 127.0.0.1:%d", metrics_port);
+    } // end if tunnel thread
 
-    fdpoll.fd = local_fd;
-    vpoll.push_back(fdpoll); 
+    // the warm RDBMS sockets are split among the threads; new db streams are too
+    int share = pool_size > 0 ? std::max(1, (pool_size + reactor_threads - 1) / reactor_threads) : 0;
+    pdb_pool = Pool_Open(db_ip.c_str(), db_port, share, 0, pool_idle_ms, connect_timeout);
 
+    REACTOR_EVENT events[MAX_EVENTS];
     while (true)
     {
         Dump("waiting for ready sockets ..");
-        if ( POLL(vpoll.data(), vpoll.size()) <= 0 )
+        int nready = Reactor_Wait(events, MAX_EVENTS, Resume_Wait_Ms(Pool_Wait_Ms(Connect_Wait_Ms(mconnecting))));
+        if (nready < 0)
         {
-            perror("poll()");
+            perror("Reactor_Wait()");
             break;
         } // end if poll error
 
+        Expire_Connects();
+        Pool_Tick();
+        if (ps->id == 0)
+            Resume_Links();
+
         // print descriptors
         if (debug_mode & DEBUG_L2)
         {
-            Dump("sockets =");
-            for (auto &x : vpoll)
-                printf("%d, ", x.fd);
-            printf("\n");
+            std::string ready;
+            for (int i = 0; i < nready; i++)
+                ready += std::to_string(events[i].fd) + ", ";
+            Dump("ready sockets = %s", ready.c_str());
         } // end if print descriptors 
             
-        // a descriptor is ready, but which one?
-        //  make copies to make life easy for our descriptors
-        std::vector<struct pollfd> tempfd{vpoll};
-        for (size_t i = 0; i < tempfd.size(); i++)
+        // a descriptor is ready, but which one? the reactor only hands us the ready ones along with
+        //  whatever context we stored on them; events for sockets killed along the way are stale.
+        for (int i = 0; i < nready; i++)
         {
-            if (tempfd[i].revents == 0)
+            if (Reactor_Stale(events[i]) || Pool_Event(events[i]) || Metrics_Event(events[i]))
+                continue;
+
+            if (ps->id == 0 && events[i].fd == dial.fd)
+            {
+                Dial_Event(events[i].revents);
                 continue;
+            } // end if a link being reconnected
+
+            // the streams are found by descriptor; the tunnel links alone carry a context
+            STREAM_PTR pstream = Stream_Get(events[i].fd);
+            if (pstream && pstream->state == STREAM_CONNECTING)
+            {
+                Finish_Connect(events[i].fd);
+                continue;
+            } // end if connect done
             
-            if (!(tempfd[i].revents & POLLIN))
+            if (!(events[i].revents & EV_READ))
             {
-                Kill_Sock(tempfd[i].fd);
+                if (events[i].ctx)
+                    Lose_Link(events[i].fd);
+                else
+                    Kill_Sock(events[i].fd);
                 continue;
             } // end if
 
-            if (tempfd[i].fd == listen_fd)
+            if (events[i].fd == listen_fd)
             {
                 char addr_str[INET_ADDRSTRLEN];
                 u16 port;
@@ -169,11 +360,18 @@ int main(int argc, char *argv[])
                 if (nfd <= 0)
                     continue;
 
+                Reactor_Mod(nfd, EV_READ | EV_RECV);     // clients are always plain streams
+                fd_shard[(u16)nfd].store(ps->id, std::memory_order_relaxed);
+
                 Dump("accepted new connection from host (%s:%d)", addr_str, port);
             } // end if listening
+            else if (events[i].fd == ps->inbox.wake_fd[0])
+            {
+                Drain_Inbox();
+            } // end if handed some frames
             else 
             {
-                int fd = tempfd[i].fd;
+                int fd = events[i].fd;
                 
                 // What do we know at this point? In much the same way as local-buddy, remote-buddy too
                 //  expects connections from these sources
@@ -182,110 +380,115 @@ int main(int argc, char *argv[])
                 //  3. from database responses -- the connection must exist (since its a response)
 
                 // maybe this is the local-buddy?
-                if (fd == local_fd)
+                if (events[i].ctx)
                 {
-                    INTAP_FMT intap;
-                    int bytes = Recv(fd, (char*)&intap, sizeof(intap));
-                    if (bytes <= 0)
+                    // take in all there is and deal with every frame that's whole; the rest waits for more
+                    INTAP_RX_PTR prx = (INTAP_RX_PTR)events[i].ctx;
+                    int bytes = Intap_Fill(fd, *prx);
+                    if (bytes < 0)
                     {
-                        Kill_Sock(fd);
+                        Lose_Link(fd);
                         continue;
                     } // end bytes
 
-                    // now get the actual info we need
-                    if ( (bytes = Recv(fd, buffer, NTOHL(intap.buf_len))) <=  0)
-                    {
-                        Kill_Sock(fd);
-                        continue;
-                    } // end if
-
                     if (debug_mode & DEBUG_L3)
-                    {
-                        Dump("got total bytes %d from \033[32mlocal-buddy\033[37m on socket %d", 
-                            bytes + sizeof(intap), fd);
-                        Dump_Hex((char*)&intap, sizeof(intap));
-                        Dump_Hex(buffer, bytes);
-                    } // end if debug_mode
+                        Dump("got %d bytes from \033[32mlocal-buddy\033[37m on socket %d", bytes, fd);
 
-                    // its either the clients or db responses that's what we get here
-                    if (!strncmp(intap.signature, "INTAP11", 8))
-                    {
-                        int id = NTOHS(intap.id);
-                        switch (id)
-                        {
-                            case CMD_BYEBYE:    // closing are we
-                                bsend_close = false;
-                                if (NTOHS(intap.dest_fd) > 0)
-                                    Kill_Sock(NTOHS(intap.dest_fd));
-                                else
-                                    Kill_Sock(fd);
-                                break;
-
-                            case CMD_DB_CONNECT:    // new db connection
-                                New_Db(fd, buffer, &intap, bytes);
-                                break;
-
-                            case CMD_ECHO:  // routing as is
-                            {
-                                int lfd = NTOHS(intap.dest_fd);
-                                int rfd = NTOHS(intap.src_fd);
-
-                                Send(lfd, buffer, bytes);
-                                if (strstr(buffer, "HTTP/1.1 100 Continue"))
-                                    mfds[lfd].brequest = true;
-
-                                if (mfds[lfd].fd <= 0)
-                                    mfds[lfd].fd = rfd;
-                            } break;
-                        } // end switch
-                    } // end if intap
-                    else 
-                    {
-                        fprintf(stderr, "\033[31m> remote-buddy:\033[37m mi dispiace, errore di protocolo!\n");
-                    } // end else
+                    Tunnel_Frames(fd, *prx);
                 } // end if local-buddy
                 else
                 {
                     // a database response or a client request? which one? would be up to you ...
                     // but from the descriptor side we can view it as new connection or existing.
-                    auto it = mfds.find(fd);
-                        if (it != mfds.end())
-                            if (!mfds[fd].brequest)
-                                continue;
+                    if (pstream && (pstream->flags & SF_HOLD))
+                    {
+                        // hold it right there till we see "100 Continue"; no point spinning on it
+                        Reactor_Mod(fd, 0);
+                        continue;
+                    } // end if waiting
 
-                    memset(buffer, 0, buffer_size);
-                    int bytes = recv(fd, buffer, buffer_size, 0);
+                    if (pstream && blink_congested[Link_Index(fd)].load(std::memory_order_relaxed))
+                    {
+                        // its tunnel link is backed up; this one waits till it drains (see On_Congestion)
+                        Reactor_Mod(fd, 0);
+                        if (!(pstream->flags & SF_PAUSED))
+                        {
+                            pstream->flags |= SF_PAUSED;
+                            vpaused.push_back(fd);
+                        } // end if not held yet
+                        continue;
+                    } // end if backed up
+
+                    bool bwindow = pstream && (intap_caps.load(std::memory_order_relaxed) & INTAP_CAP_WINDOW);
+                    if (bwindow && pstream->credit <= 0)
+                    {
+                        // local-buddy has all of this one it's willing to take; it says when (CMD_WINDOW)
+                        Reactor_Mod(fd, 0);
+                        pstream->flags |= SF_STALLED;
+                        continue;
+                    } // end if out of credit
+
+                    // a stream is read for as much as its traffic has shown it takes (and it has credit for);
+                    //  anything new for -bs
+                    size_t fmax = tunnel_frame_max.load(std::memory_order_relaxed);
+                    size_t size = pstream ? Stream_Read_Size(pstream, fmax) : buffer_size;
+                    if (bwindow)
+                        size = std::min(size, (size_t)pstream->credit);
+
+                    int bytes = Reactor_Recv(events[i], buffer, size);
                     if (bytes <= 0)
                     {
                         Kill_Sock(fd);
                         continue;
                     } // end bytes
 
+                    buffer[bytes] = '\0';
+                    if (pstream)
+                        Stream_Adapt(pstream, bytes, fmax);
+                    if (bwindow)
+                        pstream->credit -= bytes;
+
                     if (debug_mode & DEBUG_L3)
                     {
                         Dump("got total bytes %d from peer on socket %d", bytes, fd);
                         Dump_Hex(buffer, bytes);
                     } // end if debug_mode
 
-                    if (it != mfds.end())
+                    if (pstream)
                     {
                         Dump("routing to \033[33mlocal-buddy\033[37m");
 
                         INTAP_FMT intap;
-                        intap.id = HTONS(CMD_ECHO);
-                        intap.src_fd = HTONS(it->first);
-                        intap.dest_fd = HTONS(it->second.fd);
-                        intap.buf_len = HTONL(bytes);
-
-                        CPY_SND_BUFFER(local_fd, snd_buffer, intap, buffer, bytes);
+                        Stream_Echo(intap, pstream, fd, bytes, intap_version.load(std::memory_order_relaxed));
+                        To_Tunnel(intap, buffer, bytes, fd, Stream_Class(pstream));
                         if (strstr(buffer, "Expect: 100-continue"))
-                            it->second.brequest = false;
+                        {
+                            pstream->flags |= SF_HOLD;
+                            Reactor_Mod(fd, 0);
+                        } // end if
                     } // end if existing
                     else
                     {
+                        // WSIS clients have the tendency to send requests without awaiting for responses;
+                        //  one expecting "100 Continue" is held till it comes
                         Dump("new client request");
-                        INTAP_FMT intap;
-                        MI_SOCK_WAIT sw{-1, true};
+                        if (btunnel_lost.load(std::memory_order_relaxed))
+                        {
+                            // nowhere to send it till local-buddy's back
+                            Kill_Sock(fd);
+                            continue;
+                        } // end if no tunnel
+
+                        bool bhold = strstr(buffer, "Expect: 100-continue") != nullptr;
+                        if (!(pstream = Stream_Open(fd, nullptr, -1, STREAM_OPEN, bhold ? SF_HOLD : 0)))
+                        {
+                            Kill_Sock(fd);
+                            continue;
+                        } // end if no room
+
+                        pstream->credit -= bytes;
+
+                        INTAP_FMT intap{};      // zeroed; the ip below must come out null terminated
 
                         intap.id = HTONS(CMD_CLI_CONNECT);
                         intap.src_fd = HTONS(fd);
@@ -293,21 +496,963 @@ int main(int argc, char *argv[])
                         intap.port = HTONS(server_port);
                         strncpy(intap.ip, server_ip.c_str(), 
                             (server_ip.length() > INET_ADDRSTRLEN ? INET_ADDRSTRLEN : server_ip.length()) );
-                        CPY_SND_BUFFER(local_fd, snd_buffer, intap, buffer, bytes);
-
-                        if (strstr(buffer, "Expect: 100-continue"))
-                            sw.brequest = false;
-
-                        mfds[fd] = sw;
+                        To_Tunnel(intap, buffer, bytes, fd, EGRESS_REST);
+                        if (bhold)
+                            Reactor_Mod(fd, 0);
                     } // end else new client request
                 } // end else not local
             } // end else
         } // end for
     } // end while
+} // end Shard_Loop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Deals with every whole frame read off a tunnel link so far (see Intap_Fill); one cut short waits for the 
+ *  rest of it, unless it's a big enough payload to go straight through to its stream.
+ *
+ * @param [fd] the link
+ * @param [rx] what's been read off it
+ */
+void Tunnel_Frames(const int fd, INTAP_RX &rx)
+{
+    INTAP_FMT intap;
+    const char *payload;
+    int status;
+
+    while ( (status = Intap_Next(rx, intap, payload)) != INTAP_RX_MORE)
+    {
+        if (status == INTAP_RX_SPLICE)
+        {
+            if (NTOHS(intap.id) != CMD_ECHO || (status = Splice_Frame(&intap, fd, rx)) == 0)
+                break;          // the rest comes the usual way
+            else if (status < 0)
+            {
+                Lose_Link(fd);
+                return;
+            } // end if link's gone
+
+            continue;
+        } // end if big one
+
+        if (status == INTAP_RX_BAD || strncmp(intap.signature, "INTAP11", 8))
+        {
+            fprintf(stderr, "\033[31m> remote-buddy:\033[37m mi dispiace, errore di protocolo!\n");
+            Kill_Sock(fd);
+            return;
+        } // end if garbage
+
+        if (debug_mode & DEBUG_L3)
+        {
+            Dump("got total bytes %d from \033[32mlocal-buddy\033[37m on socket %d", 
+                (int)(NTOHL(intap.buf_len) + sizeof(intap)), fd);
+            Dump_Hex((char*)&intap, sizeof(intap));
+            Dump_Hex(payload, NTOHL(intap.buf_len));
+        } // end if debug_mode
+
+        // local-buddy got this much off the link; it needn't be kept for a replay anymore
+        if (NTOHS(intap.id) == CMD_ACK)
+        {
+            if (NTOHL(intap.buf_len) == sizeof(u64))
+                Intap_Acked(fd, NTOHLL(*(const u64 *)payload));
+            continue;
+        } // end if acknowledged
+
+        // its either the clients or db responses that's what we get here
+        Tunnel_Frame(&intap, payload, NTOHL(intap.buf_len));
+        if (Reactor_Ctx(fd) != &rx)
+            return;             // the link went down along with it
+    } // end while
+
+    if (intap_caps.load(std::memory_order_relaxed) & INTAP_CAP_RESUME)
+        Intap_Ack(fd, rx, intap_version.load(std::memory_order_relaxed));
+} // end Tunnel_Frames
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A frame just came off the tunnel; it's handled right here if the descriptor is ours, otherwise it's handed
+ *  over to the thread owning the descriptor. New db connections go round robin.
+ *
+ * @param [pintap] the INTAP header
+ * @param [buf] the payload
+ * @param [bytes] length of payload
+ */
+void Tunnel_Frame(const INTAP_FMT_PTR pintap, const char *buf, const int bytes)
+{
+    // db streams are placed by local-buddy's descriptor; that's all a frame carries till we've responded
+    int target{pshard->id};
+    int by_src = NTOHS(pintap->src_fd) % vshards.size();
+    switch (NTOHS(pintap->id))
+    {
+        case CMD_ECHO:
+        case CMD_BYEBYE:
+        case CMD_WINDOW:
+            if ((s16)NTOHS(pintap->dest_fd) > 0)
+                target = fd_shard[NTOHS(pintap->dest_fd)].load(std::memory_order_relaxed);
+            else
+                target = by_src;
+            break;
+
+        case CMD_DB_CONNECT:
+            target = by_src;
+            break;
+    } // end switch
+
+    if (target == pshard->id)
+    {
+        Process_Frame(pintap, buf, bytes);
+        return;
+    } // end if ours
+
+    SHARD_MSG msg;
+    msg.kind = MSG_FROM_TUNNEL;
+    msg.frame.reserve(sizeof(INTAP_FMT) + bytes);
+    msg.frame.append((const char *)pintap, sizeof(INTAP_FMT));
+    msg.frame.append(buf, bytes);
+    vshards[target]->inbox.Push(std::move(msg));
+} // end Tunnel_Frame
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Does as the frame from local-buddy says; always runs on the thread owning the descriptor in question
+ *
+ * @param [pintap] the INTAP header
+ * @param [buf] the payload
+ * @param [bytes] length of payload
+ */
+void Process_Frame(const INTAP_FMT_PTR pintap, const char *buf, const int bytes)
+{
+    int id = NTOHS(pintap->id);
+    switch (id)
+    {
+        case CMD_BYEBYE:    // closing are we
+        {
+            int lfd = Paired_Fd(pintap);
+            if (lfd < 0)
+                break;      // long gone
+
+            bsend_close = false;
+            Kill_Sock(lfd);
+        } break;
+
+        case CMD_DB_CONNECT:    // new db connection
+            New_Db(buf, pintap, bytes);
+            break;
+
+        case CMD_ECHO:  // routing as is
+        {
+            int lfd = Paired_Fd(pintap);
+            int rfd = (s16)NTOHS(pintap->src_fd);
+            if (lfd < 0)
+                break;      // long gone
+
+            STREAM_PTR pstream = Stream_Get(lfd);
+            Upstream_Send(pstream, lfd, buf, bytes);
+            if ((pstream->flags & SF_HOLD) && memmem(buf, bytes, "HTTP/1.1 100 Continue", 21))
+            {
+                // the client may now go on with its body
+                pstream->flags &= ~SF_HOLD;
+                Reactor_Mod(lfd, EV_READ | EV_RECV);
+            } // end if continue
+
+            if (pstream->rfd <= 0 && rfd > 0)
+                pstream->rfd = rfd;
+            Grant_Credit(pstream, lfd, bytes);
+        } break;
+
+        case CMD_WINDOW:    // local-buddy took in some of a stream; that much more may go
+        {
+            int lfd = Paired_Fd(pintap);
+            if (lfd < 0 || bytes != sizeof(u32))
+                break;      // long gone
+
+            STREAM_PTR pstream = Stream_Get(lfd);
+            if (Stream_Credit(pstream, NTOHL(*(const u32 *)buf)) && !(pstream->flags & (SF_PAUSED | SF_HOLD)))
+                Reactor_Mod(lfd, EV_READ | EV_RECV);
+        } break;
+    } // end switch
+} // end Process_Frame
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Relays the payload of a CMD_ECHO straight from the tunnel link into the stream with Intap_Splice(), never
+ *  bringing what's still in the kernel into user space. Only for streams of the tunnel thread itself that are
+ *  up and running; payloads big enough to be spliced are never the "100 Continue" Process_Frame looks out for.
+ *
+ * @param [pintap] the INTAP header
+ * @param [fd] the link the frame came on; most of the payload is still in it
+ * @param [rx] what's been read off the link
+ *
+ * @return int
+ *  1 if it's on its way, 0 if the payload is to be read the usual way or -1 if the link's gone
+ */
+int Splice_Frame(const INTAP_FMT_PTR pintap, const int fd, INTAP_RX &rx)
+{
+    int lfd = Paired_Fd(pintap);
+    STREAM_PTR pstream = Stream_Get(lfd);
+    if (!pstream || pstream->state != STREAM_OPEN || lfd != (s16)NTOHS(pintap->dest_fd))
+        return 0;
+
+    int status = Intap_Splice(fd, rx, lfd);
+    if (status <= 0)
+        return status;
+
+    if (debug_mode & DEBUG_L3)
+        Dump("splicing %u bytes from \033[33mlocal-buddy\033[37m on socket %d to socket %d", 
+            NTOHL(pintap->buf_len), fd, lfd);
+
+    int rfd = (s16)NTOHS(pintap->src_fd);
+    if (pstream->rfd <= 0 && rfd > 0)
+        pstream->rfd = rfd;
+
+    Grant_Credit(pstream, lfd, NTOHL(pintap->buf_len));
+    return 1;
+} // end Splice_Frame
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sends a frame down the tunnel; directly if the calling thread owns it, otherwise by way of its inbox
+ *
+ * @param [intap] the INTAP header
+ * @param [buf] the payload
+ * @param [bytes] length of payload
+ * @param [stream] the stream it's of; -1 for none
+ * @param [cls] the stream's traffic class (EGRESS_xxx)
+ */
+void To_Tunnel(const INTAP_FMT &intap, const char *buf, const int bytes, const int stream, const int cls)
+{
+    if (pshard->id == 0)
+    {
+        CPY_SND_BUFFER(Tunnel_Link(intap, stream), snd_buffer, intap, buf, bytes, 
+            intap_version.load(std::memory_order_relaxed), stream, cls);
+        return;
+    } // end if ours
+
+    SHARD_MSG msg;
+    msg.kind = MSG_TO_TUNNEL;
+    msg.link = Tunnel_Link(intap, stream);
+    msg.stream = stream;
+    msg.cls = cls;
+    msg.frame.reserve(sizeof(INTAP_FMT) + bytes);
+    msg.frame.append((const char *)&intap, sizeof(INTAP_FMT));
+    msg.frame.append(buf, bytes);
+    vshards[0]->inbox.Push(std::move(msg));
+} // end To_Tunnel
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Handles whatever the other threads have handed us
+ */
+void Drain_Inbox()
+{
+    SHARD_MSG msg;
+
+    pshard->inbox.Clear();
+    while (pshard->inbox.Pop(msg))
+    {
+        if (msg.kind == MSG_TO_TUNNEL)
+            CPY_SND_BUFFER(msg.link, snd_buffer, *(INTAP_FMT_PTR)msg.frame.data(), 
+                msg.frame.data() + sizeof(INTAP_FMT), msg.frame.size() - sizeof(INTAP_FMT), 
+                intap_version.load(std::memory_order_relaxed),
+                msg.stream, msg.cls);
+        else if (msg.kind == MSG_RESUME)
+            Resume_Streams();
+        else if (msg.kind == MSG_RESET)
+            Reset_Streams();
+        else
+            Process_Frame((INTAP_FMT_PTR)msg.frame.data(), msg.frame.data() + sizeof(INTAP_FMT),
+                (int)(msg.frame.size() - sizeof(INTAP_FMT)));
+    } // end while
+} // end Drain_Inbox
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Which tunnel link a stream's frames go down; always the same one for a descriptor, so that its frames (and 
+ *  a later stream reusing the descriptor) keep their order. Any thread may ask, the links never change (one 
+ *  that's reconnected keeps its descriptor).
+ *
+ * @param [fd] the stream's descriptor
+ *
+ * @return int
+ *  index of the link in vlinks
+ */
+int Link_Index(const int fd)
+{
+    return (u32)fd % vlinks.size();
+} // end Link_Index
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The tunnel link for a frame; picked by the stream it's about. That's never to be read off the header when
+ *  we've one: v2 leaves our descriptor out of it once local-buddy knows it, and going by local-buddy's instead
+ *  would have the rest of a stream's frames take another link than its first and overtake it. The header's
+ *  only for a frame with no stream of ours (such as failing to connect one).
+ *
+ * @param [intap] the INTAP header
+ * @param [stream] our stream it's of; -1 for none
+ *
+ * @return int
+ *  the link's descriptor
+ */
+int Tunnel_Link(const INTAP_FMT &intap, const int stream)
+{
+    if (stream >= 0)
+        return vlinks[Link_Index(stream)];
+
+    int fd = (s16)NTOHS(intap.src_fd);
+    if (fd < 0)
+        fd = (s16)NTOHS(intap.dest_fd);
+
+    return vlinks[Link_Index(fd < 0 ? 0 : fd)];
+} // end Tunnel_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the descriptor one of the tunnel links?
+ */
+bool Is_Link(const int fd)
+{
+    return std::find(vlinks.begin(), vlinks.end(), fd) != vlinks.end();
+} // end Is_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Backpressure; only the tunnel links are ever held up on (tunnel thread only). While one is backed up every
+ *  thread has the streams going down it stop reading as they turn ready, once it drains they're all told to go
+ *  on (those of links still backed up stop again). A client or RDBMS stream backing up holds nothing up, as the
+ *  only thing feeding it is a link which other streams share; it's left to queue up, and with flow control on
+ *  the credit it's owed is only granted back once it drains (on the thread owning it).
+ *
+ * @param [fd] the descriptor whose queue crossed a water mark
+ * @param [bcongested] over the high-water mark or back under the low one?
+ */
+void On_Congestion(const int fd, const bool bcongested)
+{
+    auto it = std::find(vlinks.begin(), vlinks.end(), fd);
+    if (it == vlinks.end())
+    {
+        STREAM_PTR pstream = Stream_Get(fd);
+        if (pstream && !bcongested)
+            Grant_Credit(pstream, fd, 0);
+        return;
+    } // end if a stream
+
+    Dump("\033[33mlocal-buddy\033[37m link on socket %d %s", fd, bcongested ? "backed up" : "drained");
+    blink_congested[it - vlinks.begin()].store(bcongested, std::memory_order_relaxed);
+    if (bcongested)
+        return;
+
+    for (auto ps : vshards)
+    {
+        if (ps == pshard)
+        {
+            Resume_Streams();
+            continue;
+        } // end if ours
+
+        SHARD_MSG msg;
+        msg.kind = MSG_RESUME;
+        ps->inbox.Push(std::move(msg));
+    } // end for
+} // end On_Congestion
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Has the streams of the calling thread held back for the tunnel go back to reading; those whose link is still
+ *  backed up or that wait on a "100 Continue" keep waiting.
+ */
+void Resume_Streams()
+{
+    std::vector<int> vheld;
+    for (int fd : vpaused)
+    {
+        if (fd_shard[fd].load(std::memory_order_relaxed) != pshard->id)
+            continue;       // another thread's since; its entry's none of ours to read
+
+        STREAM_PTR pstream = Stream_Get(fd);
+        if (!pstream || !(pstream->flags & SF_PAUSED))
+            continue;       // gone since
+
+        if (blink_congested[Link_Index(fd)].load(std::memory_order_relaxed))
+        {
+            vheld.push_back(fd);
+            continue;
+        } // end if still backed up
+
+        pstream->flags &= ~SF_PAUSED;
+        if (!(pstream->flags & (SF_HOLD | SF_STALLED)))
+            Reactor_Mod(fd, EV_READ | EV_RECV);
+    } // end for
+
+    vpaused.swap(vheld);
+} // end Resume_Streams
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A tunnel link lost its connection (tunnel thread only). One that can be resumed (INTAP_CAP_RESUME) is held,
+ *  backed up, while it's reconnected (see Resume_Links); for no longer than -resume seconds though. Anything 
+ *  else takes the session down with it.
+ *
+ * @param [fd] the link
+ */
+void Lose_Link(const int fd)
+{
+    if (!Intap_Park(fd))
+    {
+        Lose_Tunnel();
+        return;
+    } // end if can't be resumed
+
+    fprintf(stderr, "\033[31m> remote-buddy:\033[37m link on socket %d lost; resuming it\n", fd);
+    if (!resume_at)
+    {
+        resume_at = Now_Ms();
+        resume_wait = RESUME_WAIT_MIN;
+        resume_by = resume_at + (u64)resume_secs * 1000;
+    } // end if first one lost
+} // end Lose_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The tunnel's session is gone (tunnel thread only); there's no going on with the streams over it, every 
+ *  thread lets go of its own. The links are held till local-buddy takes a new session (see New_Session), new
+ *  clients are turned away meanwhile.
+ */
+void Lose_Tunnel()
+{
+    if (btunnel_lost.load(std::memory_order_relaxed))
+        return;
+
+    fprintf(stderr, "\033[31m> remote-buddy:\033[37m lost the tunnel; starting over with a new session\n");
+    Dial_Close();
+    for (int link : vlinks)
+        Intap_Park(link);
+    btunnel_lost.store(true, std::memory_order_relaxed);
+
+    for (auto ps : vshards)
+    {
+        if (ps == pshard)
+        {
+            Reset_Streams();
+            continue;
+        } // end if ours
+
+        SHARD_MSG msg;
+        msg.kind = MSG_RESET;
+        ps->inbox.Push(std::move(msg));
+    } // end for
+
+    resume_at = Now_Ms();
+    resume_wait = RESUME_WAIT_MIN;
+    resume_by = 0;
+} // end Lose_Tunnel
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Lets go of the streams of the calling thread; the tunnel they were over is gone (see Lose_Tunnel), there's 
+ *  no telling local-buddy.
+ */
+void Reset_Streams()
+{
+    for (int fd = 0, top = stream_top; fd < top; fd++)
+    {
+        // the owner first; the entries of other threads' streams are theirs alone to read
+        if (fd_shard[fd].load(std::memory_order_relaxed) != pshard->id || !Stream_Get(fd))
+            continue;
+
+        bsend_close = false;
+        Kill_Sock(fd);
+    } // end for
+
+    vpaused.clear();
+} // end Reset_Streams
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tries the lost tunnel links again once it's time to (tunnel thread only); each is reconnected and picks up
+ *  where it left off. Should local-buddy not know of the session anymore (it was restarted, say), or a link 
+ *  not come back in time, it's a new session. Every failed try waits longer for the next. The links are
+ *  reconnected one at a time, on the reactor along with everything else (see Dial_Link); this only starts 
+ *  them off and gives up on the one that takes too long.
+ */
+void Resume_Links()
+{
+    u64 now = Now_Ms();
+    if (dial.fd >= 0)
+    {
+        if (now >= dial.deadline)
+            Dial_Expired();
+        return;
+    } // end if one's on its way
+
+    if (!resume_at || now < resume_at)
+        return;
+
+    if (btunnel_lost.load(std::memory_order_relaxed))
+    {
+        size_t i = vsession.vfd.size();
+        if (!Dial_Link(i, i == 0 ? CMD_HELLO : CMD_JOIN))
+            Retry_Later();
+        return;
+    } // end if a new session
+    else if (now >= resume_by)
+    {
+        fprintf(stderr, "\033[31m> remote-buddy:\033[37m the lost links didn't come back in time\n");
+        Lose_Tunnel();
+        return;
+    } // end else if too late
+
+    for (size_t i = 0; i < vlinks.size(); i++)
+    {
+        if (!Intap_Parked(vlinks[i]))
+            continue;
+
+        if (!Dial_Link(i, CMD_RESUME))
+            Retry_Later();
+        return;
+    } // end for
+
+    resume_at = resume_by = 0;      // all back
+    resume_wait = RESUME_WAIT_MIN;
+} // end Resume_Links
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The lost links are tried again later; every time a bit later than the last, give or take (tunnel thread 
+ *  only)
+ */
+void Retry_Later()
+{
+    resume_at = Now_Ms() + resume_wait + rand() % (resume_wait / 2 + 1);
+    resume_wait = std::min(resume_wait * 2, RESUME_WAIT_MAX);
+} // end Retry_Later
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts reconnecting a tunnel link (tunnel thread only). It goes on from the reactor as the connection 
+ *  turns ready (see Dial_Event): connected, the TLS handshake if it's on, what it's to say and local-buddy's 
+ *  answer; every step no longer than -ct, TLS_HANDSHAKE_SECS or LINK_ANSWER_MS. Nothing blocks on it.
+ *
+ * @param [i] index of the link in vlinks
+ * @param [cmd] CMD_RESUME to pick up where it left off, CMD_HELLO or CMD_JOIN for a new session
+ *
+ * @return bool
+ *  false if it couldn't even be started
+ */
+bool Dial_Link(const size_t i, const u16 cmd)
+{
+    int fd = Socket();
+    int status = Connect_Async(fd, local_ip.c_str(), local_port);
+    if (status < 0)
+    {
+        CLOSE(fd);
+        return false;
+    } // end if no connecting
+
+    dial.fd = fd;
+    dial.link = i;
+    dial.cmd = cmd;
+    dial.got = 0;
+    Dump("reconnecting link %d on socket %d", (int)i + 1, fd);
+    if (status == 0)
+    {
+        Reactor_Add(fd, EV_READ);
+        Dial_Connected();
+        return true;
+    } // end if connected right away
+
+    dial.state = DIAL_CONNECTING;
+    dial.deadline = Now_Ms() + (u64)connect_timeout;
+    Reactor_Add(fd, EV_WRITE);
+    return true;
+} // end Dial_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The link being reconnected turned ready for the step it's on (tunnel thread only)
+ *
+ * @param [revents] what it turned ready for (EV_xxx)
+ */
+void Dial_Event(const u32 revents)
+{
+    switch (dial.state)
+    {
+        case DIAL_CONNECTING:
+            if (Connect_Finish(dial.fd) < 0)
+            {
+                Dump("no reconnecting link %d yet: %s", (int)dial.link + 1, strerror(errno));
+                Dial_Failed();
+                return;
+            } // end if not there
+
+            Dial_Connected();
+            break;
+
+        case DIAL_TLS:
+            Dial_Tls();
+            break;
+
+        case DIAL_ANSWER:
+            if (!(revents & EV_READ))
+            {
+                Dial_Failed();
+                return;
+            } // end if gone
+
+            Dial_Read();
+            break;
+    } // end switch
+} // end Dial_Event
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The link being reconnected is connected; over TLS it's encrypted before anything goes down it
+ */
+void Dial_Connected()
+{
+    Tcp_Keep_Alive(dial.fd, LINK_IDLE_SECS);
+    if (!Tls_Active())
+    {
+        Dial_Request();
+        return;
+    } // end if in the clear
+
+    dial.state = DIAL_TLS;
+    dial.deadline = Now_Ms() + TLS_HANDSHAKE_SECS * 1000;
+    Dial_Tls();
+} // end Dial_Connected
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes the TLS handshake on the link being reconnected a step further
+ */
+void Dial_Tls()
+{
+    u32 events{0};
+    int status = Tls_Connect_Step(dial.fd, dial.pssl, events);
+    if (status < 0)
+        Dial_Failed();
+    else if (status == 0)
+        Reactor_Mod(dial.fd, events);
+    else
+        Dial_Request();
+} // end Dial_Tls
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Says what the link being reconnected is for and waits for local-buddy's answer. It's a few dozen bytes on a
+ *  connection nothing's gone down yet; it all goes in one send or it doesn't go.
+ */
+void Dial_Request()
+{
+    std::string request = dial.cmd == CMD_RESUME ? Resume_Request(dial.link) : 
+        Hello_Request(dial.link, vsession.lead_fd, dial.link == 0 ? session : 0, dial.fd);
+    if (send(dial.fd, request.data(), request.size(), MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t)request.size())
+    {
+        Dial_Failed();
+        return;
+    } // end if not sent
+
+    dial.state = DIAL_ANSWER;
+    dial.deadline = Now_Ms() + LINK_ANSWER_MS;
+    Reactor_Mod(dial.fd, EV_READ);
+} // end Dial_Request
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads what's come of local-buddy's answer on the link being reconnected; its header, then the session or
+ *  sequence number it carries. Never a byte past it; what follows is the link's and is left for Intap_Fill.
+ */
+void Dial_Read()
+{
+    size_t want = sizeof(INTAP_FMT);
+    if (dial.got >= sizeof(INTAP_FMT) && NTOHL(INTAP_FMT_PTR(dial.answer)->buf_len) == sizeof(u64))
+        want += sizeof(u64);
+
+    ssize_t bytes = recv(dial.fd, dial.answer + dial.got, want - dial.got, MSG_DONTWAIT);
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+    else if (bytes <= 0)
+    {
+        Dial_Failed();
+        return;
+    } // end if gone
+
+    dial.got += bytes;
+    if (dial.got < want)
+        return;
+    else if (strncmp(INTAP_FMT_PTR(dial.answer)->signature, "INTAP11", 8))
+    {
+        Dial_Failed();
+        return;
+    } // end if not INTAP
+
+    if (want == sizeof(INTAP_FMT) && NTOHL(INTAP_FMT_PTR(dial.answer)->buf_len) == sizeof(u64))
+        Dial_Read();    // the rest may well be in already
+    else
+        Dial_Answered(true);
+} // end Dial_Read
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The link being reconnected ran out of time on the step it's on. Only a local-buddy of old (v1) never
+ *  answers a hello; that's as good as an answer from the one that never did.
+ */
+void Dial_Expired()
+{
+    if (dial.state == DIAL_ANSWER && dial.cmd == CMD_HELLO && vlink_peer[0] < 0)
+    {
+        Dial_Answered(false);
+        return;
+    } // end if never answers
+
+    Dump("reconnecting link %d timed out", (int)dial.link + 1);
+    Dial_Failed();
+} // end Dial_Expired
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  local-buddy answered the link being reconnected. A resumed link goes on right away with whatever it has to 
+ *  send again; one for a new session waits for the rest of them (see Take_Session).
+ *
+ * @param [banswered] whether it did; only ever not for the hello of a local-buddy of old
+ */
+void Dial_Answered(const bool banswered)
+{
+    INTAP_FMT_PTR panswer = banswered ? INTAP_FMT_PTR(dial.answer) : nullptr;
+    u64 val{0};
+    if (panswer && NTOHL(panswer->buf_len) == sizeof(val))
+    {
+        memcpy(&val, dial.answer + sizeof(INTAP_FMT), sizeof(val));
+        val = NTOHLL(val);
+    } // end if it carries one
+
+    const size_t i = dial.link;
+    if (dial.cmd == CMD_RESUME)
+    {
+        // the answer's how much local-buddy got; whatever it didn't goes again right behind it
+        if (NTOHS(panswer->id) == CMD_BYEBYE)
+        {
+            Dial_Close();
+            Lose_Tunnel();      // it doesn't know of the session
+        } // end if no session
+        else if (NTOHS(panswer->id) != CMD_RESUME || NTOHL(panswer->buf_len) != sizeof(val))
+            Dial_Failed();
+        else if (!Intap_Resume(vlinks[i], dial.fd, val, &vlink_rx[i]))
+        {
+            fprintf(stderr, "\033[31m> remote-buddy:\033[37m link on socket %d can't be resumed from where "
+                "local-buddy says\n", vlinks[i]);
+            Dial_Close();
+            Lose_Tunnel();
+        } // end else if can't
+        else
+        {
+            Dump("link on socket %d resumed", vlinks[i]);
+            dial.fd = -1;       // it's the link's now
+            resume_at = Now_Ms();
+            resume_wait = RESUME_WAIT_MIN;
+        } // end else resumed
+        return;
+    } // end if resuming
+
+    if (panswer && NTOHS(panswer->id) != dial.cmd)
+    {
+        Dial_Failed();
+        return;
+    } // end if not an answer
+
+    // the first link's answer has the terms, the others' are to be the same (it's the one local-buddy)
+    int version{INTAP_V1};
+    u16 caps{0};
+    size_t frame{0};
+    Hello_Terms(panswer, version, caps, frame);
+    if (i == 0)
+    {
+        vsession.version = version;
+        vsession.caps = caps;
+        vsession.frame = frame;
+        vsession.lead_fd = panswer ? (s16)NTOHS(panswer->src_fd) : -1;
+        session = val;          // the old one's let go of already; it's this one that's to be if it all fails
+    } // end if first
+    else if (version != vsession.version || caps != vsession.caps || frame != vsession.frame)
+    {
+        Dial_Failed();
+        return;
+    } // end else if not the same
+
+    Reactor_Del(dial.fd);
+    vsession.vfd.push_back(dial.fd);
+    vsession.vpeer.push_back(panswer ? (s16)NTOHS(panswer->src_fd) : -1);
+    dial.fd = -1;
+    if (vsession.vfd.size() < vlinks.size())
+        resume_at = Now_Ms();   // the next one right away
+    else
+        Take_Session();
+} // end Dial_Answered
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gives up on the link being reconnected; it's tried again later, a new session from the start
+ */
+void Dial_Failed()
+{
+    Dial_Close();
+    if (btunnel_lost.load(std::memory_order_relaxed))
+        Drop_Session();
+    Retry_Later();
+} // end Dial_Failed
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Closes the connection of the link being reconnected; nothing else
+ */
+void Dial_Close()
+{
+    if (dial.fd < 0)
+        return;
+
+    if (dial.pssl)
+        Tls_Abort(dial.pssl);
+    Erase_Sock(dial.fd);
+    CLOSE(dial.fd);
+    dial.fd = -1;
+} // end Dial_Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Has the links of a new session closed; those local-buddy already took are let go of on its side with them
+ */
+void Drop_Session()
+{
+    for (int fd : vsession.vfd)
+        CLOSE(fd);
+
+    vsession = SESSION_DIAL();
+} // end Drop_Session
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Every link has been taken by local-buddy under a new session; the links go on over the new connections, 
+ *  from scratch. It's the terms it answered with from here on; those of a local-buddy restarted with other
+ *  settings may well not be the ones before. No stream is left by now to have assumed the old ones (see 
+ *  Lose_Tunnel), new clients have been turned away.
+ */
+void Take_Session()
+{
+    if (vsession.version != intap_version.load(std::memory_order_relaxed) || 
+        vsession.caps != intap_caps.load(std::memory_order_relaxed) || 
+        vsession.frame != tunnel_frame_max.load(std::memory_order_relaxed))
+    {
+        fprintf(stderr, "\033[31m> remote-buddy:\033[37m local-buddy came back with other terms; INTAP v%d%s%s%s "
+            "from now on\n", vsession.version, (vsession.caps & INTAP_CAP_LZ) ? ", compressed" : "", 
+            (vsession.caps & INTAP_CAP_WINDOW) ? ", flow controlled" : "", 
+            (vsession.caps & INTAP_CAP_RESUME) ? ", resumable" : "");
+        intap_version.store(vsession.version, std::memory_order_relaxed);
+        intap_caps.store(vsession.caps, std::memory_order_relaxed);
+        tunnel_frame_max.store(vsession.frame, std::memory_order_relaxed);
+    } // end if not the same
+
+    for (size_t i = 0; i < vlinks.size(); i++)
+    {
+        vlink_rx[i] = INTAP_RX();
+        vlink_peer[i] = vsession.vpeer[i];
+        Intap_Compress(vlinks[i], (vsession.caps & INTAP_CAP_LZ) ? lz_min : 0);
+        Intap_Replay(vlinks[i], (vsession.caps & INTAP_CAP_RESUME) ? (size_t)replay_max << 20 : 0);
+        if (!Intap_Resume(vlinks[i], vsession.vfd[i], 0, &vlink_rx[i]))
+        {
+            // the ones taken back already go back to waiting along with the rest
+            fprintf(stderr, "\033[31m> remote-buddy:\033[37m can't take link %d back\n", (int)i + 1);
+            for (size_t j = 0; j < i; j++)
+                Intap_Park(vlinks[j]);
+            vsession.vfd.erase(vsession.vfd.begin(), vsession.vfd.begin() + i);
+            Drop_Session();
+            Retry_Later();
+            return;
+        } // end if can't
+    } // end for
+
+    vsession = SESSION_DIAL();
+    btunnel_lost.store(false, std::memory_order_relaxed);
+    resume_at = resume_by = 0;
+    resume_wait = RESUME_WAIT_MIN;
+    Dump("back with \033[33mlocal-buddy\033[37m under a new session");
+} // end Take_Session
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  How long the reactor may wait, with the lost links to try again in mind (tunnel thread only)
+ *
+ * @param [timeout] what it'd wait otherwise in milli-seconds; -1 for forever
+ */
+int Resume_Wait_Ms(int timeout)
+{
+    u64 at = dial.fd >= 0 ? dial.deadline : resume_at;
+    if (pshard->id != 0 || !at)
+        return timeout;
+
+    u64 now = Now_Ms();
+    int left = at > now ? (int)std::min<u64>(at - now, INT32_MAX) : 0;
+    return (timeout < 0 || left < timeout) ? left : timeout;
+} // end Resume_Wait_Ms
 
-    Close_Sockets();
-    return 0;     
-} // end main
 
 //==============================================================================================================|
 /**
@@ -349,85 +1494,507 @@ void Init(int argc, char **argv)
     Split_String(config.dat["Local_Buddy"], ':', dest);
     local_ip = dest[0];
     local_port = atoi(dest[1].c_str());
+
+    // how long an RDBMS connect may take (milli-seconds)
+    if (config.dat.count("Connect_Timeout"))
+        connect_timeout = atoi(config.dat["Connect_Timeout"].c_str());
+
+    // warm RDBMS sockets kept (0 for none) and how long one may sit unused (milli-seconds)
+    if (config.dat.count("Upstream_Pool"))
+        pool_size = atoi(config.dat["Upstream_Pool"].c_str());
+
+    if (config.dat.count("Upstream_Pool_Idle"))
+        pool_idle_ms = atoi(config.dat["Upstream_Pool_Idle"].c_str());
+
+    // relay buffers out of huge pages ("1" for yes)
+    if (config.dat.count("Huge_Pages"))
+        buf_huge = atoi(config.dat["Huge_Pages"].c_str()) != 0;
+
+    // the longest a stream is read for at once; the buffers had along the command line are made over for it
+    if (config.dat.count("Frame_Max"))
+    {
+        frame_max = atoi(config.dat["Frame_Max"].c_str());
+        free(buffer);
+        free(snd_buffer);
+        Alloc_Buffers();
+    } // end if frame size
+
+    // shares of a backed up tunnel link; database streams against RESTServer ones
+    if (config.dat.count("Weight_Db"))
+        weight_db = atoi(config.dat["Weight_Db"].c_str());
+
+    if (config.dat.count("Weight_Rest"))
+        weight_rest = atoi(config.dat["Weight_Rest"].c_str());
+
+    // the metrics endpoint on the loopback (see Metrics_Listen); 0 for none
+    if (config.dat.count("Metrics_Port"))
+        metrics_port = atoi(config.dat["Metrics_Port"].c_str());
+
+    // where the log goes (appended to); stdout if it's not given
+    if (config.dat.count("Log_File"))
+        log_file = config.dat["Log_File"];
+
+    // the tunnel goes over TLS given a certificate; the key to it and the CA local-buddy's must be signed by
+    if (config.dat.count("TLS_Cert"))
+        tls_cert = config.dat["TLS_Cert"];
+
+    if (config.dat.count("TLS_Key"))
+        tls_key = config.dat["TLS_Key"];
+
+    if (config.dat.count("TLS_CA"))
+        tls_ca = config.dat["TLS_CA"];
+
+    // tunnel links to local-buddy; streams are spread over them
+    if (config.dat.count("Tunnel_Links"))
+        tunnel_links = std::min(std::max(atoi(config.dat["Tunnel_Links"].c_str()), 1), MAX_TUNNEL_LINKS);
+
+    // how long a lost tunnel link may take to come back (seconds; 0 never resumes one) and the MiB sent down a
+    //  link that may go unacknowledged for it to still be resumed
+    if (config.dat.count("Resume_Timeout"))
+        resume_secs = atoi(config.dat["Resume_Timeout"].c_str());
+
+    if (config.dat.count("Replay_Buffer"))
+        replay_max = atoi(config.dat["Replay_Buffer"].c_str());
+
+    // reactor threads; 0 has us take one for each core there is
+    if (config.dat.count("Reactor_Threads"))
+    {
+        reactor_threads = atoi(config.dat["Reactor_Threads"].c_str());
+        if (reactor_threads <= 0)
+            reactor_threads = (int)std::thread::hardware_concurrency();
+
+        reactor_threads = std::min(std::max(reactor_threads, 1), MAX_REACTOR_THREADS);
+    } // end if threads
+
+    Log_Init("\033[32m> remote-buddy:\033[37m", log_file.c_str());
+
+    if (!tls_cert.empty() && !Tls_Init(false, tls_cert, tls_key, tls_ca))
+        exit(EXIT_FAILURE);
 } // end Init
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Dumps the message to console (stdout) if we are allowed to do so; i.e. degbug_mode is set to DEBUG_L1 or 
- *  above.
+ *  starts connection and sends an intial 'hello' message to local-buddy to let it know what's up. It answers
+ *  with the INTAP version we're to speak and its end of the first link, which any other links join (CMD_JOIN)
+ *  with; a local-buddy that predates all this never answers and we go on with the one link in v1.
+ */
+inline void Hello_Buddy()
+{
+    int lead_fd{-1};        // local-buddy's end of the first link
+    int version{INTAP_V1};
+    u16 caps{0};
+    size_t frame = buffer_size;
+    for (int i = 0; i < tunnel_links; i++)
+    {
+        INTAP_FMT intap;
+        u64 sess{0};
+        bool banswered{false};
+        int fd = Hello_Link(i, lead_fd, intap, sess, banswered);
+        if (fd < 0)
+        {
+            if (i == 0)
+            {
+                fprintf(stderr, "\033[31m> remote-buddy:\033[37m no link with local-buddy, giving up\n");
+                exit(EXIT_FAILURE);
+            } // end if first link
+
+            fprintf(stderr, "\033[31m> remote-buddy:\033[37m no link %d, going on with %d\n", i + 1, i);
+            break;
+        } // end if no link
+
+        vlinks.push_back(fd);
+        vlink_peer.push_back(banswered ? (s16)NTOHS(intap.src_fd) : -1);
+        if (!banswered)
+        {
+            if (i > 0)
+            {
+                fprintf(stderr, "\033[31m> remote-buddy:\033[37m local-buddy won't take link %d, going on with %d\n",
+                    i + 1, i);
+                vlinks.pop_back();
+                vlink_peer.pop_back();
+                CLOSE(fd);
+            } // end if extra link
+            else
+                fprintf(stderr, "\033[31m> remote-buddy:\033[37m no answer from local-buddy, going on in v1\n");
+
+            break;
+        } // end if no answer
+
+        if (i == 0)
+        {
+            lead_fd = (s16)NTOHS(intap.src_fd);
+            session = sess;
+            Hello_Terms(&intap, version, caps, frame);
+        } // end if first
+    } // end for
+
+    intap_version.store(version, std::memory_order_relaxed);
+    intap_caps.store(caps, std::memory_order_relaxed);
+    tunnel_frame_max.store(frame, std::memory_order_relaxed);
+    Dump("speaking INTAP v%d with \033[33mlocal-buddy\033[37m%s%s%s", version, 
+        (caps & INTAP_CAP_LZ) ? ", compressed" : "", (caps & INTAP_CAP_WINDOW) ? ", flow controlled" : "",
+        (caps & INTAP_CAP_RESUME) ? ", resumable" : "");
+
+    // the frames of all the streams going down a link in a loop iteration go in one send; in turns once it
+    //  backs up. What's sent is counted (and kept, if the links may be resumed) from here on.
+    for (int link : vlinks)
+    {
+        Send_Coalesce(link);
+        Intap_Schedule(link, weight_db, weight_rest);
+        if (caps & INTAP_CAP_LZ)
+            Intap_Compress(link, lz_min);
+        Intap_Replay(link, (caps & INTAP_CAP_RESUME) ? (size_t)replay_max << 20 : 0);
+    } // end for
+
+    vlink_rx.resize(vlinks.size());
+} // end Process_First_Time_Request
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Connects a tunnel link and says hello on it as we start up; CMD_HELLO on the first, CMD_JOIN on the others.
+ *  local-buddy answers with the terms (see Hello_Terms), its end of the link and, for the first, the session 
+ *  the links are resumed under (INTAP_CAP_RESUME). Blocks for no longer than -ct and the handshakes allow;
+ *  there's nothing else going on yet. Links reconnected later on go by the reactor (see Dial_Link).
  * 
- * @param [msg] the message to dump 
+ * @param [i] which link it is 
+ * @param [lead_fd] local-buddy's end of the first one; -1 for the first itself 
+ * @param [answer] the answer 
+ * @param [sess] and the session in it; 0 for none 
+ * @param [banswered] whether there was one 
+ * 
+ * @return int
+ *  the link; -1 if it can't be had
  */
-inline void Dump(const char* msg, ...)
+int Hello_Link(const int i, const int lead_fd, INTAP_FMT &answer, u64 &sess, bool &banswered)
 {
-    char buf[BUF_SIZE];
-    va_list arg_list;
+    int fd = Socket();
+    if (Connect_Timeout(fd, local_ip.c_str(), local_port, connect_timeout) < 0)
+    {
+        perror("connect");
+        CLOSE(fd);
+        return -1;
+    } // end if not there
 
-    if (debug_mode & DEBUG_L1)
+    // over TLS the link's encrypted by the kernel before anything goes down it; never in the clear
+    if (Tls_Active() && !Tls_Connect(fd))
     {
-        va_start(arg_list, msg);
-        vsnprintf(buf, BUF_SIZE, msg, arg_list);
-        printf("\033[32m> remote-buddy:\033[37m %s.\n", buf);
-        va_end(arg_list);
-    } // end if
-} // end Dump
+        CLOSE(fd);
+        return -1;
+    } // end if no TLS
+
+    Tcp_NoDelay(fd);
+    Tcp_Keep_Alive(fd, LINK_IDLE_SECS);
+
+    // hear back before anything else goes down the link
+    std::string hello = Hello_Request(i, lead_fd, 0, fd);
+    u16 id = (i == 0 ? CMD_HELLO : CMD_JOIN);
+    sess = 0;
+    Set_RecvTimeout(fd, LINK_ANSWER_MS / 1000);
+    banswered = Send_Block(fd, hello.data(), hello.size()) && 
+        Recv(fd, (char*)&answer, sizeof(answer)) == sizeof(answer) && 
+        !strncmp(answer.signature, "INTAP11", 8) && NTOHS(answer.id) == id;
+    if (banswered && NTOHL(answer.buf_len) == sizeof(sess))
+    {
+        banswered = Recv(fd, (char*)&sess, sizeof(sess)) == sizeof(sess);
+        sess = NTOHLL(sess);
+    } // end if a session
+    Set_RecvTimeout(fd, 0);
+    return fd;
+} // end Hello_Link
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  starts connection and sends an intial 'hello' message to local-buddy to let it know what's up
+ *  The hello a tunnel link starts with; CMD_HELLO on the first, CMD_JOIN on the others. It has the terms we'd
+ *  like and, on the first of a new session, the session given up on for local-buddy to let go of.
+ * 
+ * @param [i] which link it is 
+ * @param [lead_fd] local-buddy's end of the first one; -1 for the first itself 
+ * @param [stale] a session given up on; 0 for none 
+ * @param [fd] our end of the link 
+ * 
+ * @return std::string
+ *  the header and whatever goes along
  */
-inline void Hello_Buddy()
+std::string Hello_Request(const size_t i, const int lead_fd, const u64 stale, const int fd)
 {
     INTAP_FMT intap;
-   
-    local_fd = Socket();
-    Connect(local_fd, local_ip.c_str(), local_port);
-    Tcp_NoDelay(local_fd);
-
-    intap.id = HTONS(CMD_HELLO);
-    intap.port = HTONS(0);
-    intap.src_fd = HTONS(local_fd);
-    intap.dest_fd = HTONS(-1);
-    intap.buf_len = 0;
+    u64 old = HTONLL(stale);
+    intap.id = HTONS(i == 0 ? CMD_HELLO : CMD_JOIN);
+    intap.port = HTONS(INTAP_VERSION | (lz_min > 0 ? INTAP_CAP_LZ : 0) | INTAP_CAP_WINDOW | 
+        Intap_Frame_Cap(frame_max) | (resume_secs > 0 ? INTAP_CAP_RESUME : 0));
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = HTONS(lead_fd);
+    intap.buf_len = HTONL(stale ? sizeof(old) : 0);
     strncpy(intap.ip, "0.0.0.0", 8);
 
-    Send(local_fd, (char*)&intap, sizeof(intap));
-} // end Process_First_Time_Request
+    std::string hello((const char *)&intap, sizeof(intap));
+    if (stale)
+        hello.append((const char *)&old, sizeof(old));
+    return hello;
+} // end Hello_Request
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  What a lost link says once it's reconnected (CMD_RESUME); the session, the link it's to take the place of 
+ *  and how much we got off it. local-buddy answers with how much it got, or CMD_BYEBYE if it's no session of
+ *  its.
+ * 
+ * @param [i] index of the link in vlinks 
+ * 
+ * @return std::string
+ *  the header and the two numbers
+ */
+std::string Resume_Request(const size_t i)
+{
+    INTAP_FMT intap;
+    u64 vals[2] = {HTONLL(session), HTONLL(vlink_rx[i].rcvd)};
+    intap.id = HTONS(CMD_RESUME);
+    intap.src_fd = HTONS(vlinks[i]);
+    intap.dest_fd = HTONS(vlink_peer[i]);
+    intap.port = HTONS(intap_version.load(std::memory_order_relaxed) | intap_caps.load(std::memory_order_relaxed));
+    intap.buf_len = HTONL(sizeof(vals));
+    strncpy(intap.ip, "0.0.0.0", 8);
+
+    std::string resume((const char *)&intap, sizeof(intap));
+    resume.append((const char *)vals, sizeof(vals));
+    return resume;
+} // end Resume_Request
 
 
 //==============================================================================================================|
 /**
  * @brief 
- *  Connects to a RDBMS server instance and sends whatever it got from local-buddy
+ *  The terms local-buddy answered the hello with; the INTAP version, the capabilities and the longest payload
+ *  a frame may carry. Those of the local-buddy that never answers (v1 and nothing else) for none.
+ * 
+ * @param [panswer] its answer; nullptr for none 
+ * @param [version] the version 
+ * @param [caps] the capabilities (INTAP_CAP_xxx) 
+ * @param [frame] the longest payload 
+ */
+void Hello_Terms(const INTAP_FMT *panswer, int &version, u16 &caps, size_t &frame)
+{
+    version = INTAP_V1;
+    caps = 0;
+    frame = buffer_size;
+    if (!panswer)
+        return;
+
+    u16 port = NTOHS(panswer->port);
+    version = std::min(std::max((int)(port & INTAP_VERSION_MASK), INTAP_V1), INTAP_VERSION);
+    if (version < INTAP_V2)
+        return;
+
+    caps = port & ((lz_min > 0 ? INTAP_CAP_LZ : 0) | INTAP_CAP_WINDOW | (resume_secs > 0 ? INTAP_CAP_RESUME : 0));
+    frame = Intap_Frame_Max(port, frame_max, buffer_size);
+} // end Hello_Terms
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Connects to a RDBMS server instance (or takes a warm socket to it from the pool) and sends whatever it got
+ *  from local-buddy
  * 
- * @param [fd] local-buddy descriptor 
  * @param [pbuf] buffer containing data 
  * @param [pintap] pointer to intap structure
  * @param [len] length of buffer 
  */
-void New_Db(const int fd, const char *pbuf, const INTAP_FMT_PTR pintap, const size_t len)
+void New_Db(const char *pbuf, const INTAP_FMT_PTR pintap, const size_t len)
 {
-    Dump("connecting to RDBMS ..");
-    int dbfd = Socket();
-    Connect(dbfd, db_ip.c_str(), db_port);
-    Dump("Connected with RDBMS");
-
-    Send(dbfd, pbuf, len);
-    
-    memset(&fdpoll, 0, sizeof(fdpoll));
-    fdpoll.fd = dbfd;
-    fdpoll.events = POLLIN;
-    vpoll.push_back(fdpoll);
+    int status{0};
+    int dbfd = Pool_Claim(pdb_pool);
+    if (dbfd < 0)
+    {
+        Dump("connecting to RDBMS ..");
+        dbfd = Socket();
+        status = Connect_Async(dbfd, db_ip.c_str(), db_port);
+    } // end if none warm
+
+    // local-buddy hears of our end with the first response; its frames come to us by its descriptor till then
+    //  (it's ours before its entry is written; other threads go by that not to read it)
+    int rfd = (s16)NTOHS(pintap->src_fd);
+    if (dbfd >= 0)
+        fd_shard[(u16)dbfd].store(pshard->id, std::memory_order_relaxed);
+    if (status < 0 || !Stream_Open(dbfd, nullptr, rfd, status == 0 ? STREAM_OPEN : STREAM_CONNECTING, 
+        SF_UNNAMED | SF_DB))
+    {
+        // let the client on the other side know it's not happening
+        CLOSE(dbfd);
+        INTAP_FMT intap;
+        intap.id = HTONS(CMD_BYEBYE);
+        intap.src_fd = HTONS(-1);
+        intap.dest_fd = pintap->src_fd;
+        intap.buf_len = 0;
+        To_Tunnel(intap, "", 0);
+        return;
+    } // end if failed
+
+    mrfd[rfd] = dbfd;
+    if (status == 0)
+    {
+        Dump("Connected with RDBMS");
+        Send(dbfd, pbuf, len);
+        Reactor_Add(dbfd, EV_READ | EV_RECV);
+    } // end if connected
+    else
+    {
+        // the request waits along with the connect; so does anything else that comes for it
+        Reactor_Add(dbfd, EV_WRITE);
+        mconnecting[dbfd] = {Now_Ms() + (u64)connect_timeout, std::string(pbuf, len)};
+    } // end else in progress
 
-    MI_SOCK_WAIT sw{NTOHS(pintap->src_fd), true};
-    mfds[dbfd] = sw;
+    Grant_Credit(&stream_table[dbfd], dbfd, len);
 } // end New_Db
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Finds our end of a stream a local-buddy frame is meant for. local-buddy doesn't know our descriptor for a
+ *  db stream till we've responded at least once (it sends -1 till then), so those are looked up by its own.
+ *  A frame naming both ends has to name the stream's own local-buddy end too; one meant for an earlier stream
+ *  on the descriptor is no good to the one there now. Only the calling thread's streams are ever looked at.
+ * 
+ * @param [pintap] the frame 
+ * 
+ * @return int
+ *  the descriptor or -1 if there's no such stream
+ */
+int Paired_Fd(const INTAP_FMT_PTR pintap)
+{
+    int rfd = (s16)NTOHS(pintap->src_fd);
+    int lfd = (s16)NTOHS(pintap->dest_fd);
+    if (lfd <= 0)
+    {
+        auto it = mrfd.find(rfd);
+        lfd = it == mrfd.end() ? -1 : it->second;
+    } // end if not named
+
+    if (lfd <= 0 || lfd >= STREAM_MAX_FDS || fd_shard[lfd].load(std::memory_order_relaxed) != pshard->id)
+        return -1;
+
+    STREAM_PTR pstream = Stream_Get(lfd);
+    if (!pstream || (rfd > 0 && pstream->rfd > 0 && pstream->rfd != rfd))
+        return -1;
+
+    return lfd;
+} // end Paired_Fd
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends to a client or RDBMS stream; held on to if the stream is still connecting
+ * 
+ * @param [pstream] the stream 
+ * @param [fd] its descriptor 
+ * @param [buf] the data 
+ * @param [len] length of data 
+ */
+void Upstream_Send(STREAM_PTR pstream, const int fd, const char *buf, const size_t len)
+{
+    if (pstream->state == STREAM_CONNECTING)
+        mconnecting[fd].pending.append(buf, len);
+    else
+        Send(fd, buf, len);
+} // end Upstream_Send
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Flow control; a stream passed on what it took off the tunnel to its descriptor. The credit for it goes back 
+ *  to local-buddy in a CMD_WINDOW once there's enough of it and the descriptor is keeping up; one that's backed
+ *  up gets it granted as it drains (see On_Congestion).
+ * 
+ * @param [pstream] the stream 
+ * @param [fd] its descriptor 
+ * @param [bytes] how many more were passed on 
+ */
+void Grant_Credit(STREAM_PTR pstream, const int fd, const size_t bytes)
+{
+    if (!(intap_caps.load(std::memory_order_relaxed) & INTAP_CAP_WINDOW))
+        return;
+
+    u32 grant = Stream_Grant(pstream, bytes, pstream->state == STREAM_OPEN && pstream->rfd > 0 && 
+        !Send_Congested(fd));
+    if (!grant)
+        return;
+
+    INTAP_FMT intap;
+    intap.id = HTONS(CMD_WINDOW);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = HTONS(pstream->rfd);
+    intap.buf_len = HTONL(sizeof(grant));
+    grant = HTONL(grant);
+    To_Tunnel(intap, (const char *)&grant, sizeof(grant));
+} // end Grant_Credit
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A pending connect turned writable (or failed); on success whatever was held on to goes out and the stream
+ *  goes on like any other, on failure the stream is killed and local-buddy told so.
+ * 
+ * @param [fd] the descriptor 
+ */
+void Finish_Connect(const int fd)
+{
+    auto it = mconnecting.find(fd);
+    if (Connect_Finish(fd) < 0)
+    {
+        perror("connect");
+        Kill_Sock(fd);
+        return;
+    } // end if failed
+
+    Dump("Connected with RDBMS on socket %d", fd);
+    std::string pending = std::move(it->second.pending);
+    mconnecting.erase(it);
+    stream_table[fd].state = STREAM_OPEN;
+
+    Reactor_Mod(fd, EV_READ | EV_RECV);
+    Send(fd, pending.data(), pending.size());
+    Grant_Credit(&stream_table[fd], fd, 0);
+} // end Finish_Connect
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Gives up on the connects that took too long
+ */
+void Expire_Connects()
+{
+    if (mconnecting.empty())
+        return;
+
+    std::vector<int> vexpired;
+    u64 now = Now_Ms();
+    for (auto &x : mconnecting)
+    {
+        if (x.second.deadline <= now)
+            vexpired.push_back(x.first);
+    } // end for
+
+    for (int fd : vexpired)
+    {
+        fprintf(stderr, "\033[31m> remote-buddy:\033[37m connect timed out on socket %d\n", fd);
+        Kill_Sock(fd);
+    } // end for
+} // end Expire_Connects
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -435,10 +2002,13 @@ void New_Db(const int fd, const char *pbuf, const INTAP_FMT_PTR pintap, const si
  */
 void Close_Sockets()
 {
-    for (auto &x : mfds)
-        Kill_Sock(x.first);
+    for (int fd = 0, top = stream_top; fd < top; fd++)
+    {
+        if (fd_shard[fd].load(std::memory_order_relaxed) == pshard->id && Stream_Get(fd))
+            Kill_Sock(fd);
+    } // end for
 
-    mfds.clear();
+    Pool_Close();
     CLOSE(listen_fd);
 } // end Close_Sockets
 
@@ -460,25 +2030,37 @@ void Kill_Sock(const int fd)
 
 
     Dump("killin' em softly, socket %d", fd);
-    auto it = mfds.find(fd);
-    if (it != mfds.end())
+    mconnecting.erase(fd);
+    STREAM_PTR pstream = Stream_Get(fd);
+    if (pstream)
     {
         if (bsend_close)
         {
-            intap.dest_fd = HTONS(it->second.fd);
-            Send(local_fd, (const char *)&intap, sizeof(intap));
+            intap.dest_fd = HTONS(pstream->rfd);
+            To_Tunnel(intap, "", 0, fd, Stream_Class(pstream));
         } // end if sending kill
 
-        CLOSE(it->first);
-        mfds.erase(it);
+        // everything kept on it goes first; once it's closed the number is anyone's, another thread's accept 
+        //  included
+        auto it = mrfd.find(pstream->rfd);
+        if (it != mrfd.end() && it->second == fd)
+            mrfd.erase(it);
+
+        Stream_Close(fd);
         Erase_Sock(fd);
+        CLOSE(fd);
     } // end if
-
-    if (fd == local_fd)
+    else if (Is_Link(fd))
     {
-        CLOSE(local_fd);
-        Erase_Sock(fd);
+        // the streams are spread all over the links; there's no going on with only some of them
+        Lose_Tunnel();
     } // end if
+    else if (bsend_close && fd != listen_fd)
+    {
+        // a client that left before saying anything
+        Erase_Sock(fd);
+        CLOSE(fd);
+    } // end else
 
     bsend_close = true;     // back to normal
 } // end Kill_Sock
@@ -0,0 +1,131 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Routing new database connections to remote-buddies; see route-index.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "route-index.h"
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static std::unordered_map<u32, std::vector<CONNECTION_INFO_PTR>> mbound;   // by address; the first one gets
+                                                                            //  them, the rest are in waiting
+static std::vector<CONNECTION_INFO_PTR> vunbound;   // yet to be bound; each knows where it is (route_slot)
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts a remote-buddy in the index by the address it came with (CONNECTION_INFO::ip); 0.0.0.0, or anything
+ *  that's not an address, has it wait to be bound
+ *
+ * @param [pci] the remote-buddy; it stays where it is till Route_Remove
+ */
+void Route_Add(CONNECTION_INFO_PTR pci)
+{
+    struct in_addr addr;
+    if (inet_pton(AF_INET, pci->ip.c_str(), &addr) != 1 || addr.s_addr == INADDR_ANY)
+    {
+        pci->addr = 0;
+        pci->route_slot = (int)vunbound.size();
+        vunbound.push_back(pci);
+        return;
+    } // end if unbound
+
+    pci->addr = addr.s_addr;
+    pci->route_slot = -1;
+    mbound[addr.s_addr].push_back(pci);
+} // end Route_Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a remote-buddy out of the index; one going away
+ *
+ * @param [pci] the remote-buddy
+ */
+void Route_Remove(CONNECTION_INFO_PTR pci)
+{
+    if (pci->route_slot >= 0)
+    {
+        // the last one takes its place
+        CONNECTION_INFO_PTR plast = vunbound.back();
+        vunbound[pci->route_slot] = plast;
+        plast->route_slot = pci->route_slot;
+        vunbound.pop_back();
+        pci->route_slot = -1;
+        return;
+    } // end if unbound
+
+    auto it = mbound.find(pci->addr);
+    if (it == mbound.end())
+        return;
+
+    auto &v = it->second;
+    v.erase(std::remove(v.begin(), v.end(), pci), v.end());
+    if (v.empty())
+        mbound.erase(it);
+} // end Route_Remove
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The remote-buddy a new database connection goes over; the one its address is bound to or else one yet to
+ *  be bound, which is bound to it from now on
+ *
+ * @param [addr] where the connection came from (network order)
+ *
+ * @return CONNECTION_INFO_PTR
+ *  the remote-buddy or nullptr if there's none to be had
+ */
+CONNECTION_INFO_PTR Route_Find(const u32 addr)
+{
+    auto it = mbound.find(addr);
+    if (it != mbound.end())
+        return it->second.front();
+
+    if (vunbound.empty() || addr == INADDR_ANY)
+        return nullptr;
+
+    CONNECTION_INFO_PTR pci = vunbound.back();
+    vunbound.pop_back();
+    pci->route_slot = -1;
+    pci->addr = addr;
+
+    char str[INET_ADDRSTRLEN];
+    if (inet_ntop(AF_INET, &addr, str, sizeof(str)))
+        pci->ip = str;
+
+    mbound[addr].push_back(pci);
+    return pci;
+} // end Route_Find
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
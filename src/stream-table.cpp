@@ -0,0 +1,254 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  The flat stream table shared by both buddies; see stream-table.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "stream-table.h"
+#include "utils.h"
+#include "metrics.h"
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+STREAM stream_table[STREAM_MAX_FDS];        // zeroed; every entry starts out STREAM_FREE
+std::atomic<int> stream_top{0};
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The read size every stream starts out with and never goes under; -bs rounded up to a power of two
+ */
+static u8 Read_Shift()
+{
+    u8 shift{9};
+    while (((size_t)1 << shift) < (size_t)buffer_size && shift < 31)
+        shift++;
+
+    return shift;
+} // end Read_Shift
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens a stream on the descriptor; whatever the entry held before is forgotten
+ *
+ * @param [fd] our end of it
+ * @param [ppeer] the tunnel peer it goes over
+ * @param [rfd] the other end; -1 if not known yet
+ * @param [state] STREAM_CONNECTING or STREAM_OPEN
+ * @param [flags] SF_xxx to start out with
+ *
+ * @return STREAM_PTR
+ *  the stream or nullptr if the descriptor is past what INTAP can carry
+ */
+STREAM_PTR Stream_Open(const int fd, void *ppeer, const int rfd, const u8 state, const u16 flags)
+{
+    if ((u32)fd >= STREAM_MAX_FDS)
+    {
+        fprintf(stderr, "descriptor %d is past what the tunnel can carry\n", fd);
+        return nullptr;
+    } // end if too big
+
+    STREAM_PTR ps = &stream_table[fd];
+    if (ps->state != STREAM_FREE)
+        Metrics_Add(pmetrics->streams_closed, 1);
+    Metrics_Add(pmetrics->streams_opened, 1);
+
+    ps->ppeer = ppeer;
+    ps->rfd = rfd;
+    ps->state = state;
+    ps->rshift = Read_Shift();
+    ps->flags = flags;
+    ps->credit = INTAP_WINDOW;
+    ps->unacked = 0;
+
+    int top = stream_top.load(std::memory_order_relaxed);
+    while (fd >= top && !stream_top.compare_exchange_weak(top, fd + 1, std::memory_order_relaxed))
+        ;
+
+    return ps;
+} // end Stream_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sizes the next read off a stream by how the last one went; one that took all it was given doubles it (bulk
+ *  such as a result set or an upload goes in fewer, bigger frames) and one that came in at an eighth of it or
+ *  less halves it (a chatty stream's frames stay small)
+ *
+ * @param [ps] the stream
+ * @param [bytes] what the last read got
+ * @param [max] the longest payload a frame over its tunnel may carry
+ */
+void Stream_Adapt(STREAM_PTR ps, const size_t bytes, const size_t max)
+{
+    size_t size = Stream_Read_Size(ps, max);
+    if (bytes >= size && size < max)
+        ps->rshift++;
+    else if (bytes <= (size >> 3) && ps->rshift > Read_Shift())
+        ps->rshift--;
+} // end Stream_Adapt
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Counts what was just taken off the tunnel for a stream and passed on to its descriptor; once enough of it
+ *  has been and the descriptor isn't backed up, it's time to grant it all back to the sender. Credit only
+ *  comes back as the descriptor drains, so a stream whose consumer is slow stops its sender on the other side
+ *  rather than filling the tunnel.
+ *
+ * @param [ps] the stream
+ * @param [bytes] how many more were passed on (0 to just look again)
+ * @param [bdrained] is the descriptor keeping up; i.e. up and not over the high-water mark?
+ *
+ * @return u32
+ *  the credit to send back in a CMD_WINDOW; 0 for none yet
+ */
+u32 Stream_Grant(STREAM_PTR ps, const size_t bytes, const bool bdrained)
+{
+    ps->unacked += bytes;
+    if (!bdrained || ps->unacked < STREAM_GRANT_MIN)
+        return 0;
+
+    u32 grant = ps->unacked;
+    ps->unacked = 0;
+    return grant;
+} // end Stream_Grant
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The other side granted a stream more credit (CMD_WINDOW). It can only ever give back what was sent, so the 
+ *  credit never goes above INTAP_WINDOW; a grant that would take it there (a broken or hostile peer) is cut 
+ *  short rather than let the credit wrap around to negative and stall the stream for good.
+ *
+ * @param [ps] the stream
+ * @param [grant] how much more
+ *
+ * @return bool
+ *  true if it was stalled for want of credit and may now go back to reading
+ */
+bool Stream_Credit(STREAM_PTR ps, const u32 grant)
+{
+    ps->credit = (s32)std::min((s64)ps->credit + grant, (s64)INTAP_WINDOW);
+    if (!(ps->flags & SF_STALLED) || ps->credit <= 0)
+        return false;
+
+    ps->flags &= ~SF_STALLED;
+    return true;
+} // end Stream_Credit
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The tunnel link a stream's frames go down over a remote-buddy (local-buddy's side); always the same one for 
+ *  a descriptor, so that its frames (and a later stream reusing the descriptor) keep their order.
+ *
+ * @param [pci] the remote-buddy
+ * @param [fd] the stream's descriptor
+ *
+ * @return int
+ *  the link
+ */
+int Stream_Link(CONNECTION_INFO_PTR pci, const int fd)
+{
+    return pci->vlinks[(u32)fd % pci->vlinks.size()];
+} // end Stream_Link
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The header of the frame taking what was just read off a stream down the tunnel (CMD_ECHO). v2 leaves our 
+ *  descriptor out once the other side knows it; from this frame on it does.
+ *
+ * @param [intap] the header
+ * @param [ps] the stream
+ * @param [fd] its descriptor
+ * @param [bytes] length of the payload
+ * @param [version] the INTAP version settled on with the other side
+ */
+void Stream_Echo(INTAP_FMT &intap, STREAM_PTR ps, const int fd, const int bytes, const int version)
+{
+    intap.id = HTONS(CMD_ECHO);
+    intap.src_fd = HTONS(fd);
+    intap.dest_fd = HTONS(ps->rfd);
+    intap.buf_len = HTONL(bytes);
+    if (version >= INTAP_V2 && ps->rfd > 0 && !(ps->flags & SF_UNNAMED))
+        intap.src_fd = HTONS(-1);
+
+    ps->flags &= ~SF_UNNAMED;
+} // end Stream_Echo
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The next stream over a tunnel peer; the table is swept from a descriptor on, e.g. for everything to go 
+ *  along with a remote-buddy that's gone. Closing the one returned before looking for the next is fine.
+ *
+ * @param [ppeer] the peer
+ * @param [from] the descriptor to start at
+ *
+ * @return int
+ *  its descriptor; -1 if there's none left
+ */
+int Stream_Next(const void *ppeer, const int from)
+{
+    for (int fd = std::max(from, 0), top = stream_top.load(std::memory_order_relaxed); fd < top; fd++)
+    {
+        if (stream_table[fd].state != STREAM_FREE && stream_table[fd].ppeer == ppeer)
+            return fd;
+    } // end for
+
+    return -1;
+} // end Stream_Next
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The stream on the descriptor is no more
+ */
+void Stream_Close(const int fd)
+{
+    if ((u32)fd >= STREAM_MAX_FDS || stream_table[fd].state == STREAM_FREE)
+        return;
+
+    stream_table[fd] = STREAM{nullptr, -1, STREAM_FREE, 0, 0, 0, 0};
+    Metrics_Add(pmetrics->streams_closed, 1);
+} // end Stream_Close
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,260 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  kTLS on the tunnel links; see tunnel-tls.h
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "tunnel-tls.h"
+#include <signal.h>             /* SIGPIPE */
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+
+
+//==============================================================================================================|
+// DEFINES
+//==============================================================================================================|
+// TLS 1.2 with AES-GCM; what OpenSSL hands the kernel both ways (1.3 it only does for sending) and with nothing
+//  coming along after the handshake (1.3 session tickets) that a kTLS receive wouldn't take
+#define TLS_CIPHERS     "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:" \
+                        "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384"
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static SSL_CTX *pctx{nullptr};      // set up once (see Tls_Init); nullptr has the tunnel go in the clear
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets the tunnel up for TLS; each side shows its certificate and takes the other's only if it's signed by
+ *  the CA given. It's a CA for the tunnel alone, so that's all there's to check (no host names).
+ *
+ * @param [bserver] local-buddy's side (it accepts the links) or remote-buddy's
+ * @param [cert] our certificate (PEM); the chain if there's one
+ * @param [key] its private key (PEM)
+ * @param [ca] the CA the other side's must be signed by (PEM)
+ *
+ * @return bool
+ *  false if any of it isn't right; it's all on stderr
+ */
+bool Tls_Init(const bool bserver, const std::string &cert, const std::string &key, const std::string &ca)
+{
+    SSL_CTX *p = SSL_CTX_new(bserver ? TLS_server_method() : TLS_client_method());
+    if (!p || !SSL_CTX_set_min_proto_version(p, TLS1_2_VERSION) || !SSL_CTX_set_max_proto_version(p, TLS1_2_VERSION)
+        || !SSL_CTX_set_cipher_list(p, TLS_CIPHERS)
+        || SSL_CTX_use_certificate_chain_file(p, cert.c_str()) != 1
+        || SSL_CTX_use_PrivateKey_file(p, key.c_str(), SSL_FILETYPE_PEM) != 1
+        || SSL_CTX_check_private_key(p) != 1
+        || SSL_CTX_load_verify_locations(p, ca.c_str(), nullptr) != 1)
+    {
+        ERR_print_errors_fp(stderr);
+        fprintf(stderr, "tunnel TLS: can't set up with certificate %s, key %s and CA %s\n", cert.c_str(),
+            key.c_str(), ca.c_str());
+        SSL_CTX_free(p);
+        return false;
+    } // end if not right
+
+    SSL_CTX_set_options(p, SSL_OP_ENABLE_KTLS | SSL_OP_NO_RENEGOTIATION | SSL_OP_NO_COMPRESSION);
+    SSL_CTX_set_verify(p, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+    SSL_CTX_set_session_cache_mode(p, SSL_SESS_CACHE_OFF);
+
+    // OpenSSL writes the handshake with plain write(); a peer gone half way through mustn't take us down with it
+    signal(SIGPIPE, SIG_IGN);
+    pctx = p;
+    return true;
+} // end Tls_Init
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the tunnel to go over TLS?
+ */
+bool Tls_Active()
+{
+    return pctx != nullptr;
+} // end Tls_Active
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The end of a handshake either way; once it's through the kernel takes the keys both ways and OpenSSL is
+ *  done with. Nothing but the handshake has been read off the link, what follows is for the kernel to decrypt.
+ *
+ * @param [ssl] the handshake; it's let go of
+ * @param [fd] the link
+ * @param [bok] did it go through?
+ *
+ * @return bool
+ *  true if the link is encrypted in the kernel from now on; false and it's to be dropped
+ */
+static bool Handshake_Done(SSL *ssl, const int fd, bool bok)
+{
+    if (!bok)
+    {
+        ERR_print_errors_fp(stderr);
+        fprintf(stderr, "tunnel TLS: handshake on socket %d failed\n", fd);
+    } // end if no handshake
+    else if (!BIO_get_ktls_send(SSL_get_wbio(ssl)) || !BIO_get_ktls_recv(SSL_get_rbio(ssl)))
+    {
+        fprintf(stderr, "tunnel TLS: the kernel won't take the keys for socket %d (is the tls module loaded?); "
+            "it won't go in the clear\n", fd);
+        bok = false;
+    } // end else if no kTLS
+
+    SSL_free(ssl);          // the socket's left open; it's the kernel's to encrypt from here on
+    ERR_clear_error();
+    return bok;
+} // end Handshake_Done
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The handshake on a link, blocking (see Handshake_Done)
+ *
+ * @param [fd] the link; blocking
+ * @param [bserver] which side we're on
+ *
+ * @return bool
+ *  true if the link is encrypted in the kernel from now on; false and it's to be dropped
+ */
+static bool Handshake(const int fd, const bool bserver)
+{
+    SSL *ssl = SSL_new(pctx);
+    Set_RecvTimeout(fd, TLS_HANDSHAKE_SECS);
+    bool bok = ssl && SSL_set_fd(ssl, fd) == 1 && (bserver ? SSL_accept(ssl) : SSL_connect(ssl)) == 1;
+    Set_RecvTimeout(fd, 0);
+    return Handshake_Done(ssl, fd, bok);
+} // end Handshake
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  remote-buddy's side of the handshake; right after the link connects
+ *
+ * @param [fd] the link
+ *
+ * @return bool
+ *  false if it's to be dropped
+ */
+bool Tls_Connect(const int fd)
+{
+    return Handshake(fd, false);
+} // end Tls_Connect
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The handshake on a link without blocking; called first to start it, then every time the link turns ready 
+ *  for what the call before asked for. How long it may take is the caller's to keep track of (Tls_Abort).
+ *
+ * @param [fd] the link; blocking, it's back that way once the handshake's over
+ * @param [pssl] the handshake so far; nullptr to start one, it's back to nullptr once it's over either way
+ * @param [events] what to wait for before the next call (EV_READ or EV_WRITE) while it's still on
+ * @param [bserver] which side we're on
+ *
+ * @return int
+ *  1 if the link is encrypted in the kernel from now on, 0 while it's still on and -1 if it's to be dropped
+ */
+static int Handshake_Step(const int fd, void *&pssl, u32 &events, const bool bserver)
+{
+    SSL *ssl = (SSL *)pssl;
+    if (!ssl)
+    {
+        if (!(ssl = SSL_new(pctx)) || SSL_set_fd(ssl, fd) != 1)
+        {
+            Handshake_Done(ssl, fd, false);
+            return -1;
+        } // end if no handshake
+
+        Set_Non_Blocking(fd);
+        pssl = ssl;
+    } // end if starting
+
+    int status = bserver ? SSL_accept(ssl) : SSL_connect(ssl);
+    if (status != 1)
+    {
+        int err = SSL_get_error(ssl, status);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+        {
+            events = err == SSL_ERROR_WANT_READ ? EV_READ : EV_WRITE;
+            return 0;
+        } // end if more to come
+    } // end if not through
+
+    pssl = nullptr;
+    Set_Non_Blocking(fd, false);
+    return Handshake_Done(ssl, fd, status == 1) ? 1 : -1;
+} // end Handshake_Step
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  local-buddy's side of the handshake without blocking (see Handshake_Step); on a link that has started one
+ *  (TLS_RECORD_HANDSHAKE), while the reactor goes on with everything else
+ */
+int Tls_Accept_Step(const int fd, void *&pssl, u32 &events)
+{
+    return Handshake_Step(fd, pssl, events, true);
+} // end Tls_Accept_Step
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  remote-buddy's side of the handshake without blocking (see Handshake_Step); for a link reconnected while 
+ *  the reactor goes on with everything else, called first right after it connects
+ */
+int Tls_Connect_Step(const int fd, void *&pssl, u32 &events)
+{
+    return Handshake_Step(fd, pssl, events, false);
+} // end Tls_Connect_Step
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gives up on a handshake Tls_Accept_Step() or Tls_Connect_Step() has on; the link itself is the caller's to close
+ *
+ * @param [pssl] the handshake; back to nullptr
+ */
+void Tls_Abort(void *&pssl)
+{
+    SSL_free((SSL *)pssl);
+    ERR_clear_error();
+    pssl = nullptr;
+} // end Tls_Abort
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
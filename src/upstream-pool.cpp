@@ -0,0 +1,399 @@
+//==============================================================================================================|
+// Project Name:
+//  Jacob's Well
+//
+// File Desc:
+//  Warm pools of already connected sockets to the upstreams. Each reactor thread has its own pools; the sockets
+//  in them are connected with Connect_Async and sit registered in the thread's reactor till claimed, so that one
+//  the upstream closes on (or resets) is noticed and replaced right away. A claim takes the oldest one, having
+//  peeked at it first, and sets a replacement on its way. A stream that's done with but still good for another
+//  go (an HTTP connection with nothing in flight) may be handed back and is claimed like any other.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  17th of October 2026, Saturday
+//
+// Last Updated:
+//  17th of October 2026, Saturday
+//==============================================================================================================|
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "upstream-pool.h"
+
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static thread_local std::vector<UPSTREAM_POOL_PTR> vpools;                  // the calling thread's pools
+static thread_local std::unordered_map<int, UPSTREAM_POOL_PTR> mpooled;     // every descriptor they hold
+
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Is the connection still there? A peek that finds nothing to read is as good as it gets; anything read is the
+ *  upstream's to say and is left for whoever claims it, unless it's to be quiet (one that came back from a 
+ *  stream has said all it had to).
+ */
+static bool Alive(const int fd, const bool bquiet)
+{
+    char c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return (n > 0 && !bquiet) || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+} // end Alive
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Lets go of one of the pool's descriptors for good
+ */
+static void Drop(const int fd)
+{
+    mpooled.erase(fd);
+    Erase_Sock(fd);
+    CLOSE(fd);
+} // end Drop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A connect failed; the pool holds off refilling, a little longer every time it happens in a row, so that an
+ *  upstream that's down isn't hammered on. The connects failing while it's holding off count as one.
+ */
+static void Back_Off(UPSTREAM_POOL_PTR pool)
+{
+    u64 now = Now_Ms();
+    if (now < pool->retry_at)
+        return;         // the rest of those that were on their way along with it
+
+    pool->backoff = pool->backoff ? std::min<u64>(pool->backoff * 2, POOL_RETRY_MAX_MS) : POOL_RETRY_MS;
+    pool->retry_at = now + pool->backoff;
+    fprintf(stderr, "upstream pool: can't connect to %s:%d, trying again in %llu ms\n", pool->ip.c_str(),
+        pool->port, (unsigned long long)pool->backoff);
+} // end Back_Off
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts as many connects as it takes to bring the pool back up to size, unless it's holding off
+ */
+static void Fill(UPSTREAM_POOL_PTR pool)
+{
+    u64 now = Now_Ms();
+    if (now < pool->retry_at)
+        return;
+
+    while (pool->qready.size() + pool->mconnecting.size() < pool->size)
+    {
+        int fd = Socket();
+        int status = Connect_Async(fd, pool->ip.c_str(), pool->port);
+        if (status < 0)
+        {
+            CLOSE(fd);
+            Back_Off(pool);
+            return;
+        } // end if failed
+
+        mpooled[fd] = pool;
+        if (status == 0)
+        {
+            pool->qready.push_back({fd, now, false});
+            Reactor_Add(fd, EV_READ);
+        } // end if connected
+        else
+        {
+            pool->mconnecting[fd] = now + pool->connect_ms;
+            Reactor_Add(fd, EV_WRITE);
+        } // end else in progress
+    } // end while
+} // end Fill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The pool of an upstream for the calling thread; it's made (and starts filling) the first time it's asked for
+ *
+ * @param [ip] the upstream's address
+ * @param [port] and its port
+ * @param [size] how many warm sockets to keep
+ * @param [keep] how many more streams may come back (see Pool_Return); 0 along with size pools nothing
+ * @param [idle_ms] how long one may sit unused before it's replaced; 0 for ever
+ * @param [connect_ms] how long a connect may take
+ *
+ * @return UPSTREAM_POOL_PTR
+ *  the pool or nullptr if there's to be none
+ */
+UPSTREAM_POOL_PTR Pool_Open(const char *ip, const u16 port, const size_t size, const size_t keep,
+    const int idle_ms, const int connect_ms)
+{
+    if (size == 0 && keep == 0)
+        return nullptr;
+
+    for (auto pool : vpools)
+    {
+        if (pool->port == port && pool->ip == ip)
+            return pool;
+    } // end for
+
+    if (vpools.size() >= POOL_MAX_UPSTREAMS)
+        return nullptr;
+
+    UPSTREAM_POOL_PTR pool = new UPSTREAM_POOL;
+    pool->ip = ip;
+    pool->port = port;
+    pool->size = size;
+    pool->keep = keep;
+    pool->idle_ms = idle_ms > 0 ? idle_ms : 0;
+    pool->connect_ms = connect_ms > 0 ? connect_ms : 0;
+    vpools.push_back(pool);
+
+    Fill(pool);
+    return pool;
+} // end Pool_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a warm socket out of the pool; it's connected, in blocking mode and out of the reactor, just as if
+ *  Connect_Async had connected it right away. A replacement is set on its way.
+ *
+ * @param [pool] the pool; nullptr is fine
+ *
+ * @return int
+ *  the descriptor or -1 if there's none warm; connect the usual way
+ */
+int Pool_Claim(UPSTREAM_POOL_PTR pool)
+{
+    if (!pool)
+        return -1;
+
+    int fd{-1};
+    while (!pool->qready.empty() && fd < 0)
+    {
+        fd = pool->qready.front().fd;
+        bool bquiet = pool->qready.front().breused;
+        pool->qready.pop_front();
+        if (!Alive(fd, bquiet))
+        {
+            Drop(fd);
+            fd = -1;
+        } // end if gone
+    } // end while
+
+    if (fd >= 0)
+    {
+        // whatever events of ours are still in the batch go stale; the claimer registers it afresh
+        mpooled.erase(fd);
+        Reactor_Del(fd);
+    } // end if got one
+
+    Fill(pool);
+    return fd;
+} // end Pool_Claim
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands a stream back for someone else to claim; the caller must be done with it (nothing in flight either 
+ *  way) and have let go of it. It's taken if there's room and it's still good, it's the caller's to close 
+ *  otherwise.
+ *
+ * @param [pool] the pool the stream's upstream has; nullptr is fine
+ * @param [fd] the stream
+ *
+ * @return bool
+ *  true if taken
+ */
+bool Pool_Return(UPSTREAM_POOL_PTR pool, const int fd)
+{
+    if (!pool || pool->qready.size() >= pool->size + pool->keep || Send_Pending(fd) || !Alive(fd, true))
+        return false;
+
+    // registered afresh; whatever events the stream still has in the batch go stale
+    Reactor_Del(fd);
+    Reactor_Add(fd, EV_READ);
+    mpooled[fd] = pool;
+    pool->qready.push_back({fd, Now_Ms(), true});
+    return true;
+} // end Pool_Return
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Deals with the event if it's on one of the pool's descriptors; a connect going through (or not) or a warm
+ *  one turning readable. The latter is either gone or the upstream's said something of its own accord (say a
+ *  server greeting); that's left in the socket for whoever claims it and we stop listening for it. One that 
+ *  came back from a stream has no business saying anything and is let go (an HTTP server timing it out).
+ *
+ * @param [ev] the event
+ *
+ * @return bool
+ *  true if it was ours
+ */
+bool Pool_Event(const REACTOR_EVENT &ev)
+{
+    if (mpooled.empty())
+        return false;
+
+    auto it = mpooled.find(ev.fd);
+    if (it == mpooled.end())
+        return false;
+
+    UPSTREAM_POOL_PTR pool = it->second;
+    if (pool->mconnecting.erase(ev.fd))
+    {
+        if (Connect_Finish(ev.fd) < 0)
+        {
+            Drop(ev.fd);
+            Back_Off(pool);
+            return true;
+        } // end if failed
+
+        pool->backoff = 0;
+        pool->qready.push_back({ev.fd, Now_Ms(), false});
+        Reactor_Mod(ev.fd, EV_READ);
+        return true;
+    } // end if connect done
+
+    auto iq = std::find_if(pool->qready.begin(), pool->qready.end(), 
+        [&ev](const POOL_SOCK &x) { return x.fd == ev.fd; });
+    if (iq != pool->qready.end() && Alive(ev.fd, iq->breused))
+    {
+        Reactor_Mod(ev.fd, 0);
+        return true;
+    } // end if said something
+
+    if (iq != pool->qready.end())
+        pool->qready.erase(iq);
+
+    Drop(ev.fd);
+    Fill(pool);
+    return true;
+} // end Pool_Event
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  How long the reactor may wait before one of the pools has something to do; a connect running out of time, a
+ *  warm one going stale or a refill that's been held off
+ *
+ * @param [timeout] how long the caller would wait otherwise; -1 for ever
+ *
+ * @return int
+ *  the lesser of the two in milli-seconds
+ */
+int Pool_Wait_Ms(const int timeout)
+{
+    if (vpools.empty())
+        return timeout;
+
+    u64 earliest{UINT64_MAX};
+    for (auto pool : vpools)
+    {
+        if (pool->qready.size() + pool->mconnecting.size() < pool->size)
+            earliest = std::min(earliest, pool->retry_at);
+
+        if (pool->idle_ms && !pool->qready.empty())
+            earliest = std::min(earliest, pool->qready.front().since + pool->idle_ms);
+
+        for (auto &x : pool->mconnecting)
+            earliest = std::min(earliest, x.second);
+    } // end for
+
+    if (earliest == UINT64_MAX)
+        return timeout;
+
+    u64 now = Now_Ms();
+    int wait = earliest <= now ? 0 : (int)std::min<u64>(earliest - now, INT32_MAX);
+    return timeout < 0 ? wait : std::min(wait, timeout);
+} // end Pool_Wait_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gives up on the pool connects that took too long, swaps the warm ones that sat unused for too long for
+ *  fresh ones (the upstream may well be about to drop them) and refills; once every reactor wakeup.
+ */
+void Pool_Tick()
+{
+    if (vpools.empty())
+        return;
+
+    u64 now = Now_Ms();
+    for (auto pool : vpools)
+    {
+        if (!pool->mconnecting.empty())
+        {
+            std::vector<int> vexpired;
+            for (auto &x : pool->mconnecting)
+            {
+                if (x.second <= now)
+                    vexpired.push_back(x.first);
+            } // end for
+
+            for (int fd : vexpired)
+            {
+                pool->mconnecting.erase(fd);
+                Drop(fd);
+            } // end for
+
+            if (!vexpired.empty())
+                Back_Off(pool);
+        } // end if connecting
+
+        while (pool->idle_ms && !pool->qready.empty() && pool->qready.front().since + pool->idle_ms <= now)
+        {
+            Drop(pool->qready.front().fd);
+            pool->qready.pop_front();
+        } // end while
+
+        Fill(pool);
+    } // end for
+} // end Pool_Tick
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Closes every socket the calling thread's pools hold and lets go of the pools
+ */
+void Pool_Close()
+{
+    for (auto pool : vpools)
+    {
+        for (auto &x : pool->qready)
+            Drop(x.fd);
+
+        for (auto &x : pool->mconnecting)
+            Drop(x.first);
+
+        delete pool;
+    } // end for
+
+    vpools.clear();
+} // end Pool_Close
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -12,7 +12,7 @@
 //  23rd of March 2023, Thursday
 //
 // Last Updated:
-//  23rd of March 2023, Thursday
+//  17th of October 2026, Saturday
 //==============================================================================================================|
 
 
@@ -40,14 +40,31 @@
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
-char *buffer;               // a generalized storage buffer for receiveing 
-char *snd_buffer;
+thread_local char *buffer;          // a generalized storage buffer for receiveing (one per reactor thread)
+thread_local char *snd_buffer;
 
 
 // command line overrides
 int debug_mode;                  // enables debugging mode; default no display simply run mode
 int backlog{5};                  // number of buffered conns (or so we're told, that's a suspicious fella!!!)
 int buffer_size{BUF_SIZE};       // size of storage for buffer above
+int frame_max{INTAP_FRAME_DEF};  // the longest a stream is read for at once
+int io_backend{IO_EPOLL};        // the reactor's I/O backend
+int connect_timeout{5000};       // how long an upstream connect may take (milli-seconds)
+int lz_min{INTAP_LZ_MIN};        // tunnel payloads this long or longer get compressed; 0 never
+int lz_threads{2};               // the compression pool; 0 compresses right on the reactor threads
+int pool_size{POOL_SIZE};        // warm upstream sockets (see Pool_Open); 0 none
+int pool_keep{POOL_KEEP};        // streams kept alive (see Pool_Return); 0 none
+int pool_idle_ms{POOL_IDLE_MS};  // and how long they're kept unused (milli-seconds); 0 for ever
+int weight_db{EGRESS_WEIGHT_DB};         // shares of a backed up tunnel link (see Intap_Schedule)
+int weight_rest{EGRESS_WEIGHT_REST};
+int metrics_port{0};             // the metrics endpoint (see Metrics_Listen); 0 off
+std::string log_file;           // where the log goes (see Log_Init); stdout if empty
+std::string tls_cert;           // the tunnel goes over TLS given these (see Tls_Init); in the clear if empty
+std::string tls_key;
+std::string tls_ca;
+int resume_secs{INTAP_RESUME_SECS};  // how long a lost tunnel link may take to be resumed; 0 never resumes one
+int replay_max{INTAP_REPLAY_MAX};   // MiB a link may have unacknowledged and still be resumed
 
 
 
@@ -59,55 +76,39 @@ int buffer_size{BUF_SIZE};       // size of storage for buffer above
 //==============================================================================================================|
 /**
  * @brief 
- *  Prints the contents of buffer in hex notation along side it's ASCII form much like hex viewer's do it.
+ *  Dumps the message to console (stdout) if we are allowed to do so; i.e. degbug_mode is set to DEBUG_L1 or 
+ *  above. It's only logged here (see Log_Print); the formatting and the writing happen off the event loop, so
+ *  msg must be a literal. Both buddies (and micro-bench) log through this one.
  * 
- * @param ps_buffer 
- *  the information to dump as hex and char arrary treated as a char array.
- * @param len 
- *  the length of the buffer above
+ * @param [msg] the message to dump 
  */
-void Dump_Hex(const char *p_buf, const size_t len)
+void Dump(const char *msg, ...)
 {
-    size_t i, j;                    // loop var
-    const size_t skip = 8;          // loop skiping value
-    size_t remaining = skip;        // remaining rows
+    va_list arg_list;
 
-    if (len > 65536)
+    if (!(debug_mode & DEBUG_L1))
         return;
-    
-    // print header
-    printf("\n      ");
-    for (i = 0; i < 8; i++)
-        printf("\033[36m%02X ", (uint16_t)i);
-    printf("\033[37m\n");
-
-    if (len < skip)
-        remaining = len;
-    
-    for (i = 0; i < len; i+=skip)
-    {   
-        printf("\033[36m%04X:\033[37m ", (uint16_t)i);
-        for (j = 0; j < remaining; j++)
-            printf("%02X ", (uint8_t)p_buf[i+j]);
-
-        if (remaining < skip) {
-            // fill blanks
-            for (j = 0; j < skip - remaining; j++)
-                printf("   ");
-        } // end if
 
-        printf("\t");
+    va_start(arg_list, msg);
+    Log_Print(msg, arg_list);
+    va_end(arg_list);
+} // end Dump
 
-        for (j = 0; j < remaining; j++)
-            printf("%c. ", p_buf[i+j]);
 
-        printf("\n");
-
-        if (len - (i + j) < skip)
-            remaining = len - (i + j);
-    } // end for
-
-    printf("\n");
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Prints the contents of buffer in hex notation along side it's ASCII form much like hex viewer's do it; by way
+ *  of the log (see Log_Hex), the formatting happens off the calling thread.
+ * 
+ * @param ps_buffer 
+ *  the information to dump as hex and char arrary treated as a char array.
+ * @param len 
+ *  the length of the buffer above
+ */
+void Dump_Hex(const char *p_buf, const size_t len)
+{
+    Log_Hex(p_buf, len);
 } // end Dump_Hex
 
 
@@ -206,26 +207,136 @@ void Process_Command_Line(char **argv, const int argc, std::string &filename)
             buffer_size = atoi(argv[++i]);
         } // end if buffer size
 
+        if (!strncmp("-fm", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            frame_max = atoi(argv[++i]);
+        } // end if frame size
+
         if (!strncmp("-bl", argv[i], strlen(argv[i])))
         {
             backlog = atoi(argv[++i]);
         } // end if backlog
+
+        if (!strncmp("-io", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            // epoll, poll or uring; io_uring falls back to epoll if the kernel can't
+            std::string io{argv[++i]};
+            if (io == "uring")
+                io_backend = IO_URING;
+            else if (io == "poll")
+                io_backend = IO_POLL;
+            else
+                io_backend = IO_EPOLL;
+        } // end if I/O backend
+
+        if (!strncmp("-ct", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            connect_timeout = atoi(argv[++i]);
+        } // end if connect timeout
+
+        if (!strncmp("-lz", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            lz_min = atoi(argv[++i]);
+        } // end if compression threshold
+
+        if (!strncmp("-lzt", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            lz_threads = atoi(argv[++i]);
+        } // end if compression threads
+
+        if (!strncmp("-pool", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            pool_size = atoi(argv[++i]);
+        } // end if upstream pool
+
+        if (!strncmp("-keep", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            pool_keep = atoi(argv[++i]);
+        } // end if keep-alive
+
+        if (!strncmp("-pidle", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            pool_idle_ms = atoi(argv[++i]);
+        } // end if upstream pool idle time
+
+        if (!strncmp("-huge", argv[i], strlen(argv[i])))
+        {
+            buf_huge = true;
+        } // end if huge pages
+
+        if (!strncmp("-wdb", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            weight_db = atoi(argv[++i]);
+        } // end if database weight
+
+        if (!strncmp("-wrest", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            weight_rest = atoi(argv[++i]);
+        } // end if RESTServer weight
+
+        if (!strncmp("-mp", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            metrics_port = atoi(argv[++i]);
+        } // end if metrics port
+
+        if (!strncmp("-log", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            log_file = argv[++i];
+        } // end if log file
+
+        if (!strncmp("-tlsc", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            tls_cert = argv[++i];
+        } // end if TLS certificate
+
+        if (!strncmp("-tlsk", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            tls_key = argv[++i];
+        } // end if its key
+
+        if (!strncmp("-tlsca", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            tls_ca = argv[++i];
+        } // end if TLS CA
+
+        if (!strncmp("-resume", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            resume_secs = atoi(argv[++i]);
+        } // end if resume window
+
+        if (!strncmp("-replay", argv[i], strlen(argv[i])) && i + 1 < argc)
+        {
+            replay_max = atoi(argv[++i]);
+        } // end if replay buffer
     } // end for
 
 
     // while at it allocate memory for buffers
-    if ( !(buffer = (char*)malloc(buffer_size)) )
+    Alloc_Buffers();
+} // end Process_Command_Line
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Allocates the receiving and sending buffers for the calling thread; every reactor thread calls this once
+ *  before it starts routing. A stream may be read for as much as -fm (or -bs if that's more) at once, with 
+ *  room for a terminating null.
+ */
+void Alloc_Buffers()
+{
+    if ( !(buffer = (char*)malloc(std::max(buffer_size, frame_max) + 1)) )
     {
         perror("malloc fail");
         exit(EXIT_FAILURE);
     } // end if
 
-    if ( !(snd_buffer = (char*)malloc(buffer_size + sizeof(INTAP_FMT))))
+    if ( !(snd_buffer = (char*)malloc(std::max(buffer_size, frame_max) + sizeof(INTAP_FMT))))
     {
         perror("malloc fail");
         exit(EXIT_FAILURE);
     } // end if
-} // end Process_Command_Line
+} // end Alloc_Buffers
 
 
 //==============================================================================================================|